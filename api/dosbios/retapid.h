@@ -7,6 +7,8 @@
 /* TODO: This may need to be disabled with EGA scrolling implemented. */
 #define RETROFLAT_SOFT_VIEWPORT
 
+#define RETROFLAT_PX_ROW
+
 #  ifdef RETROFLAT_OPENGL
 #     error "opengl support not implemented for PC BIOS"
 #  endif /* RETROFLAT_OPENGL */
@@ -91,13 +93,19 @@ typedef int16_t RETROFLAT_IN_KEY;
 
 typedef uint8_t RETROFLAT_COLOR_DEF;
 
+#  ifdef RETROFLT_C
+#     define RETROBLT_C
+#  endif /* RETROFLT_C */
+#  include <retroblt.h>
+
 struct RETROFLAT_BITMAP {
    size_t sz;
    uint8_t flags;
    int16_t w;
    int16_t h;
    uint8_t SEG_FAR* px;
-   uint8_t SEG_FAR* mask;
+   /*! \brief Opaque runs for transparent blits in VGA mode. */
+   struct RETROBLT_RUNS runs;
 };
 
 #  define retroflat_screen_buffer() (&(g_retroflat_state->buffer))
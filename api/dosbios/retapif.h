@@ -326,11 +326,21 @@ int retroflat_draw_lock( struct RETROFLAT_BITMAP* bmp ) {
 
 /* === */
 
-MERROR_RETVAL retroflat_draw_release( struct RETROFLAT_BITMAP* bmp ) {
+static MERROR_RETVAL retroflat_bitmap_dos_transparency(
+   struct RETROFLAT_BITMAP* bmp_out
+) {
    MERROR_RETVAL retval = MERROR_OK;
 
-   if( NULL == bmp ) {
-      retroflat_show_mouse();
+   switch( g_retroflat_state->platform.screen_mode ) {
+   case RETROFLAT_SCREEN_MODE_VGA:
+
+      debug_printf( RETROFLAT_BITMAP_TRACE_LVL,
+         "finding opaque runs for bitmap..." );
+
+      /* Build the list of runs not using the transparent palette index. */
+      retval = retroblt_runs_build( &(bmp_out->runs), bmp_out->px,
+         bmp_out->w, bmp_out->h, RETROFLAT_TXP_PAL_IDX );
+      break;
    }
 
    return retval;
@@ -338,33 +348,20 @@ MERROR_RETVAL retroflat_draw_release( struct RETROFLAT_BITMAP* bmp ) {
 
 /* === */
 
-static MERROR_RETVAL retroflat_bitmap_dos_transparency(
-   struct RETROFLAT_BITMAP* bmp_out
-) {
+MERROR_RETVAL retroflat_draw_release( struct RETROFLAT_BITMAP* bmp ) {
    MERROR_RETVAL retval = MERROR_OK;
-   size_t i = 0;
 
-   switch( g_retroflat_state->platform.screen_mode ) {
-   case RETROFLAT_SCREEN_MODE_VGA:
+   if( NULL == bmp ) {
+      retroflat_show_mouse();
 
-      debug_printf( RETROFLAT_BITMAP_TRACE_LVL,
-         "creating transparency mask for bitmap..." );
-
-      /* Create a transparency mask based on palette 0. */
-      bmp_out->mask = _fcalloc( bmp_out->w, bmp_out->h );
-      maug_cleanup_if_null_alloc( uint8_t*, bmp_out->mask );
-      /* XXX: Wrong sz field! */
-      for( i = 0 ; bmp_out->sz > i ; i++ ) {
-         if( RETROFLAT_TXP_PAL_IDX == bmp_out->px[i] ) {
-            bmp_out->mask[i] = 0xff;
-         } else {
-            bmp_out->mask[i] = 0x00;
-         }
-      }
-      break;
+   } else if(
+      &(g_retroflat_state->buffer) != bmp &&
+      RETROFLAT_FLAGS_OPAQUE != (RETROFLAT_FLAGS_OPAQUE & bmp->flags)
+   ) {
+      /* The bitmap may have been drawn on, so find its opaque runs again. */
+      retval = retroflat_bitmap_dos_transparency( bmp );
    }
 
-cleanup:
    return retval;
 }
 
@@ -487,10 +484,7 @@ void retroflat_destroy_bitmap( struct RETROFLAT_BITMAP* bmp ) {
       bmp->px = NULL;
    }
 
-   if( NULL != bmp->mask ) {
-      _ffree( bmp->mask );
-      bmp->mask = NULL;
-   }
+   retroblt_runs_free( &(bmp->runs) );
 
 }
 
@@ -501,10 +495,6 @@ MERROR_RETVAL retroflat_blit_bitmap(
    size_t s_x, size_t s_y, int16_t d_x, int16_t d_y, size_t w, size_t h,
    int16_t instance
 ) {
-   int16_t y_iter = 0,
-      x_iter = 0;
-   uint16_t target_line_offset = 0;
-   int16_t src_line_offset = 0;
    MERROR_RETVAL retval = MERROR_OK;
 
    assert( NULL != src );
@@ -513,44 +503,21 @@ MERROR_RETVAL retroflat_blit_bitmap(
       target = &(g_retroflat_state->buffer);
    }
 
-   /* DOS BIOS not setup for hardware scrolling. */
-   /* TODO: Make exception if in EGA mode! */
-   if(
-      0 > d_x || 0 > d_y ||
-      retroflat_bitmap_w( target ) + w <= d_x ||
-      retroflat_bitmap_h( target ) + h <= d_y
-   ) {
-      goto cleanup;
-   }
-
    switch( g_retroflat_state->platform.screen_mode ) {
    case RETROFLAT_SCREEN_MODE_VGA:
-      for( y_iter = 0 ; h > y_iter ; y_iter++ ) {
-         target_line_offset = ((d_y + y_iter) * (target->w)) + d_x;
-         src_line_offset = ((s_y + y_iter) * src->w) + s_x;
-         if( target->sz <= target_line_offset + w ) {
-            continue;
-         }
-         /* Blit the line. */
-         if(
-            RETROFLAT_FLAGS_OPAQUE ==
-            (RETROFLAT_FLAGS_OPAQUE & src->flags)
-         ) {
-            /* Copy line-by-line for speed. */
-            _fmemcpy(
-               &(target->px[target_line_offset]),
-               &(src->px[src_line_offset]), w );
-         } else {
-            for( x_iter = 0 ; w > x_iter ; x_iter++ ) {
-               /* AND with mask for transparency cutout. */
-               target->px[target_line_offset + x_iter] &=
-                  src->mask[src_line_offset + x_iter];
-               /* Draw into cutout with OR. */
-               target->px[target_line_offset + x_iter] |=
-                  src->px[src_line_offset + x_iter];
-            }
-         }
+      if(
+         RETROFLAT_FLAGS_OPAQUE != (RETROFLAT_FLAGS_OPAQUE & src->flags) &&
+         (MAUG_MHANDLE)NULL == src->runs.rows_h
+      ) {
+         /* Bitmap was created but never released, so find its runs now. */
+         retval = retroflat_bitmap_dos_transparency( src );
+         maug_cleanup_if_not_ok();
       }
+
+      /* Opaque bitmaps have no runs, so they are copied a row at a time. */
+      retval = retroblt_blit(
+         target->px, target->w, target->h, src->px, src->w, src->h,
+         &(src->runs), s_x, s_y, d_x, d_y, w, h );
       break;
 
    default:
@@ -646,6 +613,106 @@ void retroflat_px(
 
 /* === */
 
+void retroflat_px_row(
+   struct RETROFLAT_BITMAP* target, const RETROFLAT_COLOR color_idx,
+   size_t x, size_t y, size_t w
+) {
+   size_t i = 0,
+      offset = 0;
+
+   if( RETROFLAT_COLOR_NULL == color_idx ) {
+      return;
+   }
+
+   if( NULL == target ) {
+      target = retroflat_screen_buffer();
+   }
+
+   if(
+      RETROFLAT_FLAGS_BITMAP_RO ==
+         (RETROFLAT_FLAGS_BITMAP_RO & target->flags) ||
+      0 == w
+   ) {
+      return;
+   }
+
+   retroflat_constrain_px( x, y, target, return );
+
+   if( x + w > (size_t)target->w ) {
+      w = target->w - x;
+   }
+
+   if( RETROFLAT_SCREEN_MODE_VGA != g_retroflat_state->platform.screen_mode ) {
+      /* CGA pixels are packed and dithered, so draw them one at a time. */
+      for( i = 0 ; w > i ; i++ ) {
+         retroflat_px( target, color_idx, x + i, y, 0 );
+      }
+      return;
+   }
+
+   offset = (y * target->w) + x;
+   if( target->sz < offset + w ) {
+      return;
+   }
+   retroblt_memset( &(target->px[offset]), color_idx, w );
+}
+
+/* === */
+
+void retroflat_idx_row(
+   struct RETROFLAT_BITMAP* target, const uint8_t* idx_row,
+   size_t x, size_t y, size_t w, RETROFLAT_COLOR txp_idx
+) {
+   size_t i = 0,
+      offset = 0;
+
+   if( NULL == target ) {
+      target = retroflat_screen_buffer();
+   }
+
+   if(
+      RETROFLAT_FLAGS_BITMAP_RO ==
+         (RETROFLAT_FLAGS_BITMAP_RO & target->flags) ||
+      0 == w
+   ) {
+      return;
+   }
+
+   retroflat_constrain_px( x, y, target, return );
+
+   if( x + w > (size_t)target->w ) {
+      w = target->w - x;
+   }
+
+   if( RETROFLAT_SCREEN_MODE_VGA != g_retroflat_state->platform.screen_mode ) {
+      for( i = 0 ; w > i ; i++ ) {
+         if( txp_idx != idx_row[i] ) {
+            retroflat_px( target, idx_row[i], x + i, y, 0 );
+         }
+      }
+      return;
+   }
+
+   offset = (y * target->w) + x;
+   if( target->sz < offset + w ) {
+      return;
+   }
+
+   if( RETROFLAT_COLOR_NULL == txp_idx ) {
+      /* No transparency, so the row can be copied as-is. */
+      retroblt_memcpy( &(target->px[offset]), idx_row, w );
+      return;
+   }
+
+   for( i = 0 ; w > i ; i++ ) {
+      if( txp_idx != idx_row[i] ) {
+         target->px[offset + i] = idx_row[i];
+      }
+   }
+}
+
+/* === */
+
 void retroflat_get_palette( uint8_t idx, uint32_t* p_rgb ) {
 
    /* Set VGA mask register. */
@@ -8,6 +8,8 @@
 
 #define RETROFLAT_SOFT_VIEWPORT
 
+#define RETROFLAT_PX_ROW
+
 #  ifndef RETROFLAT_OPENGL
 #     error "RETROFLAT_API_GLUT specified without RETROFLAT_OPENGL!"
 #     define RETROFLAT_OPENGL
@@ -51,7 +53,12 @@ struct RETROFLAT_BITMAP {
 #     define RETROFLAT_SOFT_LINES
 #  endif /* !RETROFLAT_SOFT_LINES */
 
-#  define retroflat_bitmap_ok( bitmap ) (NULL != (bitmap)->b)
+/* maug_mlock() sets bytes_h to NULL while the bitmap is locked, so check
+ * bytes too.
+ */
+#  define retroflat_bitmap_ok( bitmap ) \
+      ((MAUG_MHANDLE)NULL != (bitmap)->tex.bytes_h || \
+         NULL != (bitmap)->tex.bytes)
 #  define retroflat_bitmap_locked( bmp ) \
       (RETROFLAT_FLAGS_LOCK == (RETROFLAT_FLAGS_LOCK & (bmp)->flags))
 #  define retroflat_bitmap_w( bmp ) \
@@ -305,6 +305,36 @@ void retroflat_px(
 
 /* === */
 
+void retroflat_px_row(
+   struct RETROFLAT_BITMAP* target, const RETROFLAT_COLOR color_idx,
+   size_t x, size_t y, size_t w
+) {
+   if( RETROFLAT_COLOR_NULL == color_idx ) {
+      return;
+   }
+
+   if( NULL == target ) {
+      target = retroflat_screen_buffer();
+   }
+
+   retroglu_hspan( target, color_idx, x, y, w );
+}
+
+/* === */
+
+void retroflat_idx_row(
+   struct RETROFLAT_BITMAP* target, const uint8_t* idx_row,
+   size_t x, size_t y, size_t w, RETROFLAT_COLOR txp_idx
+) {
+   if( NULL == target ) {
+      target = retroflat_screen_buffer();
+   }
+
+   retroglu_idx_row( target, idx_row, x, y, w, txp_idx );
+}
+
+/* === */
+
 RETROFLAT_IN_KEY retroflat_poll_input( struct RETROFLAT_INPUT* input ) {
    RETROFLAT_IN_KEY key_out = 0;
 
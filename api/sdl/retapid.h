@@ -6,6 +6,8 @@
 
 #define RETROFLAT_SOFT_VIEWPORT
 
+#define RETROFLAT_PX_ROW
+
 #  if defined( RETROFLAT_OPENGL )
 #     include <GL/gl.h>
 #     include <GL/glu.h>
@@ -34,6 +36,10 @@
 #     define RETROFLAT_SOFT_LINES
 #  endif /* !RETROFLAT_SOFT_LINES */
 
+#  if defined( RETROFLAT_SDL2_STREAMING ) && defined( RETROFLAT_OPENGL )
+#     error "RETROFLAT_SDL2_STREAMING does not apply to OpenGL!"
+#  endif /* RETROFLAT_SDL2_STREAMING && RETROFLAT_OPENGL */
+
 #  ifdef RETROFLAT_API_SDL1
 #     define RETROFLAT_VDP_LIB_NAME "rvdpsdl1"
 #  elif defined( RETROFLAT_API_SDL2 )
@@ -48,10 +54,25 @@ typedef int32_t RETROFLAT_IN_KEY;
 typedef int16_t RETROFLAT_IN_KEY;
 #endif /* RETROFLAT_API_SDL2 */
 
+/**
+ * \brief Flag set in RETROFLAT_BITMAP::flags while retroflat_px() is holding
+ *        an SDL1 surface lock between pixels. This is dropped before anything
+ *        else touches the surface.
+ */
+#define RETROFLAT_FLAGS_SDL_PX_HELD 0x08
+
 struct RETROFLAT_BITMAP {
    size_t sz;
    uint8_t flags;
    SDL_Surface* surface;
+#  ifndef RETROFLAT_OPENGL
+   /*! \brief Native pixel value of each ::RETROFLAT_COLOR in surface. */
+   uint32_t px_map[RETROFLAT_COLORS_SZ];
+   /*! \brief Format px_map was built for, or NULL to rebuild. */
+   SDL_PixelFormat* px_map_fmt;
+   /*! \brief RETROFLAT_PLATFORM::palette_gen px_map was built for. */
+   uint16_t px_map_gen;
+#  endif /* !RETROFLAT_OPENGL */
 #  ifdef RETROFLAT_API_SDL1
    /* SDL1 autolock counter. */
    ssize_t autolock_refs;
@@ -144,10 +165,10 @@ struct RETROFLAT_BITMAP {
 #  else
 #     define retroflat_bitmap_w( bmp ) \
          (NULL == (bmp) || NULL == (bmp)->surface ? \
-            g_retroflat_state->screen_v_w : (size_t)((bmp)->surface->w))
+            retroflat_screen_w() : (size_t)((bmp)->surface->w))
 #     define retroflat_bitmap_h( bmp ) \
          (NULL == (bmp) || NULL == (bmp)->surface ? \
-            g_retroflat_state->screen_v_h : (size_t)((bmp)->surface->h))
+            retroflat_screen_h() : (size_t)((bmp)->surface->h))
 #  endif /* RETROFLAT_OPENGL */
 #  ifdef RETROFLAT_OPENGL
 #     define retroflat_bitmap_locked( bmp ) (NULL != (bmp)->tex.bytes)
@@ -157,8 +178,20 @@ struct RETROFLAT_BITMAP {
 #  else
 #     define retroflat_bitmap_locked( bmp ) (NULL != (bmp)->renderer)
 #  endif
-#  define retroflat_screen_w() (g_retroflat_state->screen_v_w)
-#  define retroflat_screen_h() (g_retroflat_state->screen_v_h)
+#  ifdef RETROFLAT_VDP
+/* Programs draw on the VDP buffer, which the VDP may scale up. */
+#     define retroflat_screen_w() \
+         (NULL == g_retroflat_state->vdp_buffer ? \
+         g_retroflat_state->screen_v_w : \
+         g_retroflat_state->screen_v_w / g_retroflat_state->vdp_scale)
+#     define retroflat_screen_h() \
+         (NULL == g_retroflat_state->vdp_buffer ? \
+         g_retroflat_state->screen_v_h : \
+         g_retroflat_state->screen_v_h / g_retroflat_state->vdp_scale)
+#  else
+#     define retroflat_screen_w() (g_retroflat_state->screen_v_w)
+#     define retroflat_screen_h() (g_retroflat_state->screen_v_h)
+#  endif /* RETROFLAT_VDP */
 
 #  ifdef RETROFLAT_VDP
 #     define retroflat_screen_buffer() \
@@ -220,6 +253,8 @@ struct RETROFLAT_PLATFORM {
    SDL_Window*          window;
 #  endif /* !RETROFLAT_API_SDL1 */
    int                  mouse_state;
+   /*! \brief Incremented when the palette changes, to rebuild px_map. */
+   uint16_t             palette_gen;
 };
 
 #ifndef NO_RETROSND
@@ -6,6 +6,56 @@
 #  define SDL_WINDOW_SCALE 1
 #endif /* SDL_WINDOW_SCALE */
 
+#ifdef RETROFLAT_API_SDL2
+
+/* Create the screen buffer texture, and the surface it is drawn to in
+ * software if RETROFLAT_SDL2_STREAMING is defined.
+ */
+static MERROR_RETVAL _retroflat_sdl2_create_buffer( void ) {
+   MERROR_RETVAL retval = MERROR_OK;
+   struct RETROFLAT_BITMAP* buffer = &(g_retroflat_state->buffer);
+
+   if( NULL != buffer->texture ) {
+      SDL_DestroyTexture( buffer->texture );
+      buffer->texture = NULL;
+   }
+
+#  ifdef RETROFLAT_SDL2_STREAMING
+   if( NULL != buffer->surface ) {
+      SDL_FreeSurface( buffer->surface );
+      buffer->surface = NULL;
+   }
+
+   buffer->surface = SDL_CreateRGBSurface( 0,
+      g_retroflat_state->screen_w, g_retroflat_state->screen_h,
+      32, 0x00ff0000, 0x0000ff00, 0x000000ff, 0 );
+   maug_cleanup_if_null(
+      SDL_Surface*, buffer->surface, RETROFLAT_ERROR_GRAPHICS );
+   /* A new surface may get the same format pointer. */
+   buffer->px_map_fmt = NULL;
+
+   /* This matches the surface, so the surface can be uploaded as-is. It has
+    * no alpha, as the surface doesn't, so the frame isn't blended as if it
+    * were transparent.
+    */
+   buffer->texture = SDL_CreateTexture( buffer->renderer,
+      SDL_PIXELFORMAT_RGB888, SDL_TEXTUREACCESS_STREAMING,
+      g_retroflat_state->screen_w, g_retroflat_state->screen_h );
+#  else
+   buffer->texture = SDL_CreateTexture( buffer->renderer,
+      SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET,
+      g_retroflat_state->screen_w, g_retroflat_state->screen_h );
+#  endif /* RETROFLAT_SDL2_STREAMING */
+   maug_cleanup_if_null(
+      SDL_Texture*, buffer->texture, RETROFLAT_ERROR_GRAPHICS );
+
+cleanup:
+
+   return retval;
+}
+
+#endif /* RETROFLAT_API_SDL2 */
+
 MERROR_RETVAL retroflat_init_platform(
    int argc, char* argv[], struct RETROFLAT_ARGS* args
 ) {
@@ -185,10 +235,8 @@ MERROR_RETVAL retroflat_init_platform(
       RETROFLAT_ERROR_GRAPHICS );
 
    /* Create the buffer texture. */
-   g_retroflat_state->buffer.texture =
-      SDL_CreateTexture( g_retroflat_state->buffer.renderer,
-      SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET,
-      g_retroflat_state->screen_w, g_retroflat_state->screen_h );
+   retval = _retroflat_sdl2_create_buffer();
+   maug_cleanup_if_not_ok();
 
    /* TODO: This doesn't seem to do anything. */
    if(
@@ -218,6 +266,13 @@ cleanup:
 
 void retroflat_shutdown_platform( MERROR_RETVAL retval ) {
 
+#     ifdef RETROFLAT_SDL2_STREAMING
+   if( NULL != g_retroflat_state->buffer.surface ) {
+      SDL_FreeSurface( g_retroflat_state->buffer.surface );
+      g_retroflat_state->buffer.surface = NULL;
+   }
+#     endif /* RETROFLAT_SDL2_STREAMING */
+
 #     ifndef RETROFLAT_API_SDL1
    SDL_DestroyWindow( g_retroflat_state->platform.window );
 #     endif /* !RETROFLAT_API_SDL1 */
@@ -350,6 +405,48 @@ uint32_t retroflat_get_rand() {
 
 /* === */
 
+#  ifndef RETROFLAT_OPENGL
+
+static void _retroflat_sdl_px_map( struct RETROFLAT_BITMAP* bmp ) {
+   size_t i = 0;
+
+   debug_printf( RETROFLAT_BITMAP_TRACE_LVL,
+      "building pixel map for surface format %p...", bmp->surface->format );
+
+   for( i = 0 ; RETROFLAT_COLORS_SZ > i ; i++ ) {
+      bmp->px_map[i] = SDL_MapRGB( bmp->surface->format,
+         g_retroflat_state->palette[i].r,
+         g_retroflat_state->palette[i].g,
+         g_retroflat_state->palette[i].b );
+   }
+
+   bmp->px_map_fmt = bmp->surface->format;
+   bmp->px_map_gen = g_retroflat_state->platform.palette_gen;
+}
+
+/* === */
+
+#     ifdef RETROFLAT_API_SDL1
+
+/* Drop the lock retroflat_px() may be holding on a surface, so SDL can blit
+ * or flip it.
+ */
+static void _retroflat_sdl_px_drop( struct RETROFLAT_BITMAP* bmp ) {
+   if(
+      NULL != bmp &&
+      RETROFLAT_FLAGS_SDL_PX_HELD == (RETROFLAT_FLAGS_SDL_PX_HELD & bmp->flags)
+   ) {
+      bmp->flags &= ~RETROFLAT_FLAGS_SDL_PX_HELD;
+      retroflat_px_release( bmp );
+   }
+}
+
+/* === */
+
+#     endif /* RETROFLAT_API_SDL1 */
+
+#  endif /* !RETROFLAT_OPENGL */
+
 int retroflat_draw_lock( struct RETROFLAT_BITMAP* bmp ) {
    int retval = RETROFLAT_OK;
 
@@ -402,9 +499,11 @@ int retroflat_draw_lock( struct RETROFLAT_BITMAP* bmp ) {
    ) {
 
       /* Target is the screen buffer. */
+#     ifndef RETROFLAT_SDL2_STREAMING
       SDL_SetRenderTarget(
          g_retroflat_state->buffer.renderer,
          g_retroflat_state->buffer.texture );
+#     endif /* !RETROFLAT_SDL2_STREAMING */
 
       goto cleanup;
 
@@ -442,6 +541,8 @@ MERROR_RETVAL retroflat_draw_release( struct RETROFLAT_BITMAP* bmp ) {
       /* Special case: Attempting to release the (real, non-VDP) screen. */
       bmp = &(g_retroflat_state->buffer);
 
+      _retroflat_sdl_px_drop( bmp );
+
       if(
          RETROFLAT_FLAGS_LOCK == (RETROFLAT_FLAGS_LOCK & bmp->flags)
       ) {
@@ -456,7 +557,8 @@ MERROR_RETVAL retroflat_draw_release( struct RETROFLAT_BITMAP* bmp ) {
          bmp->flags &= ~RETROFLAT_FLAGS_SCREEN_LOCK;
 
 #     if defined( RETROFLAT_VDP )
-         retroflat_vdp_call( "retroflat_vdp_flip" );
+         _retroflat_sdl_px_drop( g_retroflat_state->vdp_buffer );
+         retroflat_vdp_call( RETROFLAT_VDP_PROC_FLIP );
 #     endif /* RETROFLAT_VDP */
 
          SDL_Flip( bmp->surface );
@@ -465,6 +567,7 @@ MERROR_RETVAL retroflat_draw_release( struct RETROFLAT_BITMAP* bmp ) {
    } else {
       /* Releasing a bitmap. */
       assert( RETROFLAT_FLAGS_LOCK == (RETROFLAT_FLAGS_LOCK & bmp->flags) );
+      _retroflat_sdl_px_drop( bmp );
       bmp->flags &= ~RETROFLAT_FLAGS_LOCK;
       SDL_UnlockSurface( bmp->surface );
    }
@@ -480,7 +583,14 @@ MERROR_RETVAL retroflat_draw_release( struct RETROFLAT_BITMAP* bmp ) {
 #     endif /* RETROFLAT_VDP */
    ) {
       /* Flip the screen. */
+#     ifdef RETROFLAT_SDL2_STREAMING
+      /* Upload the whole frame at once. */
+      SDL_UpdateTexture( g_retroflat_state->buffer.texture, NULL,
+         g_retroflat_state->buffer.surface->pixels,
+         g_retroflat_state->buffer.surface->pitch );
+#     else
       SDL_SetRenderTarget( g_retroflat_state->buffer.renderer, NULL );
+#     endif /* RETROFLAT_SDL2_STREAMING */
       SDL_RenderCopyEx(
          g_retroflat_state->buffer.renderer,
          g_retroflat_state->buffer.texture, NULL, NULL, 0, NULL, 0 );
@@ -701,8 +811,14 @@ void retroflat_destroy_bitmap( struct RETROFLAT_BITMAP* bmp ) {
    bmp->texture = NULL;
 #     endif /* !RETROFLAT_API_SDL1 */
 
+#     ifdef RETROFLAT_API_SDL1
+   _retroflat_sdl_px_drop( bmp );
+#     endif /* RETROFLAT_API_SDL1 */
+
    SDL_FreeSurface( bmp->surface );
    bmp->surface = NULL;
+   /* A new surface may get the same format pointer. */
+   bmp->px_map_fmt = NULL;
 
 #  endif
 
@@ -760,47 +876,100 @@ MERROR_RETVAL retroflat_blit_bitmap(
    dest_rect.h = h;
 
 #     ifdef RETROFLAT_API_SDL1
+   _retroflat_sdl_px_drop( src );
+   _retroflat_sdl_px_drop( target );
    assert( 0 == src->autolock_refs );
    assert( 0 == target->autolock_refs );
+#     else
+   assert( retroflat_bitmap_locked( target ) );
+   if( NULL == target->surface ) {
+      /* The screen is a render target texture. */
+      retval = SDL_RenderCopy(
+         target->renderer, src->texture, &src_rect, &dest_rect );
+      if( 0 != retval ) {
+         error_printf( "could not blit texture: %s", SDL_GetError() );
+         retval = MERROR_GUI;
+      }
+      return retval;
+   }
+#     endif /* RETROFLAT_API_SDL1 */
+
+   /* Bitmaps (and the SDL2 streaming screen) are drawn in software, and the
+    * source surface is always up to date, so blit surface to surface.
+    */
    retval = 
       SDL_BlitSurface( src->surface, &src_rect, target->surface, &dest_rect );
    if( 0 != retval ) {
       error_printf( "could not blit surface: %s", SDL_GetError() );
       retval = MERROR_GUI;
    }
-#     else
 
-   assert( retroflat_bitmap_locked( target ) );
-   retval = SDL_RenderCopy(
-      target->renderer, src->texture, &src_rect, &dest_rect );
-   if( 0 != retval ) {
-      error_printf( "could not blit surface: %s", SDL_GetError() );
-      retval = MERROR_GUI;
+#  endif
+
+   return retval;
+}
+
+/* === */
+
+#  if defined( RETROFLAT_API_SDL1 ) && !defined( RETROFLAT_OPENGL )
+
+/**
+ * \brief Lock the surface of target for pixel writes.
+ *
+ * If the bitmap is locked for drawing, keep the surface locked until it is
+ * blitted or released, rather than locking it for every write.
+ */
+static void _retroflat_sdl_px_hold( struct RETROFLAT_BITMAP* target ) {
+   if(
+      0 != ((RETROFLAT_FLAGS_LOCK | RETROFLAT_FLAGS_SCREEN_LOCK) &
+         target->flags)
+   ) {
+      if(
+         RETROFLAT_FLAGS_SDL_PX_HELD !=
+         (RETROFLAT_FLAGS_SDL_PX_HELD & target->flags)
+      ) {
+         retroflat_px_lock( target );
+         target->flags |= RETROFLAT_FLAGS_SDL_PX_HELD;
+      }
+   } else {
+      retroflat_px_lock( target );
    }
 
-#     endif /* !RETROFLAT_API_SDL1 */
+   assert( 0 < target->autolock_refs );
+}
 
-#  endif
+/* === */
 
-   return retval;
+/**
+ * \brief Undo _retroflat_sdl_px_hold() if the surface is not being held
+ *        for the bitmap's draw lock.
+ */
+static void _retroflat_sdl_px_unhold( struct RETROFLAT_BITMAP* target ) {
+   if(
+      RETROFLAT_FLAGS_SDL_PX_HELD !=
+      (RETROFLAT_FLAGS_SDL_PX_HELD & target->flags)
+   ) {
+      retroflat_px_release( target );
+   }
 }
 
 /* === */
 
+#  endif /* RETROFLAT_API_SDL1 && !RETROFLAT_OPENGL */
+
 void retroflat_px(
    struct RETROFLAT_BITMAP* target, const RETROFLAT_COLOR color_idx,
    size_t x, size_t y, uint8_t flags
 ) {
-#  if defined( RETROFLAT_OPENGL )
-#  elif defined( RETROFLAT_API_SDL1 )
+#  if !defined( RETROFLAT_OPENGL )
    int offset = 0;
    uint8_t* px_1 = NULL;
    uint16_t* px_2 = NULL;
    uint32_t* px_4 = NULL;
-   RETROFLAT_COLOR_DEF* color = &(g_retroflat_state->palette[color_idx]);
-#  elif defined( RETROFLAT_API_SDL2 )
-   RETROFLAT_COLOR_DEF* color = &(g_retroflat_state->palette[color_idx]);
-#  endif /* RETROFLAT_API_SDL1 */
+#     ifdef RETROFLAT_API_SDL2
+   RETROFLAT_COLOR_DEF* color = NULL;
+#     endif /* RETROFLAT_API_SDL2 */
+#  endif /* !RETROFLAT_OPENGL */
 
    if( RETROFLAT_COLOR_NULL == color_idx ) {
       return;
@@ -822,13 +991,33 @@ void retroflat_px(
 
    retroglu_px( target, color_idx, x, y, flags );
 
-#  elif defined( RETROFLAT_API_SDL1 )
+#  else
 
-   /* == SDL1 == */
+   /* == SDL == */
 
-   retroflat_px_lock( target );
+#     ifdef RETROFLAT_API_SDL2
+   assert( retroflat_bitmap_locked( target ) );
 
-   assert( 0 < target->autolock_refs );
+   if( NULL == target->surface ) {
+      /* The screen is a render target texture with no pixels to write to,
+       * unless RETROFLAT_SDL2_STREAMING is defined.
+       */
+      color = &(g_retroflat_state->palette[color_idx]);
+      SDL_SetRenderDrawColor(
+         target->renderer,  color->r, color->g, color->b, 255 );
+      SDL_RenderDrawPoint( target->renderer, x, y );
+      return;
+   }
+#     else
+   _retroflat_sdl_px_hold( target );
+#     endif /* RETROFLAT_API_SDL2 */
+
+   if(
+      target->px_map_fmt != target->surface->format ||
+      target->px_map_gen != g_retroflat_state->platform.palette_gen
+   ) {
+      _retroflat_sdl_px_map( target );
+   }
 
    offset = (y * target->surface->pitch) +
       (x * target->surface->format->BytesPerPixel);
@@ -836,34 +1025,210 @@ void retroflat_px(
    switch( target->surface->format->BytesPerPixel ) {
    case 4:
       px_4 = (uint32_t*)&(((uint8_t*)(target->surface->pixels))[offset]);
-      *px_4 =
-         SDL_MapRGB( target->surface->format, color->r, color->g, color->b );
+      *px_4 = target->px_map[color_idx];
       break;
 
    case 2:
       px_2 = (uint16_t*)&(((uint8_t*)(target->surface->pixels))[offset]);
-      *px_2 =
-         SDL_MapRGB( target->surface->format, color->r, color->g, color->b );
+      *px_2 = target->px_map[color_idx];
       break;
 
    case 1:
       px_1 = (uint8_t*)&(((uint8_t*)(target->surface->pixels))[offset]);
-      *px_1 =
-         SDL_MapRGB( target->surface->format, color->r, color->g, color->b );
+      *px_1 = target->px_map[color_idx];
       break;
    }
 
-   retroflat_px_release( target );
+#     ifdef RETROFLAT_API_SDL1
+   _retroflat_sdl_px_unhold( target );
+#     endif /* RETROFLAT_API_SDL1 */
 
-#  elif defined( RETROFLAT_API_SDL2 )
+#  endif /* RETROFLAT_OPENGL */
+}
 
-   /* == SDL2 == */
+/* === */
+
+void retroflat_px_row(
+   struct RETROFLAT_BITMAP* target, const RETROFLAT_COLOR color_idx,
+   size_t x, size_t y, size_t w
+) {
+#  if !defined( RETROFLAT_OPENGL )
+   size_t i = 0;
+   uint8_t* row = NULL;
+   uint32_t px = 0;
+#     ifdef RETROFLAT_API_SDL2
+   RETROFLAT_COLOR_DEF* color = NULL;
+#     endif /* RETROFLAT_API_SDL2 */
+#  endif /* !RETROFLAT_OPENGL */
+
+   if( RETROFLAT_COLOR_NULL == color_idx ) {
+      return;
+   }
+
+   if( NULL == target ) {
+      target = retroflat_screen_buffer();
+   }
+
+#  if defined( RETROFLAT_OPENGL )
+
+   retroglu_hspan( target, color_idx, x, y, w );
+
+#  else
+
+   if(
+      RETROFLAT_FLAGS_BITMAP_RO ==
+         (RETROFLAT_FLAGS_BITMAP_RO & target->flags) ||
+      0 == w
+   ) {
+      return;
+   }
+
+   retroflat_constrain_px( x, y, target, return );
 
+   if( x + w > retroflat_bitmap_w( target ) ) {
+      w = retroflat_bitmap_w( target ) - x;
+   }
+
+#     ifdef RETROFLAT_API_SDL2
    assert( retroflat_bitmap_locked( target ) );
 
-   SDL_SetRenderDrawColor(
-      target->renderer,  color->r, color->g, color->b, 255 );
-   SDL_RenderDrawPoint( target->renderer, x, y );
+   if( NULL == target->surface ) {
+      /* No pixels to write to; see retroflat_px(). */
+      color = &(g_retroflat_state->palette[color_idx]);
+      SDL_SetRenderDrawColor(
+         target->renderer,  color->r, color->g, color->b, 255 );
+      SDL_RenderDrawLine( target->renderer, x, y, x + w - 1, y );
+      return;
+   }
+#     else
+   _retroflat_sdl_px_hold( target );
+#     endif /* RETROFLAT_API_SDL2 */
+
+   if(
+      target->px_map_fmt != target->surface->format ||
+      target->px_map_gen != g_retroflat_state->platform.palette_gen
+   ) {
+      _retroflat_sdl_px_map( target );
+   }
+
+   row = &(((uint8_t*)(target->surface->pixels))[
+      (y * target->surface->pitch) +
+      (x * target->surface->format->BytesPerPixel)]);
+   px = target->px_map[color_idx];
+
+   /* Store whole words along the row rather than going through
+    * retroflat_px() for each pixel.
+    */
+   switch( target->surface->format->BytesPerPixel ) {
+   case 4:
+      for( i = 0 ; w > i ; i++ ) {
+         ((uint32_t*)row)[i] = px;
+      }
+      break;
+
+   case 2:
+      for( i = 0 ; w > i ; i++ ) {
+         ((uint16_t*)row)[i] = (uint16_t)px;
+      }
+      break;
+
+   case 1:
+      memset( row, (uint8_t)px, w );
+      break;
+   }
+
+#     ifdef RETROFLAT_API_SDL1
+   _retroflat_sdl_px_unhold( target );
+#     endif /* RETROFLAT_API_SDL1 */
+
+#  endif /* RETROFLAT_OPENGL */
+}
+
+/* === */
+
+void retroflat_idx_row(
+   struct RETROFLAT_BITMAP* target, const uint8_t* idx_row,
+   size_t x, size_t y, size_t w, RETROFLAT_COLOR txp_idx
+) {
+#  if !defined( RETROFLAT_OPENGL )
+   size_t i = 0;
+   uint8_t* row = NULL;
+#  endif /* !RETROFLAT_OPENGL */
+
+   if( NULL == target ) {
+      target = retroflat_screen_buffer();
+   }
+
+#  if defined( RETROFLAT_OPENGL )
+
+   retroglu_idx_row( target, idx_row, x, y, w, txp_idx );
+
+#  else
+
+   if(
+      RETROFLAT_FLAGS_BITMAP_RO ==
+         (RETROFLAT_FLAGS_BITMAP_RO & target->flags) ||
+      0 == w
+   ) {
+      return;
+   }
+
+   retroflat_constrain_px( x, y, target, return );
+
+   if( x + w > retroflat_bitmap_w( target ) ) {
+      w = retroflat_bitmap_w( target ) - x;
+   }
+
+#     ifdef RETROFLAT_API_SDL2
+   assert( retroflat_bitmap_locked( target ) );
+
+   if( NULL == target->surface ) {
+      /* No pixels to write to, so draw them one at a time. */
+      for( i = 0 ; w > i ; i++ ) {
+         if( txp_idx != idx_row[i] ) {
+            retroflat_px( target, idx_row[i], x + i, y, 0 );
+         }
+      }
+      return;
+   }
+#     else
+   _retroflat_sdl_px_hold( target );
+#     endif /* RETROFLAT_API_SDL2 */
+
+   if(
+      target->px_map_fmt != target->surface->format ||
+      target->px_map_gen != g_retroflat_state->platform.palette_gen
+   ) {
+      _retroflat_sdl_px_map( target );
+   }
+
+   row = &(((uint8_t*)(target->surface->pixels))[
+      (y * target->surface->pitch) +
+      (x * target->surface->format->BytesPerPixel)]);
+
+   for( i = 0 ; w > i ; i++ ) {
+      if( txp_idx == idx_row[i] ) {
+         continue;
+      }
+      assert( RETROFLAT_COLORS_SZ > idx_row[i] );
+      switch( target->surface->format->BytesPerPixel ) {
+      case 4:
+         ((uint32_t*)row)[i] = target->px_map[idx_row[i]];
+         break;
+
+      case 2:
+         ((uint16_t*)row)[i] = (uint16_t)target->px_map[idx_row[i]];
+         break;
+
+      case 1:
+         row[i] = (uint8_t)target->px_map[idx_row[i]];
+         break;
+      }
+   }
+
+#     ifdef RETROFLAT_API_SDL1
+   _retroflat_sdl_px_unhold( target );
+#     endif /* RETROFLAT_API_SDL1 */
 
 #  endif /* RETROFLAT_OPENGL */
 }
@@ -1047,6 +1412,9 @@ MERROR_RETVAL retroflat_set_palette( uint8_t idx, uint32_t rgb ) {
    g_retroflat_state->palette[idx].g = (rgb & 0xff00) >> 8;
    g_retroflat_state->palette[idx].r = (rgb & 0xff0000) >> 16;
 
+   /* Rebuild pixel maps on next use. */
+   g_retroflat_state->platform.palette_gen++;
+
 #  else
 #     pragma message( "warning: set palette not implemented" )
 #  endif
@@ -1168,13 +1536,11 @@ void retroflat_resize_v() {
    g_retroflat_state->screen_v_h = g_retroflat_state->screen_h;
 
    assert( NULL != g_retroflat_state->buffer.texture );
-   SDL_DestroyTexture( g_retroflat_state->buffer.texture );
 
-   /* Create the buffer texture. */
-   g_retroflat_state->buffer.texture =
-      SDL_CreateTexture( g_retroflat_state->buffer.renderer,
-      SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET,
-      g_retroflat_state->screen_w, g_retroflat_state->screen_h );
+   /* Recreate the buffer texture at the new size. */
+   if( MERROR_OK != _retroflat_sdl2_create_buffer() ) {
+      error_printf( "could not resize screen buffer!" );
+   }
 
 #  endif /* RETROFLAT_API_SDL2 */
 }
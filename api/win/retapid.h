@@ -231,10 +231,10 @@ extern HBRUSH gc_retroflat_win_brushes[];
 #  else
 #     define retroflat_bitmap_w( bmp ) \
          (NULL == (bmp) ? \
-            g_retroflat_state->screen_v_w : ((bmp)->bmi.header.biWidth))
+            retroflat_screen_w() : ((bmp)->bmi.header.biWidth))
 #     define retroflat_bitmap_h( bmp ) \
          (NULL == (bmp) ? \
-            g_retroflat_state->screen_v_h : ((bmp)->bmi.header.biHeight))
+            retroflat_screen_h() : ((bmp)->bmi.header.biHeight))
 #     define retroflat_bitmap_locked( bmp ) ((HDC)NULL != (bmp)->hdc_b)
 #  endif /* RETROFLAT_OPENGL */
 /* TODO: Adapt this for the OPENGL test above? */
@@ -307,8 +307,20 @@ extern HBRUSH gc_retroflat_win_brushes[];
 
 #  define retroflat_px_lock( bmp )
 #  define retroflat_px_release( bmp )
-#  define retroflat_screen_w() (g_retroflat_state->screen_v_w)
-#  define retroflat_screen_h() (g_retroflat_state->screen_v_h)
+#  ifdef RETROFLAT_VDP
+/* Programs draw on the VDP buffer, which the VDP may scale up. */
+#     define retroflat_screen_w() \
+         (NULL == g_retroflat_state->vdp_buffer ? \
+         g_retroflat_state->screen_v_w : \
+         g_retroflat_state->screen_v_w / g_retroflat_state->vdp_scale)
+#     define retroflat_screen_h() \
+         (NULL == g_retroflat_state->vdp_buffer ? \
+         g_retroflat_state->screen_v_h : \
+         g_retroflat_state->screen_v_h / g_retroflat_state->vdp_scale)
+#  else
+#     define retroflat_screen_w() (g_retroflat_state->screen_v_w)
+#     define retroflat_screen_h() (g_retroflat_state->screen_v_h)
+#  endif /* RETROFLAT_VDP */
 #  define retroflat_root_win() (g_retroflat_state->platform.window)
 #  define retroflat_quit( retval_in ) PostQuitMessage( retval_in );
 
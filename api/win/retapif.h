@@ -245,7 +245,7 @@ static LRESULT CALLBACK WndProc(
          }
 
 #        if defined( RETROFLAT_VDP )
-         retroflat_vdp_call( "retroflat_vdp_flip" );
+         retroflat_vdp_call( RETROFLAT_VDP_PROC_FLIP );
 #        endif /* RETROFLAT_VDP */
 
 #        ifdef RETROFLAT_WING
@@ -0,0 +1,650 @@
+
+/* Timing harness for hot paths, built with the bench target in Makefile.chk.
+ *
+ * Each case runs its unit of work reps times per round, with reps doubled
+ * until a round takes at least MBENCH_ROUND_MS, and the median of
+ * MBENCH_ROUNDS rounds is reported. Rounds are timed with the monotonic
+ * clock. Results are printed one case per line as:
+ *
+ *    <case> <reps> <ns per rep>
+ *
+ * Given a baseline in the same format with -b, the baseline and the change
+ * from it in percent are appended to each line, and the exit code is 1 if any
+ * case got slower by more than the threshold given with -t (default
+ * MBENCH_THRESHOLD_PCT). Cases missing from the baseline are listed after
+ * it. Timings are only comparable on the same machine, so the checked-in
+ * baseline should be recorded again with bench-baseline before comparing on
+ * another one.
+ *
+ * The RetroFlat modules are built against the stand-ins below rather than a
+ * platform, so retrosoft draws into a plain 8-bit memory bitmap.
+ */
+
+#define MAUG_NO_RETRO
+#include <mlegacy.h>
+#include <mtypes.h>
+
+/* The parsers yield to RetroFlat's timer every so often. */
+maug_ms_t retroflat_get_ms();
+
+#define MAUG_C
+#include <maug.h>
+
+#include <mlispp.h>
+#include <mlispe.h>
+
+#include <time.h>
+
+#ifndef MBENCH_ROUNDS
+#  define MBENCH_ROUNDS 7
+#endif /* !MBENCH_ROUNDS */
+
+#ifndef MBENCH_ROUND_MS
+#  define MBENCH_ROUND_MS 100
+#endif /* !MBENCH_ROUND_MS */
+
+#ifndef MBENCH_THRESHOLD_PCT
+#  define MBENCH_THRESHOLD_PCT 25
+#endif /* !MBENCH_THRESHOLD_PCT */
+
+#define MBENCH_NAME_SZ_MAX 31
+
+#define MBENCH_STRS_SZ 256
+#define MBENCH_VECTOR_SZ 1024
+#define MBENCH_BMP_W 320
+#define MBENCH_BMP_H 200
+/* retrotile asserts that map layers are 40x40. */
+#define MBENCH_MAP_W 40
+#define MBENCH_MAP_H 40
+#define MBENCH_MAP_LAYERS 2
+#define MBENCH_MAP_FILENAME "mbench.tmj"
+#define MBENCH_PATH_SZ_MAX 20
+#define MBENCH_MLISP_STEPS_MAX 100000
+
+/* === RetroFlat stand-ins === */
+
+#define RETROFLAT_PATH_MAX 256
+
+typedef maug_ms_t retroflat_ms_t;
+typedef int16_t retroflat_tile_t;
+typedef int16_t RETROFLAT_COLOR;
+
+#define RETROFLAT_COLOR_NULL (-1)
+#define RETROFLAT_COLOR_BLACK 0
+#define RETROFLAT_COLOR_WHITE 15
+#define RETROFLAT_FLAGS_FILL 0x01
+
+struct RETROFLAT_BITMAP {
+   size_t w;
+   size_t h;
+   uint8_t* px;
+};
+
+#define retroflat_bitmap_w( bmp ) ((bmp)->w)
+#define retroflat_bitmap_h( bmp ) ((bmp)->h)
+#define retroflat_px( bmp, color, x, y, flags ) \
+   (bmp)->px[((y) * (bmp)->w) + (x)] = (uint8_t)(color)
+#define retroflat_px_row( bmp, color, x, y, run_w ) \
+   memset( &((bmp)->px[((y) * (bmp)->w) + (x)]), (uint8_t)(color), (run_w) )
+#define retroflat_px_lock( bmp )
+#define retroflat_px_release( bmp )
+#define retroflat_screen_buffer() (&g_mbench_screen)
+
+MAUG_CONST int16_t SEG_MCONST gc_retroflat_offsets8_x[8] =
+   {  0,  1, 1, 1, 0, -1, -1, -1 };
+MAUG_CONST int16_t SEG_MCONST gc_retroflat_offsets8_y[8] =
+   { -1, -1, 0, 1, 1,  1,  0, -1 };
+
+MAUG_CONST int16_t SEG_MCONST gc_retroflat_offsets4_x[4] =
+   {  0, 1, 0, -1 };
+MAUG_CONST int16_t SEG_MCONST gc_retroflat_offsets4_y[4] =
+   { -1, 0, 1,  0 };
+
+static uint8_t g_mbench_screen_px[MBENCH_BMP_W * MBENCH_BMP_H];
+static struct RETROFLAT_BITMAP g_mbench_screen =
+   { MBENCH_BMP_W, MBENCH_BMP_H, g_mbench_screen_px };
+
+maug_ms_t retroflat_get_ms() {
+   return (maug_ms_t)(clock() / (CLOCKS_PER_SEC / 1000));
+}
+
+#define RETROTIL_C
+#include <retrotil.h>
+#define RETROPTH_C
+#include <retropth.h>
+
+#define RETROFLAT_NO_STRING
+#define RETROFLAT_SOFT_LINES
+#define RETROSFT_C
+#include <retrosft.h>
+
+/* === Fixtures === */
+
+static char g_mbench_strs[MBENCH_STRS_SZ][MBENCH_NAME_SZ_MAX + 1];
+static struct MDATA_STRPOOL g_mbench_strpool;
+static uint8_t g_mbench_bmp_4bit[(MBENCH_BMP_W * MBENCH_BMP_H) / 2];
+static uint8_t g_mbench_bmp_px[MBENCH_BMP_W * MBENCH_BMP_H];
+static MAUG_MHANDLE g_mbench_map_h = (MAUG_MHANDLE)NULL;
+
+/* Recurses a few dozen times and then does some arithmetic. */
+static const char* gc_mbench_mlisp =
+   "(define count (lambda (n) "
+      "(if (and (> n 0) (< n 1000)) "
+         "(count (+ n -1)) "
+         "(* (% n 7) (/ 100 5)))))"
+   "(define x 10)"
+   "(count (* x 5))";
+
+MERROR_RETVAL mbench_setup( void ) {
+   MERROR_RETVAL retval = MERROR_OK;
+   size_t i = 0,
+      x = 0,
+      y = 0;
+   ssize_t idx = 0;
+   FILE* map_file = NULL;
+   struct RETROTILE* t = NULL;
+   struct RETROTILE_LAYER* layer = NULL;
+   uint32_t seed = 12345;
+
+   for( i = 0 ; MBENCH_STRS_SZ > i ; i++ ) {
+      maug_snprintf(
+         g_mbench_strs[i], MBENCH_NAME_SZ_MAX, "mbench_str_" SIZE_T_FMT, i );
+      idx = mdata_strpool_append(
+         &g_mbench_strpool, g_mbench_strs[i], maug_strlen( g_mbench_strs[i] ) );
+      if( 0 > idx ) {
+         retval = mdata_retval( idx );
+         goto cleanup;
+      }
+   }
+
+   for( i = 0 ; sizeof( g_mbench_bmp_4bit ) > i ; i++ ) {
+      seed = (seed * 1103515245) + 12345;
+      g_mbench_bmp_4bit[i] = (seed >> 16) & 0xff;
+   }
+
+   /* Write a Tiled map for retrotile to parse from mapsrc/. */
+   map_file = fopen( "mapsrc/" MBENCH_MAP_FILENAME, "w" );
+   maug_cleanup_if_null_file( map_file );
+   fprintf( map_file, "{ \"height\": %d, \"width\": %d, \"layers\": [",
+      MBENCH_MAP_H, MBENCH_MAP_W );
+   for( i = 0 ; MBENCH_MAP_LAYERS > i ; i++ ) {
+      fprintf( map_file, "%s{ \"name\": \"layer" SIZE_T_FMT "\", \"data\": [",
+         0 < i ? ", " : "", i );
+      for( y = 0 ; MBENCH_MAP_W * MBENCH_MAP_H > y ; y++ ) {
+         fprintf( map_file, "%s" SIZE_T_FMT, 0 < y ? ", " : "", (y * 7) % 13 );
+      }
+      fprintf( map_file, "] }" );
+   }
+   fprintf( map_file, "] }\n" );
+   fclose( map_file );
+   map_file = NULL;
+
+   /* Build a map with a wall down the middle for the pathfinder. */
+   retval = retrotile_alloc( &g_mbench_map_h, MBENCH_MAP_W, MBENCH_MAP_H, 1 );
+   maug_cleanup_if_not_ok();
+
+   maug_mlock( g_mbench_map_h, t );
+   maug_cleanup_if_null_lock( struct RETROTILE*, t );
+   layer = retrotile_get_layer_p( t, 0 );
+   for( y = 0 ; MBENCH_MAP_H > y ; y++ ) {
+      for( x = 0 ; MBENCH_MAP_W > x ; x++ ) {
+         retrotile_get_tile( t, layer, x, y ) =
+            (5 == x && 2 < y && 6 > y) ? 1 : 0;
+      }
+   }
+   maug_munlock( g_mbench_map_h, t );
+
+cleanup:
+
+   if( NULL != map_file ) {
+      fclose( map_file );
+   }
+
+   return retval;
+}
+
+/* === Cases === */
+
+static MERROR_RETVAL mbench_strpool_append( size_t reps ) {
+   MERROR_RETVAL retval = MERROR_OK;
+   struct MDATA_STRPOOL strpool;
+   size_t i = 0;
+   ssize_t idx = 0;
+
+   while( 0 < reps-- ) {
+      maug_mzero( &strpool, sizeof( struct MDATA_STRPOOL ) );
+      for( i = 0 ; MBENCH_STRS_SZ > i ; i++ ) {
+         idx = mdata_strpool_append(
+            &strpool, g_mbench_strs[i], maug_strlen( g_mbench_strs[i] ) );
+         if( 0 > idx ) {
+            retval = mdata_retval( idx );
+            break;
+         }
+      }
+      mdata_strpool_free( &strpool );
+      maug_cleanup_if_not_ok();
+   }
+
+cleanup:
+
+   return retval;
+}
+
+static MERROR_RETVAL mbench_strpool_find( size_t reps ) {
+   MERROR_RETVAL retval = MERROR_OK;
+   size_t i = 0;
+
+   while( 0 < reps-- ) {
+      for( i = 0 ; MBENCH_STRS_SZ > i ; i++ ) {
+         if( 0 > mdata_strpool_find(
+            &g_mbench_strpool, g_mbench_strs[i],
+            maug_strlen( g_mbench_strs[i] ) )
+         ) {
+            error_printf( "could not find: %s", g_mbench_strs[i] );
+            retval = MERROR_OVERFLOW;
+            goto cleanup;
+         }
+      }
+   }
+
+cleanup:
+
+   return retval;
+}
+
+static MERROR_RETVAL mbench_vector( size_t reps ) {
+   MERROR_RETVAL retval = MERROR_OK;
+   struct MDATA_VECTOR v;
+   size_t i = 0;
+   ssize_t idx = 0;
+
+   while( 0 < reps-- ) {
+      maug_mzero( &v, sizeof( struct MDATA_VECTOR ) );
+      for( i = 0 ; MBENCH_VECTOR_SZ > i ; i++ ) {
+         idx = mdata_vector_append( &v, &i, sizeof( size_t ) );
+         if( 0 > idx ) {
+            retval = mdata_retval( idx );
+            break;
+         }
+      }
+      /* Remove from the front, so every item left has to move. */
+      while( MERROR_OK == retval && 0 < mdata_vector_ct( &v ) ) {
+         retval = mdata_vector_remove( &v, 0 );
+      }
+      mdata_vector_free( &v );
+      maug_cleanup_if_not_ok();
+   }
+
+cleanup:
+
+   return retval;
+}
+
+static MERROR_RETVAL mbench_bmp_px( size_t reps ) {
+   MERROR_RETVAL retval = MERROR_OK;
+   mfile_t bmp_file;
+   struct MFMT_STRUCT_BMPINFO header_bmp_info;
+
+   maug_mzero( &header_bmp_info, sizeof( struct MFMT_STRUCT_BMPINFO ) );
+   header_bmp_info.sz = 40;
+   header_bmp_info.width = MBENCH_BMP_W;
+   header_bmp_info.height = MBENCH_BMP_H;
+   header_bmp_info.bpp = 4;
+   header_bmp_info.img_sz = sizeof( g_mbench_bmp_4bit );
+   header_bmp_info.palette_ncolors = 16;
+
+   while( 0 < reps-- ) {
+      retval = mfile_lock_buffer( (MAUG_MHANDLE)g_mbench_bmp_4bit,
+         sizeof( g_mbench_bmp_4bit ), &bmp_file );
+      maug_cleanup_if_not_ok();
+
+      retval = mfmt_read_bmp_px(
+         (struct MFMT_STRUCT*)&header_bmp_info,
+         g_mbench_bmp_px, sizeof( g_mbench_bmp_px ),
+         &bmp_file, 0, sizeof( g_mbench_bmp_4bit ), 0 );
+      mfile_close( &bmp_file );
+      maug_cleanup_if_not_ok();
+   }
+
+cleanup:
+
+   return retval;
+}
+
+static MERROR_RETVAL mbench_retrotile_json( size_t reps ) {
+   MERROR_RETVAL retval = MERROR_OK;
+   MAUG_MHANDLE map_h = (MAUG_MHANDLE)NULL;
+   MAUG_MHANDLE tile_defs_h = (MAUG_MHANDLE)NULL;
+   size_t tile_defs_count = 0;
+
+   while( 0 < reps-- ) {
+      retval = retrotile_parse_json_file( MBENCH_MAP_FILENAME, &map_h,
+         &tile_defs_h, &tile_defs_count, NULL, NULL );
+      if( (MAUG_MHANDLE)NULL != map_h ) {
+         maug_mfree( map_h );
+         map_h = (MAUG_MHANDLE)NULL;
+      }
+      if( (MAUG_MHANDLE)NULL != tile_defs_h ) {
+         maug_mfree( tile_defs_h );
+         tile_defs_h = (MAUG_MHANDLE)NULL;
+         tile_defs_count = 0;
+      }
+      maug_cleanup_if_not_ok();
+   }
+
+cleanup:
+
+   return retval;
+}
+
+static RETROTILE_RETVAL mbench_path_blocked(
+   uint16_t x, uint16_t y, uint8_t dir8, struct RETROTILE* t, void* data
+) {
+   struct RETROTILE_LAYER* layer = retrotile_get_layer_p( t, 0 );
+
+   /* Test the tile in dir from x, y. */
+   x += gc_retroflat_offsets4_x[dir8];
+   y += gc_retroflat_offsets4_y[dir8];
+
+   if(
+      MBENCH_MAP_W <= x || MBENCH_MAP_H <= y ||
+      0 != retrotile_get_tile( t, layer, x, y )
+   ) {
+      return RETROTILE_RETVAL_BLOCKED;
+   }
+
+   return 0;
+}
+
+static MERROR_RETVAL mbench_path( size_t reps ) {
+   MERROR_RETVAL retval = MERROR_OK;
+   struct RETROTILE_PATH_NODE path[MBENCH_PATH_SZ_MAX];
+   size_t path_sz = 0;
+   struct RETROTILE* t = NULL;
+
+   maug_mlock( g_mbench_map_h, t );
+   maug_cleanup_if_null_lock( struct RETROTILE*, t );
+
+   while( 0 < reps-- ) {
+      path_sz = 0;
+      /* Go around the wall from one side to the other. */
+      retval = retrotile_path_start( 4, 4, 6, 4,
+         path, &path_sz, MBENCH_PATH_SZ_MAX, t, 0, mbench_path_blocked, NULL );
+      maug_cleanup_if_not_ok();
+   }
+
+cleanup:
+
+   if( NULL != t ) {
+      maug_munlock( g_mbench_map_h, t );
+   }
+
+   return retval;
+}
+
+static MERROR_RETVAL mbench_mlisp( size_t reps ) {
+   MERROR_RETVAL retval = MERROR_OK;
+   struct MLISP_PARSER parser;
+   struct MLISP_EXEC_STATE exec;
+   size_t i = 0;
+
+   while( 0 < reps-- ) {
+      retval = mlisp_parser_init( &parser );
+      maug_cleanup_if_not_ok();
+
+      for( i = 0 ; '\0' != gc_mbench_mlisp[i] ; i++ ) {
+         retval = mlisp_parse_c( &parser, gc_mbench_mlisp[i] );
+         if( MERROR_OK != retval ) {
+            break;
+         }
+      }
+
+      if( MERROR_OK == retval ) {
+         retval = mlisp_exec_init( &parser, &exec );
+         i = 0;
+         while( MERROR_OK == retval && MBENCH_MLISP_STEPS_MAX > i++ ) {
+            retval = mlisp_step( &parser, &exec );
+         }
+         mlisp_exec_free( &exec );
+
+         /* MERROR_EXEC means the script ran to the end. */
+         if( MERROR_EXEC == retval ) {
+            retval = MERROR_OK;
+         } else if( MERROR_OK == retval ) {
+            error_printf( "script did not finish!" );
+            retval = MERROR_EXEC;
+         }
+      }
+
+      mlisp_parser_free( &parser );
+      maug_cleanup_if_not_ok();
+   }
+
+cleanup:
+
+   return retval;
+}
+
+static MERROR_RETVAL mbench_soft_rect( size_t reps ) {
+   while( 0 < reps-- ) {
+      /* Partly off the edge, so clipping is included. */
+      retrosoft_rect( NULL, RETROFLAT_COLOR_WHITE,
+         -16, 8, MBENCH_BMP_W, MBENCH_BMP_H, RETROFLAT_FLAGS_FILL );
+   }
+
+   return MERROR_OK;
+}
+
+static MERROR_RETVAL mbench_soft_ellipse( size_t reps ) {
+   while( 0 < reps-- ) {
+      retrosoft_ellipse( NULL, RETROFLAT_COLOR_WHITE,
+         8, 8, MBENCH_BMP_W - 16, MBENCH_BMP_H - 16, RETROFLAT_FLAGS_FILL );
+   }
+
+   return MERROR_OK;
+}
+
+/* === Harness === */
+
+typedef MERROR_RETVAL (*mbench_cb)( size_t reps );
+
+struct MBENCH_CASE {
+   const char* name;
+   mbench_cb cb;
+   /*! \brief Reps per round, set by mbench_run() to last MBENCH_ROUND_MS. */
+   size_t reps;
+   unsigned long ns;
+   /*! \brief Set by mbench_compare() if the case is in the baseline. */
+   uint8_t in_baseline;
+};
+
+static struct MBENCH_CASE g_mbench_cases[] = {
+   { "strpool_append_256", mbench_strpool_append, 0, 0, 0 },
+   { "strpool_find_256", mbench_strpool_find, 0, 0, 0 },
+   { "vector_append_remove_1024", mbench_vector, 0, 0, 0 },
+   { "bmp_px_4bit_320x200", mbench_bmp_px, 0, 0, 0 },
+   { "retrotile_json_40x40x2", mbench_retrotile_json, 0, 0, 0 },
+   { "retropth_astar", mbench_path, 0, 0, 0 },
+   { "mlisp_exec", mbench_mlisp, 0, 0, 0 },
+   { "retrosoft_rect_fill", mbench_soft_rect, 0, 0, 0 },
+   { "retrosoft_ellipse_fill", mbench_soft_ellipse, 0, 0, 0 },
+   { NULL, NULL, 0, 0, 0 }
+};
+
+/**
+ * \brief Run reps of a case and get how long it took in nanoseconds from the
+ *        monotonic clock, which isn't affected by clock changes or by the
+ *        coarse resolution of clock().
+ */
+static MERROR_RETVAL mbench_time(
+   struct MBENCH_CASE* bcase, size_t reps, double* p_ns
+) {
+   MERROR_RETVAL retval = MERROR_OK;
+   struct timespec start,
+      end;
+
+   clock_gettime( CLOCK_MONOTONIC, &start );
+   retval = bcase->cb( reps );
+   clock_gettime( CLOCK_MONOTONIC, &end );
+
+   *p_ns = ((double)(end.tv_sec - start.tv_sec) * 1000000000.0) +
+      (double)(end.tv_nsec - start.tv_nsec);
+
+   return retval;
+}
+
+static MERROR_RETVAL mbench_run( struct MBENCH_CASE* bcase ) {
+   MERROR_RETVAL retval = MERROR_OK;
+   double round_ns[MBENCH_ROUNDS];
+   double ns = 0;
+   size_t i = 0,
+      j = 0;
+
+   /* Warm up caches and allocator before timing. */
+   retval = bcase->cb( 1 );
+   maug_cleanup_if_not_ok();
+
+   /* Find enough reps that timer resolution and scheduling jitter are small
+    * next to a round.
+    */
+   bcase->reps = 1;
+   for( ;; ) {
+      retval = mbench_time( bcase, bcase->reps, &ns );
+      maug_cleanup_if_not_ok();
+      if( MBENCH_ROUND_MS * 1000000.0 <= ns ) {
+         break;
+      }
+      bcase->reps *= 2;
+   }
+
+   for( i = 0 ; MBENCH_ROUNDS > i ; i++ ) {
+      retval = mbench_time( bcase, bcase->reps, &ns );
+      maug_cleanup_if_not_ok();
+
+      /* Insert in order, so the median is in the middle. */
+      for( j = i ; 0 < j && round_ns[j - 1] > ns ; j-- ) {
+         round_ns[j] = round_ns[j - 1];
+      }
+      round_ns[j] = ns;
+   }
+
+   bcase->ns = (unsigned long)(round_ns[MBENCH_ROUNDS / 2] / bcase->reps);
+
+cleanup:
+
+   return retval;
+}
+
+/**
+ * \brief Print each case next to the baseline, and any cases the baseline is
+ *        missing.
+ * \return Number of cases more than threshold_pct slower than the baseline.
+ */
+static int mbench_compare( const char* baseline_path, int threshold_pct ) {
+   FILE* baseline = NULL;
+   char line[128];
+   char name[MBENCH_NAME_SZ_MAX + 1];
+   unsigned long reps = 0,
+      ns = 0;
+   long delta_pct = 0;
+   int regressions = 0;
+   struct MBENCH_CASE* bcase = NULL;
+
+   baseline = fopen( baseline_path, "r" );
+   if( NULL == baseline ) {
+      error_printf( "could not open baseline: %s", baseline_path );
+      return 1;
+   }
+
+   while( NULL != fgets( line, sizeof( line ), baseline ) ) {
+      if(
+         '#' == line[0] ||
+         3 != sscanf( line, "%31s %lu %lu", name, &reps, &ns )
+      ) {
+         continue;
+      }
+
+      for( bcase = g_mbench_cases ; NULL != bcase->name ; bcase++ ) {
+         if( 0 != strcmp( bcase->name, name ) ) {
+            continue;
+         }
+
+         bcase->in_baseline = 1;
+         delta_pct = 0 == ns ? 0 :
+            (long)((((double)bcase->ns - ns) * 100.0) / ns);
+         printf( "%s " SIZE_T_FMT " %lu %lu %+ld%%%s\n",
+            bcase->name, bcase->reps, bcase->ns, ns, delta_pct,
+            threshold_pct < delta_pct ? " SLOWER" : "" );
+         if( threshold_pct < delta_pct ) {
+            regressions++;
+         }
+      }
+   }
+
+   fclose( baseline );
+
+   for( bcase = g_mbench_cases ; NULL != bcase->name ; bcase++ ) {
+      if( !bcase->in_baseline ) {
+         printf( "%s " SIZE_T_FMT " %lu NOT IN BASELINE\n",
+            bcase->name, bcase->reps, bcase->ns );
+      }
+   }
+
+   return regressions;
+}
+
+int main( int argc, char** argv ) {
+   MERROR_RETVAL retval = MERROR_OK;
+   struct MBENCH_CASE* bcase = NULL;
+   const char* baseline_path = NULL;
+   int threshold_pct = MBENCH_THRESHOLD_PCT,
+      i = 0;
+
+   for( i = 1 ; argc > i ; i++ ) {
+      if( 0 == strcmp( "-b", argv[i] ) && argc > i + 1 ) {
+         baseline_path = argv[++i];
+      } else if( 0 == strcmp( "-t", argv[i] ) && argc > i + 1 ) {
+         threshold_pct = atoi( argv[++i] );
+      } else {
+         fprintf( stderr, "usage: %s [-b baseline] [-t threshold_pct]\n",
+            argv[0] );
+         return 1;
+      }
+   }
+
+   retval = mbench_setup();
+   maug_cleanup_if_not_ok();
+
+   if( NULL == baseline_path ) {
+      printf( "# case reps ns_per_rep\n" );
+   }
+
+   for( bcase = g_mbench_cases ; NULL != bcase->name ; bcase++ ) {
+      retval = mbench_run( bcase );
+      if( MERROR_OK != retval ) {
+         error_printf( "%s failed: %d", bcase->name, retval );
+         goto cleanup;
+      }
+      if( NULL == baseline_path ) {
+         printf( "%s " SIZE_T_FMT " %lu\n",
+            bcase->name, bcase->reps, bcase->ns );
+      }
+   }
+
+   if(
+      NULL != baseline_path &&
+      0 < mbench_compare( baseline_path, threshold_pct )
+   ) {
+      retval = MERROR_EXEC;
+   }
+
+cleanup:
+
+   mdata_strpool_free( &g_mbench_strpool );
+   if( (MAUG_MHANDLE)NULL != g_mbench_map_h ) {
+      maug_mfree( g_mbench_map_h );
+   }
+
+   return MERROR_OK == retval ? 0 : 1;
+}
+
@@ -17,12 +17,18 @@
 
 main_add_test_proto( mfmt )
 main_add_test_proto( rtil )
+main_add_test_proto( vdp )
+main_add_test_proto( font )
+main_add_test_proto( blt )
 
 int main( void ) {
    int number_failed = 0;
 
    main_add_test( mfmt );
    main_add_test( rtil );
+   main_add_test( vdp );
+   main_add_test( font );
+   main_add_test( blt );
 
    return( number_failed == 0 ) ? 0 : 1;
 }
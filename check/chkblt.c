@@ -0,0 +1,225 @@
+#include <maug.h>
+
+#define RETROBLT_C
+#include <retroblt.h>
+
+#include <check.h>
+
+#define CHECK_BLT_SRC_W 23
+#define CHECK_BLT_SRC_H 13
+#define CHECK_BLT_DEST_W 29
+#define CHECK_BLT_DEST_H 17
+#define CHECK_BLT_TXP 0
+
+struct CHECK_BLT_AREA {
+   size_t s_x;
+   size_t s_y;
+   int16_t d_x;
+   int16_t d_y;
+   size_t w;
+   size_t h;
+};
+
+/* Areas to blit, from inside both bitmaps to entirely off their edges. */
+static const struct CHECK_BLT_AREA gc_check_blt_areas[] = {
+   /* Whole source, inside dest. */
+   {  0,  0,   0,   0,  23,  13 },
+   {  0,  0,   3,   2,  23,  13 },
+   /* Partly off each edge of dest. */
+   {  0,  0,  -5,  -4,  23,  13 },
+   {  0,  0,  20,  10,  23,  13 },
+   {  4,  3,  -2,   5,  10,   6 },
+   { 10,  5,  27,  15,   8,   8 },
+   /* Wider and taller than the source. */
+   {  5,  2,   1,   1,  40,  40 },
+   {  3,  3, -30, -30, 100, 100 },
+   /* Entirely off dest or source. */
+   {  0,  0, -23,   0,  23,  13 },
+   {  0,  0,   0, -13,  23,  13 },
+   {  0,  0,  29,   0,  23,  13 },
+   {  0,  0,   0,  17,  23,  13 },
+   { 23,  0,   0,   0,   5,   5 },
+   {  0, 13,   0,   0,   5,   5 },
+   /* Empty. */
+   {  0,  0,   4,   4,   0,   5 }
+};
+
+#define CHECK_BLT_AREAS_SZ \
+   (sizeof( gc_check_blt_areas ) / sizeof( struct CHECK_BLT_AREA ))
+
+static uint8_t g_check_blt_src[CHECK_BLT_SRC_H][CHECK_BLT_SRC_W];
+static uint8_t g_check_blt_dest[CHECK_BLT_DEST_H][CHECK_BLT_DEST_W];
+static uint8_t g_check_blt_ref[CHECK_BLT_DEST_H][CHECK_BLT_DEST_W];
+
+static void check_blt_fill( void ) {
+   size_t x = 0,
+      y = 0;
+   uint32_t seed = 12345;
+
+   for( y = 0 ; CHECK_BLT_SRC_H > y ; y++ ) {
+      for( x = 0 ; CHECK_BLT_SRC_W > x ; x++ ) {
+         seed = (seed * 1103515245) + 12345;
+         /* Few enough colors that there are plenty of transparent runs. */
+         g_check_blt_src[y][x] = (seed >> 16) % 3;
+      }
+   }
+   /* Make sure runs touch both edges of some rows. */
+   g_check_blt_src[1][0] = 1;
+   g_check_blt_src[1][CHECK_BLT_SRC_W - 1] = 2;
+   g_check_blt_src[2][0] = CHECK_BLT_TXP;
+   g_check_blt_src[2][CHECK_BLT_SRC_W - 1] = CHECK_BLT_TXP;
+
+   memset( g_check_blt_dest, 0xcd, sizeof( g_check_blt_dest ) );
+   memset( g_check_blt_ref, 0xcd, sizeof( g_check_blt_ref ) );
+}
+
+/* Blit the area into the reference one pixel at a time. */
+static void check_blt_ref( const struct CHECK_BLT_AREA* area, uint8_t txp ) {
+   size_t x = 0,
+      y = 0;
+   long d_x = 0,
+      d_y = 0;
+
+   for( y = 0 ; area->h > y ; y++ ) {
+      for( x = 0 ; area->w > x ; x++ ) {
+         d_x = area->d_x + (long)x;
+         d_y = area->d_y + (long)y;
+         if(
+            0 > d_x || CHECK_BLT_DEST_W <= d_x ||
+            0 > d_y || CHECK_BLT_DEST_H <= d_y ||
+            CHECK_BLT_SRC_W <= area->s_x + x ||
+            CHECK_BLT_SRC_H <= area->s_y + y
+         ) {
+            continue;
+         }
+         if(
+            txp &&
+            CHECK_BLT_TXP == g_check_blt_src[area->s_y + y][area->s_x + x]
+         ) {
+            continue;
+         }
+         g_check_blt_ref[d_y][d_x] =
+            g_check_blt_src[area->s_y + y][area->s_x + x];
+      }
+   }
+}
+
+START_TEST( test_blt_runs_build ) {
+   struct RETROBLT_RUNS runs;
+   MERROR_RETVAL retval = MERROR_OK;
+   uint32_t* rows = NULL;
+   uint16_t* spans = NULL;
+   size_t x = 0,
+      y = 0,
+      i = 0;
+
+   maug_mzero( &runs, sizeof( struct RETROBLT_RUNS ) );
+   check_blt_fill();
+
+   retval = retroblt_runs_build( &runs, (uint8_t*)g_check_blt_src,
+      CHECK_BLT_SRC_W, CHECK_BLT_SRC_H, CHECK_BLT_TXP );
+   ck_assert_uint_eq( retval, MERROR_OK );
+   ck_assert_uint_eq( runs.rows_sz, CHECK_BLT_SRC_H );
+
+   maug_mlock( runs.rows_h, rows );
+   ck_assert_ptr_ne( rows, NULL );
+   maug_mlock( runs.spans_h, spans );
+   ck_assert_ptr_ne( spans, NULL );
+
+   /* Walk each row and match its runs against the pixels. */
+   for( y = 0 ; CHECK_BLT_SRC_H > y ; y++ ) {
+      i = rows[y];
+      x = 0;
+      while( CHECK_BLT_SRC_W > x ) {
+         if( CHECK_BLT_TXP == g_check_blt_src[y][x] ) {
+            x++;
+            continue;
+         }
+         ck_assert_uint_lt( i, rows[y + 1] );
+         ck_assert_uint_eq( spans[i * 2], x );
+         while(
+            CHECK_BLT_SRC_W > x && CHECK_BLT_TXP != g_check_blt_src[y][x]
+         ) {
+            x++;
+         }
+         ck_assert_uint_eq( spans[i * 2] + spans[(i * 2) + 1], x );
+         i++;
+      }
+      ck_assert_uint_eq( i, rows[y + 1] );
+   }
+   ck_assert_uint_eq( rows[CHECK_BLT_SRC_H], runs.spans_sz );
+
+   maug_munlock( runs.spans_h, spans );
+   maug_munlock( runs.rows_h, rows );
+
+   retroblt_runs_free( &runs );
+}
+END_TEST
+
+START_TEST( test_blt_clip_opaque ) {
+   const struct CHECK_BLT_AREA* area = &(gc_check_blt_areas[_i]);
+   MERROR_RETVAL retval = MERROR_OK;
+
+   check_blt_fill();
+   check_blt_ref( area, 0 );
+
+   retval = retroblt_blit(
+      (uint8_t*)g_check_blt_dest, CHECK_BLT_DEST_W, CHECK_BLT_DEST_H,
+      (uint8_t*)g_check_blt_src, CHECK_BLT_SRC_W, CHECK_BLT_SRC_H, NULL,
+      area->s_x, area->s_y, area->d_x, area->d_y, area->w, area->h );
+   ck_assert_uint_eq( retval, MERROR_OK );
+
+   ck_assert_int_eq(
+      0, memcmp( g_check_blt_dest, g_check_blt_ref,
+         sizeof( g_check_blt_dest ) ) );
+}
+END_TEST
+
+START_TEST( test_blt_clip_runs ) {
+   const struct CHECK_BLT_AREA* area = &(gc_check_blt_areas[_i]);
+   struct RETROBLT_RUNS runs;
+   MERROR_RETVAL retval = MERROR_OK;
+
+   maug_mzero( &runs, sizeof( struct RETROBLT_RUNS ) );
+   check_blt_fill();
+   check_blt_ref( area, 1 );
+
+   retval = retroblt_runs_build( &runs, (uint8_t*)g_check_blt_src,
+      CHECK_BLT_SRC_W, CHECK_BLT_SRC_H, CHECK_BLT_TXP );
+   ck_assert_uint_eq( retval, MERROR_OK );
+
+   retval = retroblt_blit(
+      (uint8_t*)g_check_blt_dest, CHECK_BLT_DEST_W, CHECK_BLT_DEST_H,
+      (uint8_t*)g_check_blt_src, CHECK_BLT_SRC_W, CHECK_BLT_SRC_H, &runs,
+      area->s_x, area->s_y, area->d_x, area->d_y, area->w, area->h );
+   ck_assert_uint_eq( retval, MERROR_OK );
+
+   ck_assert_int_eq(
+      0, memcmp( g_check_blt_dest, g_check_blt_ref,
+         sizeof( g_check_blt_dest ) ) );
+
+   retroblt_runs_free( &runs );
+}
+END_TEST
+
+Suite* blt_suite( void ) {
+   Suite* s;
+   TCase* tc_runs;
+   TCase* tc_clip;
+
+   s = suite_create( "blt" );
+
+   tc_runs = tcase_create( "Runs" );
+   tcase_add_test( tc_runs, test_blt_runs_build );
+   suite_add_tcase( s, tc_runs );
+
+   tc_clip = tcase_create( "Clip" );
+   tcase_add_loop_test(
+      tc_clip, test_blt_clip_opaque, 0, CHECK_BLT_AREAS_SZ );
+   tcase_add_loop_test(
+      tc_clip, test_blt_clip_runs, 0, CHECK_BLT_AREAS_SZ );
+   suite_add_tcase( s, tc_clip );
+
+   return s;
+}
+
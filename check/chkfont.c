@@ -0,0 +1,191 @@
+
+#include <maug.h>
+
+#include <check.h>
+
+/* Just enough of RetroFlat for retrofont to draw into plain memory. */
+
+typedef int16_t RETROFLAT_COLOR;
+
+#define RETROFLAT_COLOR_BLACK 0
+#define RETROFLAT_COLOR_DARKBLUE 1
+#define RETROFLAT_COLOR_WHITE 15
+#define RETROFLAT_INSTANCE_NULL (-1)
+
+struct RETROFLAT_BITMAP {
+   size_t w;
+   size_t h;
+   uint8_t* px;
+};
+
+#define retroflat_px( bmp, color, x, y, flags ) \
+   if( (bmp)->w > (size_t)(x) && (bmp)->h > (size_t)(y) ) { \
+      (bmp)->px[((y) * (bmp)->w) + (x)] = (uint8_t)(color); \
+   }
+#define retroflat_draw_lock( bmp )
+#define retroflat_draw_release( bmp )
+#define retroflat_px_lock( bmp )
+#define retroflat_px_release( bmp )
+
+static MERROR_RETVAL retroflat_create_bitmap(
+   size_t w, size_t h, struct RETROFLAT_BITMAP* bmp, uint8_t flags
+) {
+   bmp->px = calloc( w, h );
+   if( NULL == bmp->px ) {
+      return MERROR_ALLOC;
+   }
+   bmp->w = w;
+   bmp->h = h;
+   return MERROR_OK;
+}
+
+static void retroflat_destroy_bitmap( struct RETROFLAT_BITMAP* bmp ) {
+   free( bmp->px );
+   bmp->px = NULL;
+}
+
+/* Treat 0 as transparent, like a color-keyed backend. */
+static MERROR_RETVAL retroflat_blit_bitmap(
+   struct RETROFLAT_BITMAP* target, struct RETROFLAT_BITMAP* src,
+   size_t s_x, size_t s_y, int16_t d_x, int16_t d_y, size_t w, size_t h,
+   int16_t instance
+) {
+   size_t x = 0,
+      y = 0;
+
+   for( y = 0 ; h > y ; y++ ) {
+      for( x = 0 ; w > x ; x++ ) {
+         if( 0 != src->px[((s_y + y) * src->w) + s_x + x] ) {
+            retroflat_px( target, src->px[((s_y + y) * src->w) + s_x + x],
+               d_x + x, d_y + y, 0 );
+         }
+      }
+   }
+
+   return MERROR_OK;
+}
+
+#define RETROFNT_C
+#include <retrofnt.h>
+
+#define CHECK_FONT_GLYPH_H 8
+#define CHECK_FONT_W 16
+
+static uint8_t g_check_font_px[CHECK_FONT_GLYPH_H * CHECK_FONT_W];
+static struct RETROFLAT_BITMAP g_check_font_target =
+   { CHECK_FONT_W, CHECK_FONT_GLYPH_H, g_check_font_px };
+
+/* Make a font with a single 'A' glyph whose rows are all row_px. */
+static MAUG_MHANDLE check_font_create( uint8_t row_px ) {
+   MAUG_MHANDLE font_h = (MAUG_MHANDLE)NULL;
+   struct RETROFONT* font = NULL;
+   uint8_t* glyph = NULL;
+
+   font_h = maug_malloc( 1, sizeof( struct RETROFONT ) + CHECK_FONT_GLYPH_H );
+   ck_assert_ptr_nonnull( font_h );
+   maug_mlock( font_h, font );
+   ck_assert_ptr_nonnull( font );
+
+   font->sz = sizeof( struct RETROFONT );
+   font->first_glyph = 'A';
+   font->last_glyph = 'A';
+   font->glyphs_count = 1;
+   font->glyph_w = 8;
+   font->glyph_h = CHECK_FONT_GLYPH_H;
+   font->glyph_sz = CHECK_FONT_GLYPH_H;
+   glyph = retrofont_glyph_at( font, 'A' );
+   memset( glyph, row_px, CHECK_FONT_GLYPH_H );
+
+   maug_munlock( font_h, font );
+
+   return font_h;
+}
+
+static size_t check_font_draw_count( MAUG_MHANDLE font_h ) {
+   size_t i = 0,
+      px_ct = 0;
+
+   memset( g_check_font_px, 0, sizeof( g_check_font_px ) );
+   retrofont_string( &g_check_font_target, RETROFLAT_COLOR_WHITE,
+      "A", 1, font_h, 0, 0, 0, 0, 0 );
+
+   for( i = 0 ; sizeof( g_check_font_px ) > i ; i++ ) {
+      if( RETROFLAT_COLOR_WHITE == g_check_font_px[i] ) {
+         px_ct++;
+      }
+   }
+
+   return px_ct;
+}
+
+START_TEST( test_font_cache_two_fonts ) {
+   MAUG_MHANDLE solid_h = check_font_create( 0xff );
+   MAUG_MHANDLE blank_h = check_font_create( 0x00 );
+   size_t solid_ct = 0,
+      i = 0;
+
+   /* Draw twice so the second draw comes from the atlas. */
+   solid_ct = check_font_draw_count( solid_h );
+   ck_assert_uint_gt( solid_ct, 0 );
+   ck_assert_uint_eq( check_font_draw_count( solid_h ), solid_ct );
+
+   /* The same color in another font must get its own atlas. */
+   ck_assert_uint_eq( check_font_draw_count( blank_h ), 0 );
+   ck_assert_uint_eq( check_font_draw_count( solid_h ), solid_ct );
+
+   /* Freeing one font's atlases should leave the other's alone. */
+   retrofont_cache_free( solid_h );
+   for( i = 0 ; RETROFONT_CACHE_ENTRIES_MAX > i ; i++ ) {
+      ck_assert_ptr_ne( gs_retrofont_cache[i].font_h, solid_h );
+   }
+   ck_assert_uint_eq( check_font_draw_count( blank_h ), 0 );
+
+   retrofont_cache_free( NULL );
+   maug_mfree( solid_h );
+   maug_mfree( blank_h );
+}
+END_TEST
+
+START_TEST( test_font_cache_sz ) {
+   MAUG_MHANDLE font_h = check_font_create( 0xff );
+   size_t w = 0,
+      h = 0;
+
+   retrofont_string_sz(
+      NULL, "AAA", 3, font_h, 0, 0, &w, &h, 0 );
+   ck_assert_uint_eq( w, (3 * 8) + 1 );
+   ck_assert_uint_eq( h, CHECK_FONT_GLYPH_H );
+
+   /* The size should be remembered for this font. */
+   ck_assert_ptr_eq(
+      gs_retrofont_sz_cache[
+         mdata_hash( "AAA", 3 ) % RETROFONT_SZ_CACHE_MAX].font_h, font_h );
+
+   w = 0;
+   h = 0;
+   retrofont_string_sz(
+      NULL, "AAA", 3, font_h, 0, 0, &w, &h, 0 );
+   ck_assert_uint_eq( w, (3 * 8) + 1 );
+   ck_assert_uint_eq( h, CHECK_FONT_GLYPH_H );
+
+   retrofont_cache_free( NULL );
+   maug_mfree( font_h );
+}
+END_TEST
+
+Suite* font_suite( void ) {
+   Suite* s;
+   TCase* tc_cache;
+
+   s = suite_create( "font" );
+
+   tc_cache = tcase_create( "Cache" );
+
+   tcase_add_test( tc_cache, test_font_cache_two_fonts );
+   tcase_add_test( tc_cache, test_font_cache_sz );
+
+   suite_add_tcase( s, tc_cache );
+
+   return s;
+}
+
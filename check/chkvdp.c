@@ -0,0 +1,158 @@
+
+#include <maug.h>
+
+#define RETROVDP_C
+#include <retrovdp.h>
+
+#include <check.h>
+
+#define CHECK_VDP_W 37
+#define CHECK_VDP_H 23
+/* Pad rows so pitch is not just width. */
+#define CHECK_VDP_PITCH_PAD 3
+#define CHECK_VDP_SCALE_MAX 5
+
+static uint32_t g_check_vdp_src[CHECK_VDP_H][CHECK_VDP_W + CHECK_VDP_PITCH_PAD];
+static uint32_t g_check_vdp_dest[CHECK_VDP_H * CHECK_VDP_SCALE_MAX][
+   (CHECK_VDP_W * CHECK_VDP_SCALE_MAX) + CHECK_VDP_PITCH_PAD];
+static uint32_t g_check_vdp_ref[CHECK_VDP_H][CHECK_VDP_W + CHECK_VDP_PITCH_PAD];
+
+static void check_vdp_fill( void ) {
+   size_t x = 0,
+      y = 0;
+   uint32_t seed = 12345;
+
+   for( y = 0 ; CHECK_VDP_H > y ; y++ ) {
+      for( x = 0 ; CHECK_VDP_W + CHECK_VDP_PITCH_PAD > x ; x++ ) {
+         seed = (seed * 1103515245) + 12345;
+         /* Only use a few colors, so remapping has something to match. */
+         g_check_vdp_src[y][x] = 0xff000000 | (0x10101 * ((seed >> 16) % 6));
+      }
+   }
+   memcpy( g_check_vdp_ref, g_check_vdp_src, sizeof( g_check_vdp_src ) );
+   memset( g_check_vdp_dest, 0xcd, sizeof( g_check_vdp_dest ) );
+}
+
+START_TEST( test_vdp_scale_nearest ) {
+   size_t x = 0,
+      y = 0;
+   uint8_t scale = _i;
+   ssize_t dest_pitch = sizeof( g_check_vdp_dest[0] );
+
+   check_vdp_fill();
+
+   retrovdp_scale_nearest(
+      (uint8_t*)g_check_vdp_src, sizeof( g_check_vdp_src[0] ),
+      CHECK_VDP_W, CHECK_VDP_H,
+      (uint8_t*)g_check_vdp_dest, dest_pitch, scale );
+
+   for( y = 0 ; CHECK_VDP_H * scale > y ; y++ ) {
+      for( x = 0 ; CHECK_VDP_W * scale > x ; x++ ) {
+         ck_assert_uint_eq(
+            g_check_vdp_dest[y][x], g_check_vdp_src[y / scale][x / scale] );
+      }
+      /* Nothing past the scaled width should be touched. */
+      ck_assert_uint_eq( g_check_vdp_dest[y][CHECK_VDP_W * scale], 0xcdcdcdcd );
+   }
+}
+END_TEST
+
+START_TEST( test_vdp_scale_nearest_bottom_up ) {
+   size_t x = 0,
+      y = 0;
+
+   check_vdp_fill();
+
+   /* Scale from the last source row up, into the last dest row up. */
+   retrovdp_scale_nearest(
+      (uint8_t*)g_check_vdp_src[CHECK_VDP_H - 1],
+      -(ssize_t)sizeof( g_check_vdp_src[0] ), CHECK_VDP_W, CHECK_VDP_H,
+      (uint8_t*)g_check_vdp_dest[(CHECK_VDP_H * 2) - 1],
+      -(ssize_t)sizeof( g_check_vdp_dest[0] ), 2 );
+
+   for( y = 0 ; CHECK_VDP_H * 2 > y ; y++ ) {
+      for( x = 0 ; CHECK_VDP_W * 2 > x ; x++ ) {
+         ck_assert_uint_eq(
+            g_check_vdp_dest[y][x], g_check_vdp_src[y / 2][x / 2] );
+      }
+   }
+}
+END_TEST
+
+START_TEST( test_vdp_scanlines ) {
+   size_t x = 0,
+      y = 0,
+      i = 0;
+   uint8_t period = _i;
+   uint8_t* px = NULL;
+
+   check_vdp_fill();
+
+   retrovdp_scanlines(
+      (uint8_t*)g_check_vdp_src, sizeof( g_check_vdp_src[0] ),
+      CHECK_VDP_W, CHECK_VDP_H, period );
+
+   /* Halve each byte of every period'th row one at a time. */
+   for( y = period - 1 ; CHECK_VDP_H > y ; y += period ) {
+      for( x = 0 ; CHECK_VDP_W > x ; x++ ) {
+         px = (uint8_t*)&(g_check_vdp_ref[y][x]);
+         for( i = 0 ; 4 > i ; i++ ) {
+            px[i] /= 2;
+         }
+      }
+   }
+
+   ck_assert_int_eq(
+      0, memcmp( g_check_vdp_src, g_check_vdp_ref, sizeof( g_check_vdp_src ) ) );
+}
+END_TEST
+
+START_TEST( test_vdp_remap ) {
+   size_t x = 0,
+      y = 0,
+      i = 0;
+   /* Swap two colors, and change another. */
+   uint32_t from[3] = { 0xff000000, 0xff010101, 0xff050505 };
+   uint32_t to[3] = { 0xff010101, 0xff000000, 0xffff00ff };
+
+   check_vdp_fill();
+
+   retrovdp_remap(
+      (uint8_t*)g_check_vdp_src, sizeof( g_check_vdp_src[0] ),
+      CHECK_VDP_W, CHECK_VDP_H, from, to, 3 );
+
+   for( y = 0 ; CHECK_VDP_H > y ; y++ ) {
+      for( x = 0 ; CHECK_VDP_W > x ; x++ ) {
+         for( i = 0 ; 3 > i ; i++ ) {
+            if( g_check_vdp_ref[y][x] == from[i] ) {
+               g_check_vdp_ref[y][x] = to[i];
+               break;
+            }
+         }
+      }
+   }
+
+   ck_assert_int_eq(
+      0, memcmp( g_check_vdp_src, g_check_vdp_ref, sizeof( g_check_vdp_src ) ) );
+}
+END_TEST
+
+Suite* vdp_suite( void ) {
+   Suite* s;
+   TCase* tc_kernels;
+
+   s = suite_create( "vdp" );
+
+   tc_kernels = tcase_create( "Kernels" );
+
+   tcase_add_loop_test(
+      tc_kernels, test_vdp_scale_nearest, 1, CHECK_VDP_SCALE_MAX + 1 );
+   tcase_add_test( tc_kernels, test_vdp_scale_nearest_bottom_up );
+   tcase_add_loop_test( tc_kernels, test_vdp_scanlines, 1, 4 );
+   tcase_add_test( tc_kernels, test_vdp_remap );
+
+   suite_add_tcase( s, tc_kernels );
+
+   return s;
+}
+
@@ -0,0 +1,4 @@
+
+#define MLZ_C
+#include <maug.h>
+
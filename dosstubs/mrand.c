@@ -0,0 +1,4 @@
+
+#define MRAND_C
+#include <maug.h>
+
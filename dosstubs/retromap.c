@@ -0,0 +1,12 @@
+
+#if !defined( RETROFLAT_NO_RETROTILE ) && !defined( RETROFLAT_NO_RETROGXC )
+#  define MAUG_NO_RETRO
+#  include <maug.h>
+#  include <retroflt.h>
+#  include <retrofnt.h>
+#  include <retrotil.h>
+#  include <retrogxc.h>
+#  define RETROMAP_C
+#  include <retromap.h>
+#endif /* !RETROFLAT_NO_RETROTILE && !RETROFLAT_NO_RETROGXC */
+
@@ -0,0 +1,59 @@
+#!/usr/bin/awk -f
+
+# Convert an XPM (as written by ImageMagick's convert from a 16-color bitmap)
+# into a palette-indexed byte array for retroxpm.h. Pass the asset name as
+# -v name=... and the array will be called gc_xpm_px_<name>.
+#
+# XPM characters are mapped to RETROFLAT_COLOR indexes in the same order
+# retroflat_load_xpm() used to decode them at runtime.
+
+BEGIN {
+   pal = " .XoO+@#$%&*=-;:"
+   w = 0
+   h = 0
+   colors = -1
+   rows = 0
+}
+
+/^"/ {
+   line = $0
+   sub( /^"/, "", line )
+   sub( /"[,]?[ \t]*$/, "", line )
+
+   if( 0 > colors ) {
+      # First string is the header: columns rows colors chars-per-pixel
+      split( line, hdr, " " )
+      w = hdr[1]
+      h = hdr[2]
+      colors = hdr[3]
+      if( 16 != hdr[3] || 1 != hdr[4] ) {
+         print "xpm2idx: " name ": expected 16 colors, 1 char per pixel" \
+            > "/dev/stderr"
+      }
+      printf "MAUG_CONST uint8_t SEG_MCONST gc_xpm_px_%s[] = {\n", name
+      next
+   }
+
+   if( 0 < colors ) {
+      # Skip the color table; the palette order is fixed.
+      colors--
+      next
+   }
+
+   printf "  "
+   for( i = 1 ; w >= i ; i++ ) {
+      idx = index( pal, substr( line, i, 1 ) ) - 1
+      if( 0 > idx ) {
+         idx = 0
+      }
+      printf " %d,", idx
+   }
+   printf "\n"
+   rows++
+}
+
+END {
+   printf "};\n"
+   printf "#define gc_xpm_w_%s %d\n", name, w
+   printf "#define gc_xpm_h_%s %d\n\n", name, rows
+}
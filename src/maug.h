@@ -66,11 +66,21 @@
 #endif /* MAUG_C */
 #include <mdata.h>
 
+#ifdef MAUG_C
+#  define MRAND_C
+#endif /* MAUG_C */
+#include <mrand.h>
+
 #ifdef MAUG_C
 #  define MARGE_C
 #endif /* MAUG_C */
 #include <marge.h>
 
+#ifdef MAUG_C
+#  define MLZ_C
+#endif /* MAUG_C */
+#include <mlz.h>
+
 #ifdef MAUG_C
 #  define MFILE_C
 #endif /* MAUG_C */
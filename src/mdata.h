@@ -10,6 +10,12 @@
 #  define MDATA_VECTOR_INIT_SZ 10
 #endif /* !MDATA_TRACE_LVL */
 
+/**
+ * \brief Starting value for mdata_hash_cont(), so that hashes can be built up
+ *        from several buffers in sequence.
+ */
+#define MDATA_HASH_INIT 0x811c9dc5
+
 typedef ssize_t mdata_strpool_idx_t;
 
 struct MDATA_STRPOOL {
@@ -62,6 +68,21 @@ MERROR_RETVAL mdata_vector_alloc(
 
 void mdata_vector_free( struct MDATA_VECTOR* v );
 
+/**
+ * \brief Continue a 32-bit FNV-1a hash over the given bytes.
+ * \param hash Hash returned by a previous call, or ::MDATA_HASH_INIT.
+ * \return The updated hash.
+ */
+uint32_t mdata_hash_cont( uint32_t hash, const void* data, size_t data_sz );
+
+/**
+ * \brief Get a 32-bit FNV-1a hash of the given bytes. This is not
+ *        cryptographically secure, and should only be used for lookups and
+ *        change detection.
+ */
+#define mdata_hash( data, data_sz ) \
+   mdata_hash_cont( MDATA_HASH_INIT, data, data_sz )
+
 #define mdata_strpool_sz( strpool ) ((strpool)->str_sz_max)
 
 #define mdata_strpool_lock( strpool, ptr ) \
@@ -504,6 +525,20 @@ void mdata_vector_free( struct MDATA_VECTOR* v ) {
    }
 }
 
+/* === */
+
+uint32_t mdata_hash_cont( uint32_t hash, const void* data, size_t data_sz ) {
+   size_t i = 0;
+   const uint8_t* data_bytes = (const uint8_t*)data;
+
+   for( i = 0 ; data_sz > i ; i++ ) {
+      hash ^= data_bytes[i];
+      hash *= 0x01000193;
+   }
+
+   return hash;
+}
+
 #endif /* MDATA_C */
 
 #endif /* MDATA_H */
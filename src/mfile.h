@@ -48,6 +48,13 @@
 
 #define MFILE_FLAG_READ_ONLY     0x01
 
+/**
+ * \brief Flag for ::MFILE_CADDY_TYPE_MEM_BUFFER caddies whose buffer was
+ *        allocated by mfile (e.g. to decompress a packed VFS entry into) and
+ *        should be freed by mfile_close().
+ */
+#define MFILE_FLAG_HANDLE_OWNED  0x02
+
 #define MFILE_READ_FLAG_LSBF     0x01
 
 #ifndef MFILE_TRACE_LVL
@@ -90,6 +97,21 @@ struct MFILE_CADDY {
 
 typedef struct MFILE_CADDY mfile_t;
 
+/**
+ * \brief Entry in the directory of files compiled in by make/Makevfs.inc
+ *        when MVFS_ENABLED is defined. The directory is sorted by filename.
+ */
+struct MFILE_VFS_ENTRY {
+   const char* filename;
+   unsigned char* data;
+   off_t* len;
+   /**
+    * \brief If nonzero, data is \ref maug_lz compressed and this is its
+    *        size once decompressed by mfile_open_read().
+    */
+   off_t unpacked_sz;
+};
+
 #define mfile_check_lock( p_file ) (NULL != (p_file)->mem_buffer)
 
 #define mfile_default_case( p_file ) \
@@ -483,24 +505,20 @@ MERROR_RETVAL mfile_mem_read_int(
       }
    
    } else {
-      /* Move to the end of the output buffer and read backwards. */
-      while( 0 < buf_sz ) {
-         /* Check for EOF. */
-         if( p_file->mem_cursor >= p_file->sz ) {
-            retval = MERROR_FILE;
-            error_printf(
-               "cursor " OFF_T_FMT " beyond end of buffer " OFF_T_FMT "!",
-               p_file->mem_cursor, p_file->sz );
-            goto cleanup;
-         }
-
-         buf[buf_sz - 1] = p_file->mem_buffer[p_file->mem_cursor];
-         debug_printf( MFILE_TRACE_LVL, "byte #" SIZE_T_FMT " = # " OFF_T_FMT,
-            buf_sz - 1, p_file->mem_cursor );
-         buf_sz--;
-         buf++;
-         p_file->mem_cursor++;
+      /* Bytes are already in order, so copy them all at once. */
+      if( p_file->mem_cursor + (off_t)buf_sz > p_file->sz ) {
+         retval = MERROR_FILE;
+         error_printf(
+            "read of " SIZE_T_FMT " bytes at " OFF_T_FMT
+               " beyond end of buffer " OFF_T_FMT "!",
+            buf_sz, p_file->mem_cursor, p_file->sz );
+         goto cleanup;
       }
+
+      memcpy( buf, &(p_file->mem_buffer[p_file->mem_cursor]), buf_sz );
+      debug_printf( MFILE_TRACE_LVL, "copied " SIZE_T_FMT " bytes at "
+         OFF_T_FMT, buf_sz, p_file->mem_cursor );
+      p_file->mem_cursor += buf_sz;
    }
 
 cleanup:
@@ -587,7 +605,11 @@ MERROR_RETVAL mfile_lock_buffer(
 MERROR_RETVAL mfile_open_read( const char* filename, mfile_t* p_file ) {
    MERROR_RETVAL retval = MERROR_OK;
 #  if defined( MVFS_ENABLED )
-   size_t i = 0;
+   struct MFILE_VFS_ENTRY* entry = NULL;
+   size_t lo = 0,
+      hi = gc_mvfs_dir_sz,
+      mid = 0;
+   int cmp = 0;
 #  elif defined( MFILE_MMAP )
    uint8_t* bytes_ptr = NULL;
    struct stat st;
@@ -605,17 +627,24 @@ MERROR_RETVAL mfile_open_read( const char* filename, mfile_t* p_file ) {
 
 #  if defined( MVFS_ENABLED )
 
-   while( NULL != gc_mvfs_data[i] ) {
-      if( 0 == strcmp( filename, gc_mvfs_filenames[i] ) ) {
+   /* Binary search the sorted VFS directory. */
+   while( lo < hi ) {
+      mid = lo + ((hi - lo) / 2);
+      cmp = strcmp( filename, gc_mvfs_dir[mid].filename );
+      if( 0 == cmp ) {
+         entry = &(gc_mvfs_dir[mid]);
          debug_printf( 1, "found file \"%s\" at VFS index: " SIZE_T_FMT
          " (size: " OFF_T_FMT " bytes)",
-            filename, i, *(gc_mvfs_lens[i]) );
+            filename, mid, *(entry->len) );
          break;
+      } else if( 0 > cmp ) {
+         hi = mid;
+      } else {
+         lo = mid + 1;
       }
-      i++;
    }
 
-   if( NULL == gc_mvfs_data[i] ) {
+   if( NULL == entry ) {
       retval = MERROR_FILE;
       error_printf( "file \"%s\" not found in VFS!", filename );
       goto cleanup;
@@ -626,10 +655,30 @@ MERROR_RETVAL mfile_open_read( const char* filename, mfile_t* p_file ) {
    p_file->seek = mfile_mem_seek;
    p_file->read_line = mfile_mem_read_line;
    p_file->flags = MFILE_FLAG_READ_ONLY;
-   p_file->mem_buffer = gc_mvfs_data[i];
-   p_file->sz = *(gc_mvfs_lens[i]);
    p_file->mem_cursor = 0;
 
+   if( 0 == entry->unpacked_sz ) {
+      /* Stored as-is, so read straight from the VFS. */
+      p_file->mem_buffer = entry->data;
+      p_file->sz = *(entry->len);
+      goto cleanup;
+   }
+
+   /* Decompress into a buffer owned by the file until it's closed. */
+   p_file->h.mem = maug_malloc( 1, entry->unpacked_sz );
+   maug_cleanup_if_null_alloc( MAUG_MHANDLE, p_file->h.mem );
+   p_file->flags |= MFILE_FLAG_HANDLE_OWNED;
+   maug_mlock( p_file->h.mem, p_file->mem_buffer );
+   maug_cleanup_if_null_lock( uint8_t*, p_file->mem_buffer );
+   p_file->sz = entry->unpacked_sz;
+
+   retval = mlz_decompress(
+      entry->data, *(entry->len), p_file->mem_buffer, entry->unpacked_sz );
+   if( MERROR_OK != retval ) {
+      error_printf( "could not decompress \"%s\" from VFS!", filename );
+      mfile_close( p_file );
+   }
+
 cleanup:
 
 #  elif defined( MFILE_MMAP )
@@ -771,6 +820,14 @@ void mfile_close( mfile_t* p_file ) {
             p_file->h.mem, p_file );
          p_file->type = 0;
       }
+      if(
+         MFILE_FLAG_HANDLE_OWNED ==
+            (MFILE_FLAG_HANDLE_OWNED & p_file->flags) &&
+         (MAUG_MHANDLE)NULL != p_file->h.mem
+      ) {
+         maug_mfree( p_file->h.mem );
+         p_file->type = 0;
+      }
       break;
       
    mfile_default_case( p_file );
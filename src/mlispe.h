@@ -935,7 +935,14 @@ static MERROR_RETVAL _mlisp_env_cb_random(
       goto cleanup;
    }
 
-   random_int = retroflat_get_rand() % mod.value.integer;
+   if( 0 >= mod.value.integer ) {
+      error_printf( "random: invalid modulus: %d", mod.value.integer );
+      retval = MERROR_EXEC;
+      goto cleanup;
+   }
+
+   random_int = mrand_range(
+      mrand_stream( MRAND_STREAM_MLISP ), mod.value.integer );
 
    debug_printf( MLISP_EXEC_TRACE_LVL, "random: %d", random_int ); 
 
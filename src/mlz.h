@@ -0,0 +1,271 @@
+
+#ifndef MLZ_H
+#define MLZ_H
+
+/**
+ * \addtogroup maug_lz Maug LZ Compression
+ * \brief Small LZSS codec for packed assets.
+ *
+ * The stream is a series of groups, each starting with a flag byte whose
+ * bits (lowest first) describe the next 8 items: 1 for a literal byte, 0 for
+ * a two-byte back-reference into the output so far (12 bits of distance,
+ * 4 bits of length). The decoder needs no memory besides its output, so it
+ * is cheap enough to run on open on retro targets.
+ *
+ * The encoder is only built if MLZ_ENCODER is defined, since it is only
+ * needed by build tools like tools/mvfspack.c.
+ * \{
+ * \file mlz.h
+ */
+
+#ifndef MLZ_TRACE_LVL
+#  define MLZ_TRACE_LVL 0
+#endif /* !MLZ_TRACE_LVL */
+
+/*! \brief Farthest back a match may refer to in the output. */
+#define MLZ_WINDOW_SZ 4096
+
+/*! \brief Shortest match worth encoding as a back-reference. */
+#define MLZ_MATCH_MIN 3
+
+/*! \brief Longest match that fits in a back-reference. */
+#define MLZ_MATCH_MAX (MLZ_MATCH_MIN + 15)
+
+#ifndef MLZ_CHAIN_MAX
+/*! \brief Number of earlier positions the encoder checks for each match. */
+#  define MLZ_CHAIN_MAX 128
+#endif /* !MLZ_CHAIN_MAX */
+
+/**
+ * \brief Largest size src_sz bytes can grow to when compressed, for sizing
+ *        the buffer passed to mlz_compress().
+ */
+#define mlz_compress_bound( src_sz ) ((src_sz) + ((src_sz) / 8) + 1)
+
+/**
+ * \brief Decompress src into dest, which must be exactly the uncompressed
+ *        size of the data.
+ * \return MERROR_OK, or MERROR_PARSE if src is corrupt or does not fill dest.
+ */
+MERROR_RETVAL mlz_decompress(
+   const uint8_t* src, size_t src_sz, uint8_t* dest, size_t dest_sz );
+
+#ifdef MLZ_ENCODER
+
+/**
+ * \brief Compress src into dest.
+ * \param p_dest_sz Size of dest, which should be at least
+ *        mlz_compress_bound( src_sz ). Set to the compressed size on return.
+ * \return MERROR_OK, or MERROR_OVERFLOW if dest is too small.
+ */
+MERROR_RETVAL mlz_compress(
+   const uint8_t* src, size_t src_sz, uint8_t* dest, size_t* p_dest_sz );
+
+#endif /* MLZ_ENCODER */
+
+#ifdef MLZ_C
+
+MERROR_RETVAL mlz_decompress(
+   const uint8_t* src, size_t src_sz, uint8_t* dest, size_t dest_sz
+) {
+   MERROR_RETVAL retval = MERROR_OK;
+   size_t src_i = 0,
+      dest_i = 0,
+      dist = 0,
+      len = 0;
+   uint8_t flags = 0,
+      bit = 0;
+
+   while( src_i < src_sz ) {
+      flags = src[src_i++];
+
+      for( bit = 0 ; 8 > bit && src_i < src_sz ; bit++ ) {
+         if( 0x01 == (0x01 & (flags >> bit)) ) {
+            /* Literal byte. */
+            if( dest_i >= dest_sz ) {
+               error_printf( "literal past end of output!" );
+               retval = MERROR_PARSE;
+               goto cleanup;
+            }
+            dest[dest_i++] = src[src_i++];
+            continue;
+         }
+
+         /* Back-reference. */
+         if( src_i + 1 >= src_sz ) {
+            error_printf( "truncated back-reference!" );
+            retval = MERROR_PARSE;
+            goto cleanup;
+         }
+         dist = (src[src_i] | ((size_t)(src[src_i + 1] >> 4) << 8)) + 1;
+         len = (src[src_i + 1] & 0x0f) + MLZ_MATCH_MIN;
+         src_i += 2;
+
+         if( dist > dest_i || dest_i + len > dest_sz ) {
+            error_printf( "invalid back-reference: " SIZE_T_FMT ", "
+               SIZE_T_FMT " at " SIZE_T_FMT, dist, len, dest_i );
+            retval = MERROR_PARSE;
+            goto cleanup;
+         }
+
+         /* Copy byte by byte, since the match may overlap its output. */
+         while( 0 < len ) {
+            dest[dest_i] = dest[dest_i - dist];
+            dest_i++;
+            len--;
+         }
+      }
+   }
+
+   if( dest_i != dest_sz ) {
+      error_printf( "decompressed " SIZE_T_FMT " bytes, expected " SIZE_T_FMT,
+         dest_i, dest_sz );
+      retval = MERROR_PARSE;
+   }
+
+   debug_printf( MLZ_TRACE_LVL, "decompressed " SIZE_T_FMT " bytes to "
+      SIZE_T_FMT " bytes", src_sz, dest_sz );
+
+cleanup:
+
+   return retval;
+}
+
+/* === */
+
+#ifdef MLZ_ENCODER
+
+#define MLZ_HASH_SZ 4096
+
+#define mlz_hash( p ) \
+   ((((size_t)(p)[0] << 4) ^ ((size_t)(p)[1] << 2) ^ (p)[2]) & \
+      (MLZ_HASH_SZ - 1))
+
+MERROR_RETVAL mlz_compress(
+   const uint8_t* src, size_t src_sz, uint8_t* dest, size_t* p_dest_sz
+) {
+   MERROR_RETVAL retval = MERROR_OK;
+   MAUG_MHANDLE chains_h = (MAUG_MHANDLE)NULL;
+   long* chains = NULL;
+   /* Most recent position with each hash, and the one before each. */
+   long* head = NULL;
+   long* prev = NULL;
+   long cand = 0;
+   size_t src_i = 0,
+      dest_i = 0,
+      flags_i = 0,
+      best_len = 0,
+      best_dist = 0,
+      len = 0,
+      chain = 0,
+      i = 0;
+   uint8_t bit = 8;
+
+   chains_h = maug_malloc( (MLZ_HASH_SZ + MLZ_WINDOW_SZ), sizeof( long ) );
+   maug_cleanup_if_null_alloc( MAUG_MHANDLE, chains_h );
+   maug_mlock( chains_h, chains );
+   maug_cleanup_if_null_lock( long*, chains );
+   head = chains;
+   prev = &(chains[MLZ_HASH_SZ]);
+
+   for( i = 0 ; MLZ_HASH_SZ > i ; i++ ) {
+      head[i] = -1;
+   }
+
+   while( src_i < src_sz ) {
+      /* Start a new group of 8 items if this one is full. */
+      if( 8 == bit ) {
+         if( dest_i >= *p_dest_sz ) {
+            retval = MERROR_OVERFLOW;
+            goto cleanup;
+         }
+         flags_i = dest_i++;
+         dest[flags_i] = 0;
+         bit = 0;
+      }
+
+      /* Find the longest match among earlier positions with the same hash. */
+      best_len = 0;
+      if( src_i + MLZ_MATCH_MIN <= src_sz ) {
+         cand = head[mlz_hash( &(src[src_i]) )];
+         for(
+            chain = 0 ;
+            0 <= cand && src_i - cand <= MLZ_WINDOW_SZ &&
+               MLZ_CHAIN_MAX > chain ;
+            chain++
+         ) {
+            for(
+               len = 0 ;
+               MLZ_MATCH_MAX > len && src_i + len < src_sz &&
+                  src[cand + len] == src[src_i + len] ;
+               len++
+            ) {}
+            if( len > best_len ) {
+               best_len = len;
+               best_dist = src_i - cand;
+               if( MLZ_MATCH_MAX == len ) {
+                  break;
+               }
+            }
+            cand = prev[cand % MLZ_WINDOW_SZ];
+         }
+      }
+
+      if( MLZ_MATCH_MIN > best_len ) {
+         /* Literal byte. */
+         if( dest_i >= *p_dest_sz ) {
+            retval = MERROR_OVERFLOW;
+            goto cleanup;
+         }
+         dest[flags_i] |= (0x01 << bit);
+         dest[dest_i++] = src[src_i];
+         best_len = 1;
+
+      } else {
+         /* Back-reference. */
+         if( dest_i + 1 >= *p_dest_sz ) {
+            retval = MERROR_OVERFLOW;
+            goto cleanup;
+         }
+         dest[dest_i++] = (best_dist - 1) & 0xff;
+         dest[dest_i++] = (((best_dist - 1) >> 8) << 4) |
+            (best_len - MLZ_MATCH_MIN);
+      }
+      bit++;
+
+      /* Add every position covered to the hash chains. */
+      for( i = 0 ; best_len > i ; i++ ) {
+         if( src_i + MLZ_MATCH_MIN <= src_sz ) {
+            prev[src_i % MLZ_WINDOW_SZ] = head[mlz_hash( &(src[src_i]) )];
+            head[mlz_hash( &(src[src_i]) )] = src_i;
+         }
+         src_i++;
+      }
+   }
+
+   debug_printf( MLZ_TRACE_LVL, "compressed " SIZE_T_FMT " bytes to "
+      SIZE_T_FMT " bytes", src_sz, dest_i );
+
+   *p_dest_sz = dest_i;
+
+cleanup:
+
+   if( NULL != chains ) {
+      maug_munlock( chains_h, chains );
+   }
+
+   if( (MAUG_MHANDLE)NULL != chains_h ) {
+      maug_mfree( chains_h );
+   }
+
+   return retval;
+}
+
+#endif /* MLZ_ENCODER */
+
+#endif /* MLZ_C */
+
+/*! \} */ /* maug_lz */
+
+#endif /* !MLZ_H */
+
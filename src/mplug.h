@@ -17,6 +17,21 @@ typedef void* mplug_mod_t;
 MERROR_RETVAL mplug_load(
    const char* plugin_path, mplug_mod_t* p_mod_exe );
 
+/**
+ * \brief Look up a procedure exported by a plugin so it can be called
+ *        without looking it up by name again.
+ * \param p_proc Set to the procedure found.
+ * \return MERROR_OK, or MERROR_FILE if the procedure could not be found.
+ */
+MERROR_RETVAL mplug_resolve(
+   mplug_mod_t mod_exe, const char* proc_name, mplug_proc_t* p_proc );
+
+/**
+ * \brief Look up a procedure by name and call it.
+ *
+ * This looks the procedure up again every time, so procedures that are
+ * called often should be looked up once with mplug_resolve() instead.
+ */
 MERROR_RETVAL mplug_call(
    mplug_mod_t mod_exe, const char* proc_name, void* data, size_t data_sz );
 
@@ -70,12 +85,6 @@ MERROR_RETVAL mplug_load(
 #  endif /* MAUG_WCHAR */
 
 cleanup:
-
-#  ifdef MAUG_WCHAR
-   if( NULL != plugin_path_w ) {
-      free( plugin_path_w );
-   }
-#  endif /* MAUG_WCHAR */
 #else
 #  pragma message( "warning: dlopen undefined!" )
 #endif /* RETROFLAT_OS_UNIX */
@@ -88,11 +97,10 @@ cleanup:
    return retval;
 }
 
-MERROR_RETVAL mplug_call(
-   mplug_mod_t mod_exe, const char* proc_name, void* data, size_t data_sz
+MERROR_RETVAL mplug_resolve(
+   mplug_mod_t mod_exe, const char* proc_name, mplug_proc_t* p_proc
 ) {
    MERROR_RETVAL retval = MERROR_OK;
-   mplug_proc_t plugin_proc = (mplug_proc_t)NULL;
 #ifdef RETROFLAT_OS_WIN
    char proc_name_ex[MAUG_PATH_SZ_MAX + 1] = { 0 };
 #  ifdef MAUG_WCHAR
@@ -100,8 +108,10 @@ MERROR_RETVAL mplug_call(
 #  endif /* MAUG_WCHAR */
 #endif /* RETROFLAT_OS_WIN */
 
+   *p_proc = (mplug_proc_t)NULL;
+
 #ifdef RETROFLAT_OS_UNIX
-   plugin_proc = dlsym( mod_exe, proc_name );
+   *p_proc = dlsym( mod_exe, proc_name );
 #elif defined( RETROFLAT_OS_WIN )
    memset( proc_name_ex, '\0', MAUG_PATH_SZ_MAX + 1 );
 
@@ -118,20 +128,33 @@ MERROR_RETVAL mplug_call(
       goto cleanup;
    }
 
-   plugin_proc = (mplug_proc_t)GetProcAddressW( mod_exe, proc_name_ex_w );
+   *p_proc = (mplug_proc_t)GetProcAddressW( mod_exe, proc_name_ex_w );
 #  else
-   plugin_proc = (mplug_proc_t)GetProcAddress( mod_exe, proc_name_ex );
+   *p_proc = (mplug_proc_t)GetProcAddress( mod_exe, proc_name_ex );
 #  endif /* MAUG_WCHAR */
 #else
 #  pragma message( "dlsym undefined!" )
 #endif
 
-   if( (mplug_proc_t)NULL == plugin_proc ) {
+   if( (mplug_proc_t)NULL == *p_proc ) {
       error_printf( "unable to load proc: %s", proc_name );
       retval = MERROR_FILE;
       goto cleanup;
    }
 
+cleanup:
+   return retval;
+}
+
+MERROR_RETVAL mplug_call(
+   mplug_mod_t mod_exe, const char* proc_name, void* data, size_t data_sz
+) {
+   MERROR_RETVAL retval = MERROR_OK;
+   mplug_proc_t plugin_proc = (mplug_proc_t)NULL;
+
+   retval = mplug_resolve( mod_exe, proc_name, &plugin_proc );
+   maug_cleanup_if_not_ok();
+
    retval = plugin_proc( data, data_sz );
 
 cleanup:
@@ -0,0 +1,153 @@
+
+#ifndef MRAND_H
+#define MRAND_H
+
+/**
+ * \addtogroup maug_rand Maug Random
+ * \brief Small, seedable random number generator.
+ *
+ * Each ::MRAND_STATE is an independent xorshift32 stream, so subsystems (or
+ * threads within a subsystem) can draw numbers without sharing state or
+ * locking, and get the same numbers back from the same seed.
+ * \{
+ * \file mrand.h
+ */
+
+#ifndef MRAND_TRACE_LVL
+#  define MRAND_TRACE_LVL 0
+#endif /* !MRAND_TRACE_LVL */
+
+#ifndef MRAND_SEED_DEFAULT
+/*! \brief Seed used by streams that are drawn from before being seeded. */
+#  define MRAND_SEED_DEFAULT 0x2545f491
+#endif /* !MRAND_SEED_DEFAULT */
+
+/**
+ * \addtogroup maug_rand_streams Maug Random Streams
+ * \brief Indexes of the global per-subsystem streams for mrand_stream().
+ * \{
+ */
+
+#define MRAND_STREAM_DEFAULT     0
+#define MRAND_STREAM_RETROTILE   1
+#define MRAND_STREAM_RETROANI    2
+#define MRAND_STREAM_MLISP       3
+
+#ifndef MRAND_STREAMS_MAX
+/*! \brief Number of global streams, including ones for applications. */
+#  define MRAND_STREAMS_MAX 8
+#endif /* !MRAND_STREAMS_MAX */
+
+/*! \} */ /* maug_rand_streams */
+
+struct MRAND_STATE {
+   uint32_t s;
+};
+
+/**
+ * \brief Seed a stream. Different stream numbers with the same seed produce
+ *        unrelated sequences.
+ */
+void mrand_seed( struct MRAND_STATE* r, uint32_t seed, uint32_t stream );
+
+/**
+ * \brief Get the next 32-bit number from the given stream.
+ */
+uint32_t mrand_next( struct MRAND_STATE* r );
+
+/**
+ * \brief Fill a buffer with random bytes from the given stream, four bytes
+ *        per step.
+ */
+void mrand_fill( struct MRAND_STATE* r, uint8_t* buf, size_t buf_sz );
+
+/**
+ * \brief Seed all global streams from one seed, e.g. to replay a session.
+ */
+void mrand_seed_streams( uint32_t seed );
+
+/**
+ * \brief Get a pointer to one of the global \ref maug_rand_streams.
+ */
+#define mrand_stream( idx ) (&(g_mrand_streams[idx]))
+
+/**
+ * \brief Get a number from 0 to n - 1 from the given stream.
+ */
+#define mrand_range( r, n ) (mrand_next( r ) % (n))
+
+#ifdef MRAND_C
+
+struct MRAND_STATE g_mrand_streams[MRAND_STREAMS_MAX];
+
+/* === */
+
+void mrand_seed( struct MRAND_STATE* r, uint32_t seed, uint32_t stream ) {
+   r->s = seed ^ ((stream + 1) * 0x9e3779b9);
+
+   /* State must never be 0 or xorshift will get stuck. */
+   if( 0 == r->s ) {
+      r->s = MRAND_SEED_DEFAULT;
+   }
+
+   /* Stir the state so adjacent streams diverge quickly. */
+   mrand_next( r );
+   mrand_next( r );
+}
+
+/* === */
+
+uint32_t mrand_next( struct MRAND_STATE* r ) {
+   uint32_t x = r->s;
+
+   if( 0 == x ) {
+      /* Stream was never seeded. */
+      x = MRAND_SEED_DEFAULT;
+   }
+
+   x ^= x << 13;
+   x ^= x >> 17;
+   x ^= x << 5;
+   r->s = x;
+
+   return x;
+}
+
+/* === */
+
+void mrand_fill( struct MRAND_STATE* r, uint8_t* buf, size_t buf_sz ) {
+   size_t i = 0;
+   uint32_t x = 0;
+
+   for( i = 0 ; buf_sz > i ; i++ ) {
+      if( 0 == (i & 0x03) ) {
+         x = mrand_next( r );
+      }
+      buf[i] = x & 0xff;
+      x >>= 8;
+   }
+}
+
+/* === */
+
+void mrand_seed_streams( uint32_t seed ) {
+   size_t i = 0;
+
+   debug_printf( MRAND_TRACE_LVL, "seeding random streams: " UPRINTF_X32_FMT,
+      seed );
+
+   for( i = 0 ; MRAND_STREAMS_MAX > i ; i++ ) {
+      mrand_seed( &(g_mrand_streams[i]), seed, i );
+   }
+}
+
+#else
+
+extern struct MRAND_STATE g_mrand_streams[MRAND_STREAMS_MAX];
+
+#endif /* MRAND_C */
+
+/*! \} */ /* maug_rand */
+
+#endif /* !MRAND_H */
+
@@ -84,12 +84,38 @@
 
 #define RETROANI_FLAG_CLOUDS_ROTATE 0x0010
 
+/**
+ * \relates ANIMATION
+ * \brief ::ANIMATION::flags indicating RETROANI::tile_bmp has been created.
+ *        Set internally by retroani_tesselate().
+ */
+#define RETROANI_FLAG_TILE_BMP 0x0020
+
 /*! \} */
 
-#define RETROANI_TILE_W 16
-#define RETROANI_TILE_H 16
+#ifndef RETROANI_TILE_W
+/**
+ * \brief Width of the grid each animation simulates and repeats across its
+ *        area. Must be less than 127.
+ */
+#  define RETROANI_TILE_W 16
+#endif /* !RETROANI_TILE_W */
+
+#ifndef RETROANI_TILE_H
+/*! \brief Height of the grid each animation simulates. Must be less than 127. */
+#  define RETROANI_TILE_H 16
+#endif /* !RETROANI_TILE_H */
+
 #define RETROANI_TILE_SZ (RETROANI_TILE_W * RETROANI_TILE_H)
 
+/**
+ * \brief Width of the buffer retroani_tesselate() renders a tile into,
+ *        including a 1px border for snowflake outlines.
+ */
+#define RETROANI_TILE_BUF_W (RETROANI_TILE_W + 2)
+#define RETROANI_TILE_BUF_H (RETROANI_TILE_H + 2)
+#define RETROANI_TILE_BUF_SZ (RETROANI_TILE_BUF_W * RETROANI_TILE_BUF_H)
+
 #define RETROANI_FIRE_COOLING_MAX 35
 #define RETROANI_FIRE_COOLING_MIN 25
 #define RETROANI_FIRE_WIND 1
@@ -147,6 +173,24 @@ struct RETROANI {
    struct RETROFLAT_BITMAP* target;
    uint32_t next_frame_ms;
    uint16_t mspf;
+#ifndef RETROFLAT_OPENGL
+   /**
+    * \brief Rendered tile, border included, blitted across the animation's
+    *        area by retroani_tesselate().
+    */
+   struct RETROFLAT_BITMAP tile_bmp;
+#endif /* !RETROFLAT_OPENGL */
+};
+
+/**
+ * \brief Horizontal run of one color in a rendered animation tile, relative
+ *        to the tile's top-left corner.
+ */
+struct RETROANI_RUN {
+   int8_t x;
+   int8_t y;
+   uint8_t w;
+   RETROFLAT_COLOR color;
 };
 
 /*! \brief Callback to call on active animations for every frame. */
@@ -176,6 +220,15 @@ int8_t retroani_create(
 
 /**
  * \brief Draw the animation tile to the screen, tiled to fill its area.
+ *
+ * The tile is rendered once into runs of color and drawn onto a cached
+ * bitmap, which is then blitted once per repetition. Black can't go through
+ * the bitmap, as color-keyed backends treat it as transparent, so black runs
+ * (snow outlines and cleanup pixels) are drawn with retroflat_rect() per
+ * repetition.
+ *
+ * OpenGL can't blit onto the screen yet, so there every run is drawn with
+ * retroflat_rect(), which is one quad per run.
  */
 void retroani_tesselate( struct RETROANI* a, int16_t y_orig );
 
@@ -216,6 +269,9 @@ RETROANI_CB_TABLE( RETROANI_CB_TABLE_DRAW_PROTOTYPES )
 
 #ifdef RETROANI_C
 
+/* All animations share one stream, so they don't disturb others' numbers. */
+#define RETROANI_RAND mrand_stream( MRAND_STREAM_RETROANI )
+
 #define RETROANI_CB_TABLE_LIST( idx, name ) retroani_draw_ ## name,
 
 const RETROANI_CB gc_animate_draw[] = {
@@ -259,11 +315,15 @@ void retroani_draw_CIRCLE( struct RETROANI* a ) {
 
 void retroani_draw_FIRE( struct RETROANI* a ) {
    int8_t x = 0,
-      next_x = 0,
       y = 0;
-   uint16_t
-      idx = 0,
-      next_idx = 0;
+   uint16_t idx = 0;
+   int8_t* row = NULL;
+   /* Row below the current row, with one wrapped-around cell on each side. */
+   int8_t src_row[RETROANI_TILE_W + 2];
+   /* Wind offsets followed by cooling amounts for the current row. */
+   uint8_t rnd[RETROANI_TILE_W * 2];
+   int heat = 0,
+      hot = 0;
 
    if( !(a->flags & RETROANI_FLAG_INIT) ) {
       /* Setup initial "heat line" from which fire is drawn. */
@@ -271,46 +331,43 @@ void retroani_draw_FIRE( struct RETROANI* a ) {
          idx = ((RETROANI_TILE_H - 1) * RETROANI_TILE_W) + x;
          /* a->tile[idx] = graphics_get_random( 70, 101 ); */
          a->tile[idx] = RETROANI_FIRE_HEAT_INIT +
-            retroflat_get_rand() % RETROANI_FIRE_HEAT_RANGE;
+            mrand_range( RETROANI_RAND, RETROANI_FIRE_HEAT_RANGE );
          assert( 0 < a->tile[idx] );
       }
 
       a->flags |= RETROANI_FLAG_INIT;
    }
 
+   /* Each row only reads from the row below it, so update a whole row at a
+    * time without branches.
+    */
    for( y = 0 ; RETROANI_TILE_H - 1 > y ; y++ ) {
-      /* debug_printf( 3, "%d, %d: %d", 0, y, data[(y * a->w)] ); */
-      for( x = 0 ; RETROANI_TILE_W > x ; x++ ) {
-         idx = (y * RETROANI_TILE_W) + x;
+      row = &(a->tile[y * RETROANI_TILE_W]);
 
-         /* Make sure we don't overflow the buffer. */
-         /* next_x = x + graphics_get_random( -1, 3 ); */
-         next_x = (x - 1) + retroflat_get_rand() % 3;
-         if( 0 > next_x ) {
-            next_x = RETROANI_TILE_W - 1;
-         } else if( RETROANI_TILE_W <= next_x ) {
-            next_x = 0;
-         }
+      memcpy( &(src_row[1]), row + RETROANI_TILE_W, RETROANI_TILE_W );
+      src_row[0] = src_row[RETROANI_TILE_W];
+      src_row[RETROANI_TILE_W + 1] = src_row[1];
 
-         next_idx = ((y + 1) * RETROANI_TILE_W) + next_x;
+      /* Scale random bytes into ranges by multiplying and shifting, which
+       * is cheaper and less biased than modulo.
+       */
+      mrand_fill( RETROANI_RAND, rnd, sizeof( rnd ) );
 
-         /* Make sure integers don't rollover. */
-         if( RETROANI_FIRE_COOLING_MAX + 3 >= a->tile[next_idx] ) {
-            if( -1 == a->tile[idx] ) {
-               /* Presume hiding was done. */
-               a->tile[idx] = 0;
+      for( x = 0 ; RETROANI_TILE_W > x ; x++ ) {
+         /* Pick the heat source below and one cell left, center, or right. */
+         heat = src_row[x + ((rnd[x] * 3) >> 8)];
 
-            } else if( 0 != a->tile[idx] ) {
-               /* Hide previous pixel. */
-               a->tile[idx] = -1;
-            }
-         } else {
-            /* Propagate heat. */
-            /* a->tile[idx] = a->tile[next_idx] - graphics_get_random(
-               RETROANI_FIRE_COOLING_MIN, RETROANI_FIRE_COOLING_MAX ); */
-            a->tile[idx] = (a->tile[next_idx] - RETROANI_FIRE_COOLING_MIN) +
-               (retroflat_get_rand() % RETROANI_FIRE_COOLING_MAX);
-         }
+         /* Mask of all ones if the source is hot enough to propagate. */
+         hot = -(RETROANI_FIRE_COOLING_MAX + 3 < heat);
+
+         /* Propagate heat. */
+         heat = (heat - RETROANI_FIRE_COOLING_MIN) +
+            ((rnd[RETROANI_TILE_W + x] * RETROANI_FIRE_COOLING_MAX) >> 8);
+
+         /* Otherwise, hide the previous pixel (-1) or presume hiding was
+          * done (0).
+          */
+         row[x] = (int8_t)((heat & hot) | (-(0 < row[x]) & ~hot));
       }
    }
 
@@ -325,6 +382,10 @@ void retroani_draw_SNOW( struct RETROANI* a ) {
       y = 0,
       idx = 0,
       new_idx = 0;
+   int8_t* row = NULL;
+   int8_t flake = 0;
+   uint8_t rnd[RETROANI_TILE_W];
+   uint32_t drift = 0;
 
    if( !(a->flags & RETROANI_FLAG_INIT) ) {
       /* Create initial snowflakes along the left side of the tile. */
@@ -337,33 +398,39 @@ void retroani_draw_SNOW( struct RETROANI* a ) {
    }
  
    for( y = RETROANI_TILE_H - 1 ; 0 <= y ; y-- ) {
-      for( x = RETROANI_TILE_W - 1 ; 0 <= x ; x-- ) {
-         idx = (y * RETROANI_TILE_W) + x;
-
-         if( -1 == a->tile[idx] ) {
-            /* Presume hiding was done. */
-            a->tile[idx] = 0;
+      row = &(a->tile[y * RETROANI_TILE_W]);
+      mrand_fill( RETROANI_RAND, rnd, sizeof( rnd ) );
 
-         } else if( 0 < a->tile[idx] ) {
-            /* Hide the snowflake's previous position. */
-            a->tile[idx] = -1;
-
-            do {
-               /* Move the snowflake down and maybe to the right. */
-               /* = idx + RETROANI_TILE_W + graphics_get_random( 0, 3 ); */
-               new_idx = idx + RETROANI_TILE_W + (retroflat_get_rand() % 3);
+      for( x = RETROANI_TILE_W - 1 ; 0 <= x ; x-- ) {
+         /* Hide the snowflake's previous position (-1), or presume hiding
+          * was done (0).
+          */
+         flake = 0 < row[x];
+         row[x] = -flake;
+         if( !flake ) {
+            continue;
+         }
 
-                  /* Wrap the snowflake if it moves off-tile. */
-               if( new_idx >= RETROANI_TILE_SZ ) {
-                  new_idx -= RETROANI_TILE_SZ;
-               }
+         idx = (y * RETROANI_TILE_W) + x;
+         drift = rnd[x];
+         for(;;) {
+            /* Move the snowflake down and maybe to the right. */
+            new_idx = idx + RETROANI_TILE_W + (drift % 3);
+
+            /* Wrap the snowflake if it moves off-tile. */
+            if( new_idx >= RETROANI_TILE_SZ ) {
+               new_idx -= RETROANI_TILE_SZ;
+            }
 
             /* Don't let snowflakes merge over time. */
-            } while( a->tile[new_idx] );
-            
-            /* Show the snowflake at its new position. */
-            a->tile[new_idx] = 1;
+            if( 0 == a->tile[new_idx] ) {
+               break;
+            }
+            drift = mrand_next( RETROANI_RAND );
          }
+
+         /* Show the snowflake at its new position. */
+         a->tile[new_idx] = 1;
       }
    }
 
@@ -379,8 +446,9 @@ void retroani_draw_CLOUDS( struct RETROANI* a ) {
    int16_t
       x = 0,
       y = 0,
-      idx = 0,
-      prev_idx = 0;
+      idx = 0;
+   int8_t* row = NULL;
+   uint8_t rnd[RETROANI_TILE_H];
 
    if( !(a->flags & RETROANI_FLAG_INIT) ) {
       /* Create initial cloud lines along the left side of the tile. */
@@ -389,7 +457,7 @@ void retroani_draw_CLOUDS( struct RETROANI* a ) {
          /* Get new non-repeating offset for each row. */
          do {
             /* = graphics_get_random( 0, RETROANI_TILE_W / 4 ); */
-            row_start_idx = retroflat_get_rand() % (RETROANI_TILE_W / 4 );
+            row_start_idx = mrand_range( RETROANI_RAND, RETROANI_TILE_W / 4 );
          } while( row_start_idx == row_start_last );
 
          /* Draw the row's initial state. */
@@ -481,55 +549,41 @@ void retroani_draw_CLOUDS( struct RETROANI* a ) {
    }
 #endif
 
-   for( y = RETROANI_TILE_H - 1 ; 0 <= y ; y-- ) {
+   if(
+      RETROANI_FLAG_CLOUDS_ROTATE ==
+      (RETROANI_FLAG_CLOUDS_ROTATE & a->flags)
+   ) {
+      /* Advance every row down by one. */
+      for( y = RETROANI_TILE_H - 1 ; 0 < y ; y-- ) {
+         memcpy( &(a->tile[y * RETROANI_TILE_W]),
+            &(a->tile[(y - 1) * RETROANI_TILE_W]), RETROANI_TILE_W );
+      }
+
+      /* Wrap-around. */
+      memcpy( &(a->tile[0]),
+         &(a->tile[(RETROANI_TILE_H - 1) * RETROANI_TILE_W]),
+         RETROANI_TILE_W );
+
+   } else {
+      mrand_fill( RETROANI_RAND, rnd, sizeof( rnd ) );
 
-      /* TODO: Adapt this for rotated orientation... somewhat more complicated.
+      /* TODO: Adapt this for rotated orientation... somewhat more
+       *       complicated.
        */
-      if(
-         RETROANI_FLAG_CLOUDS_ROTATE !=
-         (RETROANI_FLAG_CLOUDS_ROTATE & a->flags)
-      ) {
+      for( y = RETROANI_TILE_H - 1 ; 0 <= y ; y-- ) {
          /* Do we advance this wisp on this iteration? Not always. */
          prev_row_col_offset = row_col_offset;
          /* row_col_offset = graphics_get_random( 0, 70 ); */
-         row_col_offset = retroflat_get_rand() % 70;
+         row_col_offset = (rnd[y] * 70) >> 8;
          if( 45 > row_col_offset || 45 > prev_row_col_offset ) {
             continue;
          }
-      }
 
-      /* Iterate each row. */
-      for( x = RETROANI_TILE_W - 1 ; 0 <= x ; x-- ) {
-
-         idx = (y * RETROANI_TILE_W) + x;
-         if(
-            RETROANI_FLAG_CLOUDS_ROTATE ==
-            (RETROANI_FLAG_CLOUDS_ROTATE & a->flags)
-         ) {
-            row_col_end_buffer = 
-               /* Grab the pixel in this column off the bottom. */
-               a->tile[((RETROANI_TILE_H - 1) * RETROANI_TILE_W) + x];
-            prev_idx = idx - RETROANI_TILE_W;
-         } else {
-            row_col_end_buffer =
-               /* Grab the pixel in this row off the right. */
-               a->tile[(y * RETROANI_TILE_W) + (RETROANI_TILE_W - 1)];
-            prev_idx = idx - 1;
-         }
-
-         if( 
-            (RETROANI_FLAG_CLOUDS_ROTATE ==
-               (RETROANI_FLAG_CLOUDS_ROTATE & a->flags) && 0 == y) ||
-            (RETROANI_FLAG_CLOUDS_ROTATE !=
-               (RETROANI_FLAG_CLOUDS_ROTATE & a->flags) && 0 == x)
-         ) {
-            /* Wrap-around. */
-            a->tile[idx] = row_col_end_buffer;
-
-         } else {
-            /* Cloud advance. */
-            a->tile[idx] = a->tile[prev_idx];
-         }
+         /* Cloud advance, wrapping the pixel off the right around. */
+         row = &(a->tile[y * RETROANI_TILE_W]);
+         row_col_end_buffer = row[RETROANI_TILE_W - 2];
+         memmove( row + 1, row, RETROANI_TILE_W - 1 );
+         row[0] = row_col_end_buffer;
       }
    }
 
@@ -601,6 +655,66 @@ void retroani_set_string(
 }
 #endif
 
+#ifndef RETROFLAT_OPENGL
+
+/**
+ * \brief Draw the non-black runs of a rendered tile onto RETROANI::tile_bmp,
+ *        creating it if needed.
+ * \return Number of runs drawn, or 0 if the bitmap could not be created and
+ *         every run should be drawn directly.
+ */
+static size_t retroani_tile_bmp_draw(
+   struct RETROANI* a, struct RETROANI_RUN* runs, size_t runs_sz
+) {
+   MERROR_RETVAL retval = MERROR_OK;
+   size_t i = 0,
+      drawn = 0;
+
+   if( RETROANI_FLAG_TILE_BMP != (RETROANI_FLAG_TILE_BMP & a->flags) ) {
+      retval = retroflat_create_bitmap( RETROANI_TILE_BUF_W,
+         RETROANI_TILE_BUF_H, &(a->tile_bmp), 0 );
+      if( MERROR_OK != retval ) {
+         error_printf( "could not create animation tile bitmap!" );
+         return 0;
+      }
+      a->flags |= RETROANI_FLAG_TILE_BMP;
+   }
+
+   /* Normally draw lock is called from the main loop, but we're drawing on
+    * an off-screen bitmap, here!
+    */
+   retroflat_draw_lock( &(a->tile_bmp) );
+
+   /* Black is transparent on this bitmap, so this clears the last frame. */
+   retroflat_rect( &(a->tile_bmp), RETROFLAT_COLOR_BLACK, 0, 0,
+      RETROANI_TILE_BUF_W, RETROANI_TILE_BUF_H, RETROFLAT_FLAGS_FILL );
+
+   for( i = 0 ; runs_sz > i ; i++ ) {
+      if( RETROFLAT_COLOR_BLACK == runs[i].color ) {
+         continue;
+      }
+      retroflat_rect( &(a->tile_bmp), runs[i].color,
+         runs[i].x + 1, runs[i].y + 1, runs[i].w, 1, RETROFLAT_FLAGS_FILL );
+      drawn++;
+   }
+
+   retroflat_draw_release( &(a->tile_bmp) );
+
+   return drawn;
+}
+
+/**
+ * \brief Destroy RETROANI::tile_bmp, if it has been created.
+ */
+static void retroani_tile_bmp_free( struct RETROANI* a ) {
+   if( RETROANI_FLAG_TILE_BMP == (RETROANI_FLAG_TILE_BMP & a->flags) ) {
+      retroflat_destroy_bitmap( &(a->tile_bmp) );
+      a->flags &= ~RETROANI_FLAG_TILE_BMP;
+   }
+}
+
+#endif /* !RETROFLAT_OPENGL */
+
 int8_t retroani_create(
    struct RETROANI* ani_stack, size_t ani_stack_sz,
    uint8_t type, uint16_t flags, int16_t x, int16_t y, int16_t w, int16_t h
@@ -620,6 +734,11 @@ int8_t retroani_create(
       goto cleanup;
    }
 
+#ifndef RETROFLAT_OPENGL
+   /* This slot may have been used by an animation that stopped itself. */
+   retroani_tile_bmp_free( &(ani_stack[i]) );
+#endif /* !RETROFLAT_OPENGL */
+
    ani_stack[i].flags = RETROANI_FLAG_ACTIVE | flags;
    ani_stack[i].x = x;
    ani_stack[i].y = y;
@@ -635,71 +754,152 @@ cleanup:
    return idx_out;
 }
 
-void retroani_tesselate( struct RETROANI* a, int16_t y_orig ) {
+/**
+ * \brief Render the animation tile as it would appear on screen, border
+ *        included, and split it into runs of color.
+ * \return Number of runs written to runs.
+ */
+static size_t retroani_tile_runs(
+   struct RETROANI* a, RETROFLAT_COLOR* tile_px, struct RETROANI_RUN* runs
+) {
    int8_t
       /* Address of the current pixel rel to top-left corner of tile. */
       x = 0,
-      y = 0;
+      y = 0,
+      run_start = 0;
+   int16_t idx = 0;
+   size_t runs_sz = 0;
+   RETROFLAT_COLOR color = RETROFLAT_COLOR_NULL;
+
+   #define retroani_tile_px( x, y ) \
+      tile_px[(((y) + 1) * RETROANI_TILE_BUF_W) + (x) + 1]
+
+   for( idx = 0 ; RETROANI_TILE_BUF_SZ > idx ; idx++ ) {
+      tile_px[idx] = RETROFLAT_COLOR_NULL;
+   }
+
+   /* Iterate over every pixel of the animation grid, in the same order the
+    * pixels would be drawn so overlapping outlines come out the same.
+    */
+   for( y = 0 ; RETROANI_TILE_H > y ; y++ ) {
+      for( x = 0 ; RETROANI_TILE_W > x ; x++ ) {
+         idx = (y * RETROANI_TILE_W) + x;
+
+         if(
+            -1 == a->tile[idx] &&
+            RETROANI_FLAG_CLEANUP == (RETROANI_FLAG_CLEANUP & a->flags)
+         ) {
+            retroani_tile_px( x, y ) = RETROFLAT_COLOR_BLACK;
+
+         } else if( 0 < a->tile[idx] && RETROANI_TYPE_SNOW == a->type ) {
+            retroani_tile_px( x, y ) = RETROFLAT_COLOR_WHITE;
+#ifndef NO_SNOW_OUTLINE
+            retroani_tile_px( x - 1, y ) = RETROFLAT_COLOR_BLACK;
+            retroani_tile_px( x + 1, y ) = RETROFLAT_COLOR_BLACK;
+            retroani_tile_px( x, y - 1 ) = RETROFLAT_COLOR_BLACK;
+            retroani_tile_px( x, y + 1 ) = RETROFLAT_COLOR_BLACK;
+#endif /* !NO_SNOW_OUTLINE */
+
+         } else if( 90 < a->tile[idx] ) {
+            retroani_tile_px( x, y ) = RETROANI_TEMP_HIGH();
+         } else if( 60 < a->tile[idx] ) {
+            retroani_tile_px( x, y ) = RETROANI_TEMP_MED();
+         } else if( 30 < a->tile[idx] ) {
+            retroani_tile_px( x, y ) = RETROANI_TEMP_LOW();
+         }
+      }
+   }
+
+   /* Split each row of the rendered tile into runs of the same color. */
+   for( y = -1 ; RETROANI_TILE_H + 1 > y ; y++ ) {
+      x = -1;
+      while( RETROANI_TILE_W + 1 > x ) {
+         color = retroani_tile_px( x, y );
+         if( RETROFLAT_COLOR_NULL == color ) {
+            x++;
+            continue;
+         }
+         run_start = x;
+         while( RETROANI_TILE_W + 1 > x && color == retroani_tile_px( x, y ) ) {
+            x++;
+         }
+         runs[runs_sz].x = run_start;
+         runs[runs_sz].y = y;
+         runs[runs_sz].w = x - run_start;
+         runs[runs_sz].color = color;
+         runs_sz++;
+      }
+   }
+
+   return runs_sz;
+}
+
+void retroani_tesselate( struct RETROANI* a, int16_t y_orig ) {
+   RETROFLAT_COLOR tile_px[RETROANI_TILE_BUF_SZ];
+   struct RETROANI_RUN runs[RETROANI_TILE_BUF_SZ];
+   struct RETROFLAT_BITMAP* target = a->target;
+   size_t runs_sz = 0,
+      i = 0;
+   uint8_t blit = 0;
    int16_t
-      idx = 0,
       /* Address of the current tile's top-left corner rel to animation. */
       t_x = 0,
       t_y = 0,
-      /* Address of the current pixel rel to screen. */
+      /* Address of the current run rel to screen. */
       p_x = 0,
-      p_y = 0;
+      p_y = 0,
+      p_w = 0;
+
+   if( NULL == target ) {
+      target = retroflat_screen_buffer();
+   }
+
+   runs_sz = retroani_tile_runs( a, tile_px, runs );
 
-   /* Lock the target buffer for per-pixel manipulation. */
-   retroflat_px_lock( a->target );
+#ifndef RETROFLAT_OPENGL
+   blit = 0 < retroani_tile_bmp_draw( a, runs, runs_sz ) ? 1 : 0;
+#endif /* !RETROFLAT_OPENGL */
 
    /* Iterate over every tile covered by the animation's screen area. */
    for( t_y = y_orig ; a->h > t_y ; t_y += RETROANI_TILE_H ) {
       for( t_x = 0 ; a->w > t_x ; t_x += RETROANI_TILE_W ) {
-         /* Iterate over every pixel of the animation grid. */
-         for( y = 0 ; RETROANI_TILE_H > y ; y++ ) {
-            for( x = 0 ; RETROANI_TILE_W > x ; x++ ) {
-               idx = (y * RETROANI_TILE_W) + x;
+#ifndef RETROFLAT_OPENGL
+         if( blit ) {
+            /* The bitmap starts with the border, one pixel up and left. */
+            retroflat_blit_bitmap( target, &(a->tile_bmp), 0, 0,
+               a->x + t_x - 1, a->y + t_y - 1,
+               RETROANI_TILE_BUF_W, RETROANI_TILE_BUF_H,
+               RETROFLAT_INSTANCE_NULL );
+         }
+#endif /* !RETROFLAT_OPENGL */
 
-               /* TODO: Try to trim animation to its area. */
+         for( i = 0 ; runs_sz > i ; i++ ) {
 
-               p_x = a->x + t_x + x;
-               p_y = a->y + t_y + y;
+            /* TODO: Try to trim animation to its area. */
 
-               if(
-                  -1 == a->tile[idx] &&
-                  RETROANI_FLAG_CLEANUP == (RETROANI_FLAG_CLEANUP & a->flags)
-               ) {
-                  retroflat_px(
-                     a->target, RETROFLAT_COLOR_BLACK, p_x, p_y, 0 );
+            if( blit && RETROFLAT_COLOR_BLACK != runs[i].color ) {
+               /* Already drawn by the blit above. */
+               continue;
+            }
 
-               } else if( 0 < a->tile[idx] && RETROANI_TYPE_SNOW == a->type ) {
-                  retroflat_px(
-                     a->target, RETROFLAT_COLOR_WHITE, p_x, p_y, 0 );
-#ifndef NO_SNOW_OUTLINE
-                  retroflat_px(
-                     a->target, RETROFLAT_COLOR_BLACK, p_x - 1, p_y, 0 );
-                  retroflat_px(
-                     a->target, RETROFLAT_COLOR_BLACK, p_x + 1, p_y, 0 );
-                  retroflat_px(
-                     a->target, RETROFLAT_COLOR_BLACK, p_x, p_y - 1, 0 );
-                  retroflat_px(
-                     a->target, RETROFLAT_COLOR_BLACK, p_x, p_y + 1, 0 );
-#endif /* !NO_SNOW_OUTLINE */
+            p_x = a->x + t_x + runs[i].x;
+            p_y = a->y + t_y + runs[i].y;
+            p_w = runs[i].w;
 
-               } else if( 90 < a->tile[idx] ) {
-                  retroflat_px(
-                     a->target, RETROANI_TEMP_HIGH(), p_x, p_y, 0 );
-               } else if( 60 < a->tile[idx] ) {
-                  retroflat_px( a->target, RETROANI_TEMP_MED(), p_x, p_y, 0 );
-               } else if( 30 < a->tile[idx] ) {
-                  retroflat_px( a->target, RETROANI_TEMP_LOW(), p_x, p_y, 0 );
-               }
+            /* Trim off the screen edge, like retroflat_px() would. */
+            if( 0 > p_x ) {
+               p_w += p_x;
+               p_x = 0;
+            }
+            if( 0 > p_y || 0 >= p_w ) {
+               continue;
             }
+
+            retroflat_rect(
+               target, runs[i].color, p_x, p_y, p_w, 1, RETROFLAT_FLAGS_FILL );
          }
       }
    }
-
-   retroflat_px_release( a->target );
 }
 
 void retroani_frame(
@@ -753,6 +953,9 @@ void retroani_resume(
 void retroani_stop(
    struct RETROANI* ani_stack, size_t ani_stack_sz, int8_t idx
 ) {
+#ifndef RETROFLAT_OPENGL
+   retroani_tile_bmp_free( &(ani_stack[idx]) );
+#endif /* !RETROFLAT_OPENGL */
    maug_mzero( &(ani_stack[idx]), sizeof( struct RETROANI ) );
 }
 
@@ -0,0 +1,312 @@
+
+#ifndef RETROBLT_H
+#define RETROBLT_H
+
+/**
+ * \addtogroup maug_retroblt RetroFlat Indexed Blitter
+ * \brief Portable blitter for 8-bit palette-indexed bitmaps with a
+ *        transparent color.
+ *
+ * Bitmaps are scanned once with retroblt_runs_build() into a list of the
+ * opaque runs in each row. retroblt_blit() then copies each opaque run
+ * with a single memcpy() and skips transparent runs entirely, so blits cost
+ * roughly the opaque area of a sprite rather than its total area. Clipping
+ * is done once per blit, not per pixel.
+ *
+ * Pixels are one byte per index, stored row by row with a pitch equal to
+ * the width. This header does not depend on RetroFlat, so platforms with
+ * indexed framebuffers can use it directly. Define RETROBLT_C in one file
+ * to build it.
+ * \{
+ * \file retroblt.h
+ */
+
+#if defined( MAUG_OS_DOS_REAL ) || defined( MAUG_API_WIN16 )
+#  define retroblt_memcpy( dest, src, sz ) _fmemcpy( dest, src, sz )
+#  define retroblt_memset( dest, c, sz ) _fmemset( dest, c, sz )
+#else
+/*! \brief memcpy() that can handle SEG_FAR pointers. */
+#  define retroblt_memcpy( dest, src, sz ) memcpy( dest, src, sz )
+/*! \brief memset() that can handle SEG_FAR pointers. */
+#  define retroblt_memset( dest, c, sz ) memset( dest, c, sz )
+#endif /* MAUG_OS_DOS_REAL || MAUG_API_WIN16 */
+
+#ifndef RETROBLT_TRACE_LVL
+#  define RETROBLT_TRACE_LVL 0
+#endif /* !RETROBLT_TRACE_LVL */
+
+/**
+ * \brief Lists of the opaque runs in each row of an indexed bitmap.
+ */
+struct RETROBLT_RUNS {
+   /**
+    * \brief Index in spans_h of the first run of each row, plus an extra
+    *        entry with the total number of runs.
+    */
+   MAUG_MHANDLE rows_h;
+   /*! \brief Pairs of start column and length of each opaque run. */
+   MAUG_MHANDLE spans_h;
+   /*! \brief Number of rows in rows_h, not counting the extra entry. */
+   size_t rows_sz;
+   /*! \brief Number of runs in spans_h. */
+   size_t spans_sz;
+};
+
+/**
+ * \brief Find the opaque runs in an indexed bitmap, replacing any previously
+ *        built into runs.
+ * \param txp Palette index that is transparent.
+ */
+MERROR_RETVAL retroblt_runs_build(
+   struct RETROBLT_RUNS* runs, const uint8_t SEG_FAR* px,
+   size_t w, size_t h, uint8_t txp );
+
+/**
+ * \brief Free the lists built by retroblt_runs_build().
+ */
+void retroblt_runs_free( struct RETROBLT_RUNS* runs );
+
+/**
+ * \brief Blit an area of an indexed bitmap onto another.
+ *
+ * The area is clipped to both bitmaps, and may start off the edge of dest.
+ *
+ * \param runs Opaque runs of src, or NULL to copy the area as-is.
+ */
+MERROR_RETVAL retroblt_blit(
+   uint8_t SEG_FAR* dest, size_t dest_w, size_t dest_h,
+   const uint8_t SEG_FAR* src, size_t src_w, size_t src_h,
+   struct RETROBLT_RUNS* runs,
+   size_t s_x, size_t s_y, int16_t d_x, int16_t d_y, size_t w, size_t h );
+
+#ifdef RETROBLT_C
+
+MERROR_RETVAL retroblt_runs_build(
+   struct RETROBLT_RUNS* runs, const uint8_t SEG_FAR* px,
+   size_t w, size_t h, uint8_t txp
+) {
+   MERROR_RETVAL retval = MERROR_OK;
+   uint32_t* rows = NULL;
+   uint16_t* spans = NULL;
+   size_t x = 0,
+      y = 0,
+      x_start = 0,
+      spans_sz = 0;
+   const uint8_t SEG_FAR* row = NULL;
+
+   retroblt_runs_free( runs );
+
+   /* Count the runs first, so they can be allocated all at once. */
+   for( y = 0 ; h > y ; y++ ) {
+      row = &(px[y * w]);
+      for( x = 0 ; w > x ; x++ ) {
+         if( txp != row[x] && (0 == x || txp == row[x - 1]) ) {
+            spans_sz++;
+         }
+      }
+   }
+
+   debug_printf( RETROBLT_TRACE_LVL,
+      "found " SIZE_T_FMT " opaque runs in " SIZE_T_FMT "x" SIZE_T_FMT
+      " bitmap", spans_sz, w, h );
+
+   runs->rows_h = maug_malloc( (h + 1), sizeof( uint32_t ) );
+   maug_cleanup_if_null_alloc( MAUG_MHANDLE, runs->rows_h );
+   runs->rows_sz = h;
+
+   if( 0 < spans_sz ) {
+      runs->spans_h = maug_malloc( spans_sz, (2 * sizeof( uint16_t )) );
+      maug_cleanup_if_null_alloc( MAUG_MHANDLE, runs->spans_h );
+      runs->spans_sz = spans_sz;
+      maug_mlock( runs->spans_h, spans );
+      maug_cleanup_if_null_lock( uint16_t*, spans );
+   }
+
+   maug_mlock( runs->rows_h, rows );
+   maug_cleanup_if_null_lock( uint32_t*, rows );
+
+   spans_sz = 0;
+   for( y = 0 ; h > y ; y++ ) {
+      rows[y] = spans_sz;
+      row = &(px[y * w]);
+      x = 0;
+      while( w > x ) {
+         /* Skip the transparent run. */
+         while( w > x && txp == row[x] ) {
+            x++;
+         }
+         if( w <= x ) {
+            break;
+         }
+
+         /* Measure the opaque run. */
+         x_start = x;
+         while( w > x && txp != row[x] ) {
+            x++;
+         }
+         assert( spans_sz < runs->spans_sz );
+         spans[spans_sz * 2] = x_start;
+         spans[(spans_sz * 2) + 1] = x - x_start;
+         spans_sz++;
+      }
+   }
+   rows[h] = spans_sz;
+
+cleanup:
+
+   if( NULL != rows ) {
+      maug_munlock( runs->rows_h, rows );
+   }
+
+   if( NULL != spans ) {
+      maug_munlock( runs->spans_h, spans );
+   }
+
+   if( MERROR_OK != retval ) {
+      retroblt_runs_free( runs );
+   }
+
+   return retval;
+}
+
+/* === */
+
+void retroblt_runs_free( struct RETROBLT_RUNS* runs ) {
+   if( (MAUG_MHANDLE)NULL != runs->rows_h ) {
+      maug_mfree( runs->rows_h );
+   }
+   if( (MAUG_MHANDLE)NULL != runs->spans_h ) {
+      maug_mfree( runs->spans_h );
+   }
+   maug_mzero( runs, sizeof( struct RETROBLT_RUNS ) );
+}
+
+/* === */
+
+MERROR_RETVAL retroblt_blit(
+   uint8_t SEG_FAR* dest, size_t dest_w, size_t dest_h,
+   const uint8_t SEG_FAR* src, size_t src_w, size_t src_h,
+   struct RETROBLT_RUNS* runs,
+   size_t s_x, size_t s_y, int16_t d_x, int16_t d_y, size_t w, size_t h
+) {
+   MERROR_RETVAL retval = MERROR_OK;
+   uint32_t* rows = NULL;
+   uint16_t* spans = NULL;
+   size_t y = 0,
+      i = 0,
+      run_x1 = 0,
+      run_x2 = 0,
+      s_x2 = 0;
+   uint8_t SEG_FAR* dest_row = NULL;
+   const uint8_t SEG_FAR* src_row = NULL;
+
+   /* Clip the area to the edges of dest... */
+   if( 0 > d_x ) {
+      if( w <= (size_t)-d_x ) {
+         goto cleanup;
+      }
+      s_x += -d_x;
+      w -= -d_x;
+      d_x = 0;
+   }
+   if( 0 > d_y ) {
+      if( h <= (size_t)-d_y ) {
+         goto cleanup;
+      }
+      s_y += -d_y;
+      h -= -d_y;
+      d_y = 0;
+   }
+   if( dest_w <= (size_t)d_x || dest_h <= (size_t)d_y ) {
+      goto cleanup;
+   }
+   if( dest_w - d_x < w ) {
+      w = dest_w - d_x;
+   }
+   if( dest_h - d_y < h ) {
+      h = dest_h - d_y;
+   }
+
+   /* ...and then to the edges of src. */
+   if( src_w <= s_x || src_h <= s_y ) {
+      goto cleanup;
+   }
+   if( src_w - s_x < w ) {
+      w = src_w - s_x;
+   }
+   if( src_h - s_y < h ) {
+      h = src_h - s_y;
+   }
+
+   dest_row = &(dest[(d_y * dest_w) + d_x]);
+   src_row = &(src[(s_y * src_w) + s_x]);
+
+   if( NULL == runs || (MAUG_MHANDLE)NULL == runs->rows_h ) {
+      /* Opaque, so copy whole rows. */
+      for( y = 0 ; h > y ; y++ ) {
+         retroblt_memcpy( dest_row, src_row, w );
+         dest_row += dest_w;
+         src_row += src_w;
+      }
+      goto cleanup;
+   }
+
+   assert( runs->rows_sz == src_h );
+
+   if( 0 == runs->spans_sz ) {
+      /* Nothing is opaque! */
+      goto cleanup;
+   }
+
+   maug_mlock( runs->rows_h, rows );
+   maug_cleanup_if_null_lock( uint32_t*, rows );
+   maug_mlock( runs->spans_h, spans );
+   maug_cleanup_if_null_lock( uint16_t*, spans );
+
+   s_x2 = s_x + w;
+   for( y = 0 ; h > y ; y++ ) {
+      for( i = rows[s_y + y] ; rows[s_y + y + 1] > i ; i++ ) {
+         run_x1 = spans[i * 2];
+         run_x2 = run_x1 + spans[(i * 2) + 1];
+
+         /* Runs are in order, so stop at the first one past the area. */
+         if( s_x2 <= run_x1 ) {
+            break;
+         } else if( s_x >= run_x2 ) {
+            continue;
+         }
+
+         if( s_x > run_x1 ) {
+            run_x1 = s_x;
+         }
+         if( s_x2 < run_x2 ) {
+            run_x2 = s_x2;
+         }
+
+         retroblt_memcpy(
+            &(dest_row[run_x1 - s_x]), &(src_row[run_x1 - s_x]),
+            run_x2 - run_x1 );
+      }
+      dest_row += dest_w;
+      src_row += src_w;
+   }
+
+cleanup:
+
+   if( NULL != spans ) {
+      maug_munlock( runs->spans_h, spans );
+   }
+
+   if( NULL != rows ) {
+      maug_munlock( runs->rows_h, rows );
+   }
+
+   return retval;
+}
+
+#endif /* RETROBLT_C */
+
+/*! \} */ /* maug_retroblt */
+
+#endif /* !RETROBLT_H */
+
@@ -19,8 +19,83 @@
 #  define RETROFLAT_CONFIG_EXT ".ini"
 #endif /* !RETROFLAT_CONFIG_EXT */
 
+#ifndef RETROFLAT_CONFIG_SNAP_EXT
+/**
+ * \brief Extension appended to the config path to get the path of its
+ *        \ref maug_retroflt_config_snap.
+ */
+#  define RETROFLAT_CONFIG_SNAP_EXT ".rcs"
+#endif /* !RETROFLAT_CONFIG_SNAP_EXT */
+
+#ifndef RETROFLAT_CONFIG_TRACE_LVL
+#  define RETROFLAT_CONFIG_TRACE_LVL 0
+#endif /* !RETROFLAT_CONFIG_TRACE_LVL */
+
 #  ifdef RETROFLAT_CONFIG_USE_FILE
-typedef mfile_t RETROFLAT_CONFIG;
+
+/**
+ * \addtogroup maug_retroflt_config_snap RetroFlat Config Snapshots
+ * \brief Compiled binary copies of parsed config files.
+ *
+ * retroflat_config_open() parses the config file once into a table of
+ * ::RETROFLAT_CONFIG_SLOT hashed by section and key, so
+ * retroflat_config_read() can look keys up without rereading the file. The
+ * table is written next to the config file with ::RETROFLAT_CONFIG_SNAP_EXT
+ * appended, and later opens load it directly as long as the config file still
+ * matches the size and hash stored in it. Define RETROFLAT_CONFIG_NO_SNAP to
+ * keep the table in memory only.
+ *
+ * A snapshot is a ::RETROFLAT_CONFIG_SNAP_HEADER, followed by slots_sz slots
+ * and then strs_sz bytes of NULL-terminated strings the slots point into.
+ * Like mesh caches, snapshots are stored in native byte order.
+ * \{
+ */
+
+#define RETROFLAT_CONFIG_SNAP_VERSION 1
+
+struct RETROFLAT_CONFIG_SNAP_HEADER {
+   /*! \brief Always "RCFG". */
+   char magic[4];
+   uint16_t version;
+   uint16_t header_sz;
+   /*! \brief Size of the config file in bytes. */
+   uint32_t src_sz;
+   /*! \brief mdata_hash() of the config file. */
+   uint32_t src_hash;
+   /*! \brief Number of slots in the table. Always a power of two. */
+   uint32_t slots_sz;
+   uint32_t strs_sz;
+   /*! \brief mdata_hash() of the slots and strings, to catch corruption. */
+   uint32_t checksum;
+};
+
+struct RETROFLAT_CONFIG_SLOT {
+   /*! \brief Hash of the section and key names. */
+   uint32_t hash;
+   /*! \brief Offset of the section name in the strings. */
+   uint32_t sect;
+   /*! \brief Offset of the key name in the strings, or 0 if slot is empty. */
+   uint32_t key;
+   /*! \brief Offset of the value in the strings. */
+   uint32_t val;
+};
+
+#define retroflat_config_snap_slots( header ) \
+   ((struct RETROFLAT_CONFIG_SLOT*)&((header)[1]))
+
+#define retroflat_config_snap_strs( header ) \
+   ((char*)&(retroflat_config_snap_slots( header )[(header)->slots_sz]))
+
+struct RETROFLAT_CONFIG_FILE {
+   /*! \brief Snapshot header, slots, and strings in one block. */
+   MAUG_MHANDLE snap_h;
+   /*! \brief Size of the snapshot in snap_h, not counting unused strings. */
+   size_t snap_sz;
+};
+
+/*! \} */ /* maug_retroflt_config_snap */
+
+typedef struct RETROFLAT_CONFIG_FILE RETROFLAT_CONFIG;
 #  elif defined( RETROFLAT_API_WIN32 )
 typedef HKEY RETROFLAT_CONFIG;
 #  else
@@ -157,19 +232,492 @@ MERROR_RETVAL retroflat_config_init( struct RETROFLAT_ARGS* args ) {
 
 /* === */
 
+#ifdef RETROFLAT_CONFIG_USE_FILE
+
+/**
+ * \return Line with brackets stripped if it is a section, or NULL otherwise.
+ */
+static char* retroflat_config_tok_sect( char* line ) {
+   char* sect_end = NULL;
+
+   /* Section check. */
+   if( '[' == line[0] ) {
+      sect_end = maug_strchr( line, ']' );
+      if( NULL != sect_end ) {
+         sect_end[0] = '\0';
+      }
+      return line;
+   }
+
+   return NULL;
+}
+
+/* === */
+
+static uint32_t _retroflat_config_hash( const char* sect, const char* key ) {
+   uint32_t hash = MDATA_HASH_INIT;
+
+   /* Include the terminators, so "ab" "c" and "a" "bc" hash differently. */
+   hash = mdata_hash_cont( hash, sect, maug_strlen( sect ) + 1 );
+   hash = mdata_hash_cont( hash, key, maug_strlen( key ) + 1 );
+
+   return hash;
+}
+
+/* === */
+
+/**
+ * \return The slot holding the given section and key, an empty slot where
+ *         they would go, or NULL if the table is full.
+ */
+static struct RETROFLAT_CONFIG_SLOT* _retroflat_config_find(
+   struct RETROFLAT_CONFIG_SNAP_HEADER* header,
+   const char* sect, const char* key, uint32_t hash
+) {
+   struct RETROFLAT_CONFIG_SLOT* slots = retroflat_config_snap_slots( header );
+   char* strs = retroflat_config_snap_strs( header );
+   uint32_t i = 0,
+      probes = 0;
+
+   /* Probe linearly from the hash until the key or an empty slot. */
+   for(
+      i = hash & (header->slots_sz - 1) ;
+      header->slots_sz > probes ;
+      i = (i + 1) & (header->slots_sz - 1)
+   ) {
+      if(
+         0 == slots[i].key || (
+            hash == slots[i].hash &&
+            0 == strcmp( key, &(strs[slots[i].key]) ) &&
+            0 == strcmp( sect, &(strs[slots[i].sect]) ))
+      ) {
+         return &(slots[i]);
+      }
+      probes++;
+   }
+
+   return NULL;
+}
+
+/* === */
+
+/**
+ * \return Offset of the appended string, or 0 if there was no room for it.
+ */
+static uint32_t _retroflat_config_strs_append(
+   struct RETROFLAT_CONFIG_SNAP_HEADER* header, size_t strs_sz_max,
+   const char* str
+) {
+   uint32_t str_offset = header->strs_sz;
+   size_t str_sz = maug_strlen( str ) + 1;
+
+   if( strs_sz_max - header->strs_sz < str_sz ) {
+      error_printf( "no room in config strings for: %s", str );
+      return 0;
+   }
+
+   memcpy( &(retroflat_config_snap_strs( header )[str_offset]), str, str_sz );
+   header->strs_sz += str_sz;
+
+   return str_offset;
+}
+
+/* === */
+
+/**
+ * \brief Parse a config file into a new table in config->snap_h.
+ * \param lines_sz Number of lines in the config file, to size the table.
+ */
+static MERROR_RETVAL _retroflat_config_parse(
+   mfile_t* src, RETROFLAT_CONFIG* config,
+   uint32_t src_sz, uint32_t src_hash, size_t lines_sz
+) {
+   MERROR_RETVAL retval = MERROR_OK;
+   char line[RETROFLAT_CONFIG_LN_SZ_MAX + 1];
+   char* line_val = NULL;
+   size_t line_sz = 0,
+      slots_sz = 4,
+      strs_sz_max = 0;
+   uint32_t sect = 0,
+      hash = 0;
+   struct RETROFLAT_CONFIG_SNAP_HEADER* header = NULL;
+   struct RETROFLAT_CONFIG_SLOT* slot = NULL;
+
+   /* Keep the table at most half full, so probes stay short. */
+   while( slots_sz < lines_sz * 2 ) {
+      slots_sz *= 2;
+   }
+
+   /* Every string comes from the config file with its brackets, separator,
+    * or newline replaced by a terminator. Lines with no newline (the last
+    * line, or pieces of lines too long to read at once) need one more, and
+    * offset 0 is the empty string.
+    */
+   strs_sz_max = src_sz + (src_sz / (RETROFLAT_CONFIG_LN_SZ_MAX - 1)) + 2;
+
+   config->snap_h = maug_malloc( 1,
+      (sizeof( struct RETROFLAT_CONFIG_SNAP_HEADER ) +
+         (slots_sz * sizeof( struct RETROFLAT_CONFIG_SLOT )) + strs_sz_max) );
+   maug_cleanup_if_null_alloc( MAUG_MHANDLE, config->snap_h );
+
+   maug_mlock( config->snap_h, header );
+   maug_cleanup_if_null_lock( struct RETROFLAT_CONFIG_SNAP_HEADER*, header );
+
+   maug_mzero( header,
+      sizeof( struct RETROFLAT_CONFIG_SNAP_HEADER ) +
+      (slots_sz * sizeof( struct RETROFLAT_CONFIG_SLOT )) + strs_sz_max );
+   header->slots_sz = slots_sz;
+   /* Offset 0 is the empty string, for keys before the first section. */
+   header->strs_sz = 1;
+
+   while(
+      mfile_has_bytes( src ) &&
+      MERROR_OK == src->read_line( src, line, RETROFLAT_CONFIG_LN_SZ_MAX, 0 )
+   ) {
+      /* Size check. */
+      line_sz = maug_strlen( line );
+      if( 1 >= line_sz || RETROFLAT_CONFIG_LN_SZ_MAX <= line_sz ) {
+         debug_printf( RETROFLAT_CONFIG_TRACE_LVL,
+            "invalid line sz: " SIZE_T_FMT, line_sz );
+         continue;
+      }
+
+      /* Strip off trailing newline. */
+      if( '\n' == line[line_sz - 1] || '\r' == line[line_sz - 1] ) {
+         line_sz--;
+         line[line_sz] = '\0'; /* NULL goes after maug_strlen() finishes! */
+      }
+
+      /* Section check. */
+      if( retroflat_config_tok_sect( line ) ) {
+         sect = _retroflat_config_strs_append(
+            header, strs_sz_max, &(line[1]) );
+         if( 0 == sect ) {
+            retval = MERROR_OVERFLOW;
+            goto cleanup;
+         }
+         debug_printf( RETROFLAT_CONFIG_TRACE_LVL,
+            "found section: %s", &(line[1]) );
+         continue;
+      }
+
+      /* Split up key/value pair. */
+      line_val = maug_strchr( line, '=' );
+      if( NULL == line_val || line_val == line ) {
+         error_printf( "invalid line: %s", line );
+         continue;
+      }
+
+      /* Terminate key. */
+      line_val[0] = '\0';
+      line_val++;
+
+      hash = _retroflat_config_hash(
+         &(retroflat_config_snap_strs( header )[sect]), line );
+      slot = _retroflat_config_find( header,
+         &(retroflat_config_snap_strs( header )[sect]), line, hash );
+      if( NULL == slot ) {
+         error_printf( "config table full!" );
+         retval = MERROR_OVERFLOW;
+         goto cleanup;
+      } else if( 0 != slot->key ) {
+         /* Lookups used to stop at the first match, so keep that one. */
+         debug_printf( RETROFLAT_CONFIG_TRACE_LVL,
+            "ignoring duplicate key: %s", line );
+         continue;
+      }
+
+      slot->hash = hash;
+      slot->sect = sect;
+      slot->key = _retroflat_config_strs_append( header, strs_sz_max, line );
+      slot->val = _retroflat_config_strs_append(
+         header, strs_sz_max, line_val );
+      if( 0 == slot->key || 0 == slot->val ) {
+         retval = MERROR_OVERFLOW;
+         goto cleanup;
+      }
+
+      debug_printf( RETROFLAT_CONFIG_TRACE_LVL,
+         "found %s: %s", line, line_val );
+   }
+
+   header->magic[0] = 'R';
+   header->magic[1] = 'C';
+   header->magic[2] = 'F';
+   header->magic[3] = 'G';
+   header->version = RETROFLAT_CONFIG_SNAP_VERSION;
+   header->header_sz = sizeof( struct RETROFLAT_CONFIG_SNAP_HEADER );
+   header->src_sz = src_sz;
+   header->src_hash = src_hash;
+   header->checksum = mdata_hash( retroflat_config_snap_slots( header ),
+      (slots_sz * sizeof( struct RETROFLAT_CONFIG_SLOT )) + header->strs_sz );
+
+   config->snap_sz = sizeof( struct RETROFLAT_CONFIG_SNAP_HEADER ) +
+      (slots_sz * sizeof( struct RETROFLAT_CONFIG_SLOT )) + header->strs_sz;
+
+cleanup:
+
+   if( NULL != header ) {
+      maug_munlock( config->snap_h, header );
+   }
+
+   return retval;
+}
+
+/* === */
+
+#ifndef RETROFLAT_CONFIG_NO_SNAP
+
+static MERROR_RETVAL _retroflat_config_write_snap(
+   const char* snap_path, RETROFLAT_CONFIG* config
+) {
+   MERROR_RETVAL retval = MERROR_OK;
+   struct RETROFLAT_CONFIG_SNAP_HEADER* header = NULL;
+   FILE* snap_file = NULL;
+
+   maug_mlock( config->snap_h, header );
+   maug_cleanup_if_null_lock( struct RETROFLAT_CONFIG_SNAP_HEADER*, header );
+
+   snap_file = fopen( snap_path, "wb" );
+   maug_cleanup_if_null_file( snap_file );
+
+   if( 1 != fwrite( header, config->snap_sz, 1, snap_file ) ) {
+      error_printf( "could not write config snapshot!" );
+      retval = MERROR_FILE;
+      goto cleanup;
+   }
+
+   debug_printf( 1, "wrote config snapshot: %s", snap_path );
+
+cleanup:
+
+   if( NULL != snap_file ) {
+      fclose( snap_file );
+   }
+
+   if( NULL != header ) {
+      maug_munlock( config->snap_h, header );
+   }
+
+   return retval;
+}
+
+/* === */
+
+/**
+ * \return MERROR_OK if the snapshot was loaded, or MERROR_FILE if it is
+ *         missing, stale, corrupt, or was written by an incompatible build.
+ */
+static MERROR_RETVAL _retroflat_config_read_snap(
+   const char* snap_path, RETROFLAT_CONFIG* config,
+   uint32_t src_sz, uint32_t src_hash
+) {
+   MERROR_RETVAL retval = MERROR_OK;
+   struct RETROFLAT_CONFIG_SNAP_HEADER snap_header;
+   struct RETROFLAT_CONFIG_SNAP_HEADER* header = NULL;
+   struct RETROFLAT_CONFIG_SLOT* slots = NULL;
+   size_t body_sz = 0;
+   uint32_t i = 0;
+   mfile_t snap_file;
+
+   maug_mzero( &snap_file, sizeof( mfile_t ) );
+
+   retval = mfile_open_read( snap_path, &snap_file );
+   maug_cleanup_if_not_ok();
+
+   if(
+      sizeof( struct RETROFLAT_CONFIG_SNAP_HEADER ) >
+         (size_t)mfile_get_sz( &snap_file )
+   ) {
+      error_printf( "config snapshot too small!" );
+      retval = MERROR_FILE;
+      goto cleanup;
+   }
+
+   retval = snap_file.read_int( &snap_file, (uint8_t*)&snap_header,
+      sizeof( struct RETROFLAT_CONFIG_SNAP_HEADER ), MFILE_READ_FLAG_LSBF );
+   maug_cleanup_if_not_ok();
+
+   body_sz = mfile_get_sz( &snap_file ) -
+      sizeof( struct RETROFLAT_CONFIG_SNAP_HEADER );
+
+   if(
+      'R' != snap_header.magic[0] || 'C' != snap_header.magic[1] ||
+      'F' != snap_header.magic[2] || 'G' != snap_header.magic[3] ||
+      RETROFLAT_CONFIG_SNAP_VERSION != snap_header.version ||
+      sizeof( struct RETROFLAT_CONFIG_SNAP_HEADER ) != snap_header.header_sz ||
+      /* Slots must be a power of two and leave room for the strings. */
+      0 == snap_header.slots_sz ||
+      0 != (snap_header.slots_sz & (snap_header.slots_sz - 1)) ||
+      body_sz / sizeof( struct RETROFLAT_CONFIG_SLOT ) <
+         snap_header.slots_sz ||
+      0 == snap_header.strs_sz ||
+      body_sz - (snap_header.slots_sz * sizeof( struct RETROFLAT_CONFIG_SLOT ))
+         != snap_header.strs_sz
+   ) {
+      error_printf( "invalid config snapshot header!" );
+      retval = MERROR_FILE;
+      goto cleanup;
+   }
+
+   if( snap_header.src_sz != src_sz || snap_header.src_hash != src_hash ) {
+      debug_printf( 1, "config snapshot %s is stale!", snap_path );
+      retval = MERROR_FILE;
+      goto cleanup;
+   }
+
+   config->snap_h = maug_malloc( 1, mfile_get_sz( &snap_file ) );
+   maug_cleanup_if_null_alloc( MAUG_MHANDLE, config->snap_h );
+   config->snap_sz = mfile_get_sz( &snap_file );
+
+   maug_mlock( config->snap_h, header );
+   maug_cleanup_if_null_lock( struct RETROFLAT_CONFIG_SNAP_HEADER*, header );
+
+   memcpy( header, &snap_header, sizeof( struct RETROFLAT_CONFIG_SNAP_HEADER ) );
+   slots = retroflat_config_snap_slots( header );
+   retval = snap_file.read_int(
+      &snap_file, (uint8_t*)slots, body_sz, MFILE_READ_FLAG_LSBF );
+   maug_cleanup_if_not_ok();
+
+   if( header->checksum != mdata_hash( slots, body_sz ) ) {
+      error_printf( "config snapshot checksum mismatch!" );
+      retval = MERROR_FILE;
+      goto cleanup;
+   }
+
+   /* Make sure no string runs off the end, so lookups can trust offsets. */
+   if( '\0' != retroflat_config_snap_strs( header )[header->strs_sz - 1] ) {
+      error_printf( "config snapshot strings not terminated!" );
+      retval = MERROR_FILE;
+      goto cleanup;
+   }
+   for( i = 0 ; header->slots_sz > i ; i++ ) {
+      if(
+         header->strs_sz <= slots[i].sect ||
+         header->strs_sz <= slots[i].key ||
+         header->strs_sz <= slots[i].val
+      ) {
+         error_printf( "config snapshot slot " UPRINTF_U32_FMT " invalid!", i );
+         retval = MERROR_FILE;
+         goto cleanup;
+      }
+   }
+
+   debug_printf( 1, "loaded config snapshot %s: " UPRINTF_U32_FMT " slots",
+      snap_path, header->slots_sz );
+
+cleanup:
+
+   if( NULL != header ) {
+      maug_munlock( config->snap_h, header );
+   }
+
+   if( MERROR_OK != retval && (MAUG_MHANDLE)NULL != config->snap_h ) {
+      maug_mfree( config->snap_h );
+      config->snap_h = (MAUG_MHANDLE)NULL;
+      config->snap_sz = 0;
+   }
+
+   mfile_close( &snap_file );
+
+   return retval;
+}
+
+#endif /* !RETROFLAT_CONFIG_NO_SNAP */
+
+#endif /* RETROFLAT_CONFIG_USE_FILE */
+
+/* === */
+
 MERROR_RETVAL retroflat_config_open( RETROFLAT_CONFIG* config, uint8_t flags ) {
    MERROR_RETVAL retval = MERROR_OK;
 
 #  if defined( RETROFLAT_CONFIG_USE_FILE )
 
+   mfile_t src_file;
+   MAUG_MHANDLE src_h = (MAUG_MHANDLE)NULL;
+   uint8_t* src_buf = NULL;
+   uint32_t src_sz = 0,
+      src_hash = 0;
+   size_t lines_sz = 1,
+      i = 0;
+#     ifndef RETROFLAT_CONFIG_NO_SNAP
+   char snap_path[RETROFLAT_PATH_MAX + 1];
+#     endif /* !RETROFLAT_CONFIG_NO_SNAP */
+
+   maug_mzero( config, sizeof( RETROFLAT_CONFIG ) );
+   maug_mzero( &src_file, sizeof( mfile_t ) );
+
    debug_printf( 1, "opening config file %s...",
       g_retroflat_state->config_path );
 
    /* TODO: Open read/write when implemented. */
-   retval = mfile_open_read( g_retroflat_state->config_path, config );
+   retval = mfile_open_read( g_retroflat_state->config_path, &src_file );
+   maug_cleanup_if_not_ok();
+
+   /* Read the whole file once, to hash it and to parse it if need be. */
+   src_sz = mfile_get_sz( &src_file );
+   src_h = maug_malloc( (src_sz + 1), 1 );
+   maug_cleanup_if_null_alloc( MAUG_MHANDLE, src_h );
+
+   maug_mlock( src_h, src_buf );
+   maug_cleanup_if_null_lock( uint8_t*, src_buf );
+
+   if( 0 < src_sz ) {
+      retval = src_file.read_int(
+         &src_file, src_buf, src_sz, MFILE_READ_FLAG_LSBF );
+      maug_cleanup_if_not_ok();
+   }
+   mfile_close( &src_file );
+
+   src_hash = mdata_hash( src_buf, src_sz );
+   for( i = 0 ; src_sz > i ; i++ ) {
+      if( '\n' == src_buf[i] ) {
+         lines_sz++;
+      }
+   }
+
+   maug_munlock( src_h, src_buf );
+
+#     ifndef RETROFLAT_CONFIG_NO_SNAP
+   maug_mzero( snap_path, RETROFLAT_PATH_MAX + 1 );
+   maug_snprintf( snap_path, RETROFLAT_PATH_MAX, "%s%s",
+      g_retroflat_state->config_path, RETROFLAT_CONFIG_SNAP_EXT );
+
+   if( MERROR_OK == _retroflat_config_read_snap(
+      snap_path, config, src_sz, src_hash )
+   ) {
+      goto cleanup;
+   }
+#     endif /* !RETROFLAT_CONFIG_NO_SNAP */
+
+   /* Snapshot missing or stale, so parse the config file the long way. */
+   retval = mfile_lock_buffer( src_h, src_sz, &src_file );
    maug_cleanup_if_not_ok();
 
+   retval = _retroflat_config_parse(
+      &src_file, config, src_sz, src_hash, lines_sz );
+   maug_cleanup_if_not_ok();
+
+#     ifndef RETROFLAT_CONFIG_NO_SNAP
+   if( MERROR_OK != _retroflat_config_write_snap( snap_path, config ) ) {
+      /* Not fatal; we'll just parse again next time. */
+      error_printf( "unable to write config snapshot: %s", snap_path );
+   }
+#     endif /* !RETROFLAT_CONFIG_NO_SNAP */
+
 cleanup:
+
+   mfile_close( &src_file );
+
+   if( (MAUG_MHANDLE)NULL != src_h ) {
+      maug_mfree( src_h );
+   }
+
+   if( MERROR_OK != retval ) {
+      retroflat_config_close( config );
+   }
+
 #  elif defined( RETROFLAT_API_WIN16 )
 
    /* == Win16 (.ini file) == */
@@ -208,7 +756,10 @@ void retroflat_config_close( RETROFLAT_CONFIG* config ) {
 #  if defined( RETROFLAT_CONFIG_USE_FILE )
 
    debug_printf( 1, "closing config file..." );
-   mfile_close( config );
+   if( (MAUG_MHANDLE)NULL != config->snap_h ) {
+      maug_mfree( config->snap_h );
+   }
+   maug_mzero( config, sizeof( RETROFLAT_CONFIG ) );
 
 #  elif defined( RETROFLAT_API_WIN16 )
 
@@ -228,35 +779,6 @@ void retroflat_config_close( RETROFLAT_CONFIG* config ) {
 
 /* === */
 
-#ifdef RETROFLAT_CONFIG_USE_FILE
-
-/**
- * \param sect_match Pointer to size_t to hold strncmp() result.
- * \return Unmodified line if *any* section is found, with brackets stripped
- *         if sect_name is found.
- */
-static char* retroflat_config_tok_sect(
-   char* line, size_t line_sz, const char* sect_name, size_t* sect_match
-) {
-
-   /* Section check. */
-   if( '[' == line[0] ) {
-      *sect_match = strncmp( sect_name, &(line[1]), line_sz - 2 );
-      if( 0 == *sect_match ) {
-         /* TODO: Tokenize at closing bracket. */
-         line[line_sz - 1] = '\0';
-         debug_printf( 1, "found section: %s", &(line[1]) );
-      }
-      return line;
-   }
-
-   return NULL;
-}  
-
-#endif /* RETROFLAT_CONFIG_USE_FILE */
-
-/* === */
-
 size_t retroflat_config_write(
    RETROFLAT_CONFIG* config,
    const char* sect_name, const char* key_name, uint8_t buffer_type,
@@ -279,77 +801,60 @@ size_t retroflat_config_read(
 ) {
    size_t retval = 0;
 #  if defined( RETROFLAT_CONFIG_USE_FILE )
-   char line[RETROFLAT_CONFIG_LN_SZ_MAX + 1];
-   char* line_val = NULL;
-   size_t line_sz = 0;
-   size_t sect_match = 1;
-#  endif /* RETROFLAT_API_WIN32 */
+   struct RETROFLAT_CONFIG_SNAP_HEADER* header = NULL;
+   struct RETROFLAT_CONFIG_SLOT* slot = NULL;
+   const char* val = NULL;
+#  endif /* RETROFLAT_CONFIG_USE_FILE */
 
 #  if defined( RETROFLAT_CONFIG_USE_FILE )
 
    /* == SDL / Allegro == */
 
-   while( MERROR_OK == config->read_line(
-      config, line, RETROFLAT_CONFIG_LN_SZ_MAX, 0 )
-   ) {
-      /* Size check. */
-      line_sz = maug_strlen( line );
-      if( 1 >= line_sz || RETROFLAT_CONFIG_LN_SZ_MAX <= line_sz ) {
-         error_printf( "invalid line sz: " SIZE_T_FMT, line_sz );
-         continue;
-      }
-      
-      /* Strip off trailing newline. */
-      if( '\n' == line[line_sz - 1] || '\r' == line[line_sz - 1] ) {
-         debug_printf( 1, "stripping newline!" );
-         line_sz--;
-         line[line_sz] = '\0'; /* NULL goes after maug_strlen() finishes! */
-      }
+   if( (MAUG_MHANDLE)NULL == config->snap_h ) {
+      error_printf( "config not open!" );
+      goto cleanup;
+   }
 
-      /* Section check. */
-      if(
-         retroflat_config_tok_sect( line, line_sz, sect_name, &sect_match )
-      ) {
-         continue;
-      }
-      
-      /* Split up key/value pair. */
-      line_val = maug_strchr( line, '=' );
-      if( NULL == line_val || line_val == line ) {
-         error_printf( "invalid line: %s", line );
-         continue;
-      }
+   maug_mlock( config->snap_h, header );
+   if( NULL == header ) {
+      error_printf( "could not lock config!" );
+      goto cleanup;
+   }
 
-      /* Terminate key. */
-      line_val[0] = '\0';
-      line_val++;
+   slot = _retroflat_config_find( header, sect_name, key_name,
+      _retroflat_config_hash( sect_name, key_name ) );
+   if( NULL == slot || 0 == slot->key ) {
+      debug_printf( RETROFLAT_CONFIG_TRACE_LVL,
+         "key not found: %s: %s", sect_name, key_name );
+      goto cleanup;
+   }
 
-      if( 0 == sect_match && 0 == strcmp( key_name, line ) ) {
-         debug_printf( 1, "found %s: %s", line, line_val );
+   val = &(retroflat_config_snap_strs( header )[slot->val]);
+   debug_printf( 1, "found %s: %s", key_name, val );
 
-         switch( buffer_type ) {
-         case RETROFLAT_BUFFER_INT:
-            *((int*)buffer_out) = atoi( line_val );
-            goto cleanup;
+   switch( buffer_type ) {
+   case RETROFLAT_BUFFER_INT:
+      *((int*)buffer_out) = atoi( val );
+      break;
 
-         case RETROFLAT_BUFFER_FLOAT:
-            *((float*)buffer_out) = atof( line_val );
-            goto cleanup;
+   case RETROFLAT_BUFFER_FLOAT:
+      *((float*)buffer_out) = atof( val );
+      break;
 
-         case RETROFLAT_BUFFER_STRING:
-            maug_strncpy( (char*)buffer_out, line_val, buffer_out_sz_max );
-            goto cleanup;
+   case RETROFLAT_BUFFER_STRING:
+      maug_strncpy( (char*)buffer_out, val, buffer_out_sz_max );
+      break;
 
-         case RETROFLAT_BUFFER_BOOL:
-            /* TODO */
-            goto cleanup;
-         }
-      }
+   case RETROFLAT_BUFFER_BOOL:
+      /* TODO */
+      break;
    }
 
 cleanup:
 
-   config->seek( config, 0 );
+   if( NULL != header ) {
+      maug_munlock( config->snap_h, header );
+   }
 
 #  elif defined( RETROFLAT_API_WIN16 )
 
@@ -6,6 +6,9 @@
 
 #define RETROCON_FLAG_ACTIVE 0x01
 
+/*! \brief RETROCON::sbuffer has lines that have not been drawn yet. */
+#define RETROCON_FLAG_SBUFFER_DIRTY 0x02
+
 #define RETROCON_IDC_TEXTBOX  1
 
 #define RETROCON_IDC_CON_BASE 10
@@ -33,8 +36,12 @@ struct RETROCON {
 
 #  define retrocon_print_line( con, line )
 
+#  define retrocon_print_lines( con, lines, lines_sz )
+
 #  define retrocon_exec_line( con, line, line_sz )
 
+#  define retrocon_complete( con, line, line_sz_max )
+
 #  define retrocon_debounce( con, c )
 
 #  define retrocon_input( con, p_c, input_evt, p_idc, win_stack )
@@ -57,9 +64,24 @@ struct RETROCON {
 #endif /* !RETROCON_SBUFFER_SZ_MAX */
 
 #ifndef RETROCON_SBUFFER_LINES_MAX
+/*! \brief Number of printed lines kept in RETROCON::sbuffer. */
 #  define RETROCON_SBUFFER_LINES_MAX 30
 #endif /* !RETROCON_SBUFFER_LINES_MAX */
 
+#ifndef RETROCON_SBUFFER_LINE_SZ_MAX
+/**
+ * \brief Longest printed line kept; longer lines are cut off. Defaults to
+ *        ::RETROCON_LBUFFER_SZ_MAX, the old limit, but may be lowered to
+ *        save memory, since each of the ::RETROCON_SBUFFER_LINES_MAX lines
+ *        is this long.
+ */
+#  define RETROCON_SBUFFER_LINE_SZ_MAX RETROCON_LBUFFER_SZ_MAX
+#endif /* !RETROCON_SBUFFER_LINE_SZ_MAX */
+
+#ifndef RETROCON_SBUFFER_LINE_H
+#  define RETROCON_SBUFFER_LINE_H 8
+#endif /* !RETROCON_SBUFFER_LINE_H */
+
 #ifndef RETROCON_LBUFFER_SZ_MAX
 #  define RETROCON_LBUFFER_SZ_MAX 256
 #endif /* !RETROCON_LBUFFER_SZ_MAX */
@@ -72,9 +94,18 @@ struct RETROCON {
 #  define RETROCON_CB_NAME_SZ_MAX 32
 #endif /* !RETROCON_CB_NAME_SZ_MAX */
 
-#ifndef RETROCON_CB_SZ_MAX
-#  define RETROCON_CB_SZ_MAX 128
-#endif /* !RETROCON_CB_SZ_MAX */
+#ifndef RETROCON_CB_HASH_SZ_MIN
+/**
+ * \brief Smallest size of RETROCON::cmd_hash_h. The table grows to stay at
+ *        least twice the number of commands. Must be a power of 2.
+ */
+#  define RETROCON_CB_HASH_SZ_MIN 16
+#endif /* !RETROCON_CB_HASH_SZ_MIN */
+
+#ifndef RETROCON_ARGS_MAX
+/*! \brief Most tokens split into RETROCON::argv; the rest are dropped. */
+#  define RETROCON_ARGS_MAX 16
+#endif /* !RETROCON_ARGS_MAX */
 
 #ifndef RETROCON_WIN_H
 #  define RETROCON_WIN_H 110
@@ -82,22 +113,54 @@ struct RETROCON {
 
 struct RETROCON;
 
+/**
+ * \brief Callback for a console command added with retrocon_add_command().
+ *
+ * The line is also split on spaces into RETROCON::argv while this runs, with
+ * the command itself in RETROCON::argv[0].
+ */
 typedef MERROR_RETVAL (*retrocon_cb)(
    struct RETROCON* con, const char* line, size_t line_sz, void* data );
 
+struct RETROCON_CMD {
+   /*! \brief Name of the command, in uppercase. */
+   char name[RETROCON_CB_NAME_SZ_MAX + 1];
+   retrocon_cb cb;
+   void* data;
+};
+
 struct RETROCON {
    uint8_t flags;
    struct RETROGUI gui;
    int input_prev;
    int debounce_wait;
-   void* callback_data[RETROCON_CB_SZ_MAX];
-   char callback_names[RETROCON_CB_SZ_MAX][RETROCON_CB_NAME_SZ_MAX + 1];
-   retrocon_cb callbacks[RETROCON_CB_SZ_MAX];
-   size_t callbacks_sz;
+   /*! \brief ::RETROCON_CMD for each command, sorted by name. */
+   struct MDATA_VECTOR cmds;
+   /**
+    * \brief Open-addressed table of indexes into RETROCON::cmds by the
+    *        mdata_hash() of their names, or -1 for empty slots.
+    */
+   MAUG_MHANDLE cmd_hash_h;
+   size_t cmd_hash_sz;
+   /*! \brief Copy of the line being executed, split up by RETROCON::argv. */
+   char args[RETROCON_LBUFFER_SZ_MAX + 1];
+   char* argv[RETROCON_ARGS_MAX];
+   size_t argc;
    RETROFLAT_COLOR lbuffer_color;
    RETROFLAT_COLOR sbuffer_color;
    RETROFLAT_COLOR bg_color;
+   /**
+    * \brief Ring buffer of printed lines. The newest line is at
+    *        RETROCON::sbuffer_head, and older lines are before it.
+    */
+   char sbuffer[RETROCON_SBUFFER_LINES_MAX][RETROCON_SBUFFER_LINE_SZ_MAX + 1];
+   size_t sbuffer_head;
+   /*! \brief Number of lines in RETROCON::sbuffer that have been printed. */
+   size_t sbuffer_ct;
+   /*! \brief Number of lines in RETROCON::sbuffer that fit on screen. */
    size_t sbuffer_lines;
+   /*! \brief Y offset in the console GUI of the newest line on screen. */
+   size_t sbuffer_y;
 };
 
 MERROR_RETVAL retrocon_init(
@@ -109,9 +172,28 @@ MERROR_RETVAL retrocon_add_command(
 
 MERROR_RETVAL retrocon_print_line( struct RETROCON* con, const char* line );
 
+/**
+ * \brief Print several lines to the console at once, split on newlines.
+ * \param lines_sz Length of lines, or 0 to use the whole string.
+ */
+MERROR_RETVAL retrocon_print_lines(
+   struct RETROCON* con, const char* lines, size_t lines_sz );
+
 MERROR_RETVAL retrocon_exec_line(
    struct RETROCON* con, char* line, size_t line_sz );
 
+/**
+ * \brief Complete the command at the start of line from the added commands.
+ *
+ * If the start of the line only matches one command, it is replaced with
+ * that command. Otherwise, it's extended as far as all matching commands
+ * agree, and if it can't be extended, the matching commands are printed.
+ *
+ * \param line_sz_max Size of the line buffer, including terminator.
+ */
+MERROR_RETVAL retrocon_complete(
+   struct RETROCON* con, char* line, size_t line_sz_max );
+
 int retrocon_debounce( struct RETROCON* con, int c );
 
 /**
@@ -127,6 +209,10 @@ MERROR_RETVAL retrocon_input(
    struct RETROFLAT_INPUT* input_evt,
    retrogui_idc_t* p_idc_out, struct MDATA_VECTOR* win_stack );
 
+/**
+ * \brief Draw the console if it is open. It is redrawn in full on every
+ *        call, as the screen under it may have been redrawn since.
+ */
 MERROR_RETVAL retrocon_display(
    struct RETROCON* con, struct RETROFLAT_BITMAP* gui_bmp );
 
@@ -209,23 +295,17 @@ MERROR_RETVAL retrocon_init(
       retval = retrogui_push_ctl( &(con->gui), &ctl );
       maug_cleanup_if_not_ok();
 
-      ctl_y_iter = ctl.base.y + ctl.base.h + 1;
-      while( h - 5 > ctl_y_iter + 8 + 1 ) {
-         retrogui_init_ctl(
-            &ctl, RETROGUI_CTL_TYPE_LABEL,
-            RETROCON_IDC_CON_BASE + con->sbuffer_lines );
-
-         ctl.base.x = 5;
-         ctl.base.y = ctl_y_iter;
-         ctl.base.w = con->gui.w - 10;
-         ctl.base.h = 8; /* TODO: Dynamic height based on font. */
-         ctl.base.fg_color = RETROFLAT_COLOR_DARKGRAY;
-         ctl.LABEL.label = "xxxxxx";
-
-         retval = retrogui_push_ctl( &(con->gui), &ctl );
-         maug_cleanup_if_not_ok();
-
-         ctl_y_iter += ctl.base.h + 1;
+      /* Figure out how many printed lines fit under the textbox. These are
+       * drawn straight from the ring buffer by retrocon_display().
+       */
+      con->sbuffer_y = ctl.base.y + ctl.base.h + 1;
+      ctl_y_iter = con->sbuffer_y;
+      while(
+         h - 5 > ctl_y_iter + RETROCON_SBUFFER_LINE_H + 1 &&
+         RETROCON_SBUFFER_LINES_MAX > con->sbuffer_lines
+      ) {
+         /* TODO: Dynamic height based on font. */
+         ctl_y_iter += RETROCON_SBUFFER_LINE_H + 1;
          con->sbuffer_lines++;
       }
 
@@ -243,26 +323,199 @@ cleanup:
    return retval;
 }
 
+/**
+ * \brief Get the index of the first command in RETROCON::cmds whose name is
+ *        not less than the first name_sz characters of name.
+ * \warning RETROCON::cmds must be locked.
+ */
+static size_t _retrocon_cmd_lower_bound(
+   struct RETROCON* con, const char* name, size_t name_sz
+) {
+   size_t lo = 0,
+      hi = mdata_vector_ct( &(con->cmds) ),
+      mid = 0;
+   struct RETROCON_CMD* cmd = NULL;
+
+   while( lo < hi ) {
+      mid = lo + ((hi - lo) / 2);
+      cmd = mdata_vector_get( &(con->cmds), mid, struct RETROCON_CMD );
+      if( 0 > strncmp( cmd->name, name, name_sz ) ) {
+         lo = mid + 1;
+      } else {
+         hi = mid;
+      }
+   }
+
+   return lo;
+}
+
+/* === */
+
+/**
+ * \brief Get the index in RETROCON::cmds of the command with the given
+ *        uppercase name, or -1 if there isn't one.
+ * \warning RETROCON::cmds must be locked.
+ */
+static ssize_t _retrocon_cmd_find( struct RETROCON* con, const char* name ) {
+   MERROR_RETVAL retval = MERROR_OK;
+   ssize_t idx_out = -1;
+   ssize_t* cmd_hash = NULL;
+   struct RETROCON_CMD* cmd = NULL;
+   size_t slot = 0;
+
+   if( 0 == con->cmd_hash_sz ) {
+      goto cleanup;
+   }
+
+   maug_mlock( con->cmd_hash_h, cmd_hash );
+   maug_cleanup_if_null_lock( ssize_t*, cmd_hash );
+
+   /* The table is never more than half full, so this always ends. */
+   slot = mdata_hash( name, maug_strlen( name ) ) & (con->cmd_hash_sz - 1);
+   while( 0 <= cmd_hash[slot] ) {
+      cmd = mdata_vector_get(
+         &(con->cmds), cmd_hash[slot], struct RETROCON_CMD );
+      if( 0 == strcmp( cmd->name, name ) ) {
+         idx_out = cmd_hash[slot];
+         break;
+      }
+      slot = (slot + 1) & (con->cmd_hash_sz - 1);
+   }
+
+cleanup:
+
+   if( NULL != cmd_hash ) {
+      maug_munlock( con->cmd_hash_h, cmd_hash );
+   }
+
+   if( MERROR_OK != retval ) {
+      idx_out = retval * -1;
+   }
+
+   return idx_out;
+}
+
+/* === */
+
+/**
+ * \brief Rebuild RETROCON::cmd_hash_h from RETROCON::cmds, growing it if
+ *        needed.
+ * \warning RETROCON::cmds must be locked.
+ */
+static MERROR_RETVAL _retrocon_cmd_hash_rebuild( struct RETROCON* con ) {
+   MERROR_RETVAL retval = MERROR_OK;
+   ssize_t* cmd_hash = NULL;
+   struct RETROCON_CMD* cmd = NULL;
+   size_t hash_sz = RETROCON_CB_HASH_SZ_MIN,
+      slot = 0,
+      i = 0;
+
+   while( hash_sz < 2 * mdata_vector_ct( &(con->cmds) ) ) {
+      hash_sz *= 2;
+   }
+
+   if( hash_sz != con->cmd_hash_sz ) {
+      debug_printf( RETROCON_TRACE_LVL,
+         "resizing console command table to " SIZE_T_FMT " slots...",
+         hash_sz );
+      if( (MAUG_MHANDLE)NULL != con->cmd_hash_h ) {
+         maug_mfree( con->cmd_hash_h );
+      }
+      con->cmd_hash_sz = 0;
+      con->cmd_hash_h = maug_malloc( hash_sz, sizeof( ssize_t ) );
+      maug_cleanup_if_null_alloc( MAUG_MHANDLE, con->cmd_hash_h );
+      con->cmd_hash_sz = hash_sz;
+   }
+
+   maug_mlock( con->cmd_hash_h, cmd_hash );
+   maug_cleanup_if_null_lock( ssize_t*, cmd_hash );
+
+   for( i = 0 ; con->cmd_hash_sz > i ; i++ ) {
+      cmd_hash[i] = -1;
+   }
+
+   for( i = 0 ; mdata_vector_ct( &(con->cmds) ) > i ; i++ ) {
+      cmd = mdata_vector_get( &(con->cmds), i, struct RETROCON_CMD );
+      slot = mdata_hash( cmd->name, maug_strlen( cmd->name ) ) &
+         (con->cmd_hash_sz - 1);
+      while( 0 <= cmd_hash[slot] ) {
+         slot = (slot + 1) & (con->cmd_hash_sz - 1);
+      }
+      cmd_hash[slot] = i;
+   }
+
+cleanup:
+
+   if( NULL != cmd_hash ) {
+      maug_munlock( con->cmd_hash_h, cmd_hash );
+   }
+
+   return retval;
+}
+
+/* === */
+
 MERROR_RETVAL retrocon_add_command(
-   struct RETROCON* con, const char* cmd, retrocon_cb cb, void* cb_data
+   struct RETROCON* con, const char* cmd_name, retrocon_cb cb, void* cb_data
 ) {
    MERROR_RETVAL retval = MERROR_OK;
+   struct RETROCON_CMD cmd;
+   struct RETROCON_CMD* p_cmd = NULL;
+   ssize_t idx = -1;
+   size_t i = 0;
+
+   debug_printf( RETROCON_TRACE_LVL, "adding console command: %s", cmd_name );
 
-   debug_printf( RETROCON_TRACE_LVL, "adding console command: %s", cmd );
+   maug_mzero( &cmd, sizeof( struct RETROCON_CMD ) );
+   maug_strncpy( cmd.name, cmd_name, RETROCON_CB_NAME_SZ_MAX );
+   maug_str_upper( cmd.name, maug_strlen( cmd.name ) );
+   cmd.cb = cb;
+   cmd.data = cb_data;
 
-   maug_cleanup_if_ge_overflow( con->callbacks_sz + 1, RETROCON_CB_SZ_MAX );
+   if( 0 < mdata_vector_ct( &(con->cmds) ) ) {
+      mdata_vector_lock( &(con->cmds) );
+      idx = _retrocon_cmd_find( con, cmd.name );
+      if( -1 > idx ) {
+         retval = mdata_retval( idx );
+         goto cleanup;
+      } else if( 0 <= idx ) {
+         /* Just replace the callback if the command already exists. */
+         p_cmd = mdata_vector_get( &(con->cmds), idx, struct RETROCON_CMD );
+         p_cmd->cb = cb;
+         p_cmd->data = cb_data;
+         goto cleanup;
+      }
+      mdata_vector_unlock( &(con->cmds) );
+   }
 
-   maug_strncpy(
-      con->callback_names[con->callbacks_sz], cmd, RETROCON_CB_NAME_SZ_MAX );
+   idx = mdata_vector_append(
+      &(con->cmds), &cmd, sizeof( struct RETROCON_CMD ) );
+   retval = mdata_retval( idx );
+   maug_cleanup_if_not_ok();
 
-   con->callbacks[con->callbacks_sz] = cb;
+   mdata_vector_lock( &(con->cmds) );
 
-   con->callback_data[con->callbacks_sz] = cb_data;
+   /* Move the new command down so the commands stay sorted by name. */
+   for( i = idx ; 0 < i ; i-- ) {
+      p_cmd = mdata_vector_get( &(con->cmds), i - 1, struct RETROCON_CMD );
+      if( 0 >= strcmp( p_cmd->name, cmd.name ) ) {
+         break;
+      }
+      memcpy(
+         mdata_vector_get( &(con->cmds), i, struct RETROCON_CMD ), p_cmd,
+         sizeof( struct RETROCON_CMD ) );
+   }
+   memcpy(
+      mdata_vector_get( &(con->cmds), i, struct RETROCON_CMD ), &cmd,
+      sizeof( struct RETROCON_CMD ) );
 
-   con->callbacks_sz++;
+   /* Indexes after the new command have all moved. */
+   retval = _retrocon_cmd_hash_rebuild( con );
 
 cleanup:
 
+   mdata_vector_unlock( &(con->cmds) );
+
    return retval;
 }
 
@@ -312,38 +565,48 @@ cleanup:
 #endif
 
 MERROR_RETVAL retrocon_print_line( struct RETROCON* con, const char* line ) {
-   char sbuffer_shift[RETROCON_LBUFFER_SZ_MAX + 1] = { 0 };
-   size_t i = 0;
-   MERROR_RETVAL retval = MERROR_OK;
+   return retrocon_print_lines( con, line, 0 );
+}
 
-   /* TODO: Escape newlines in line. */
+MERROR_RETVAL retrocon_print_lines(
+   struct RETROCON* con, const char* lines, size_t lines_sz
+) {
+   MERROR_RETVAL retval = MERROR_OK;
+   size_t i = 0,
+      line_start = 0,
+      line_sz = 0;
 
-   /* Shift existing screen buffer lines all down by one. */
-   for( i = con->sbuffer_lines - 1 ; 0 < i ; i-- ) {
-      debug_printf( RETROCON_TRACE_LVL,
-         "copying sbuffer line " SIZE_T_FMT " to " SIZE_T_FMT "...",
-         i - 1, i );
-      maug_mzero( sbuffer_shift, RETROCON_LBUFFER_SZ_MAX + 1 );
-      retrogui_lock( &(con->gui) );
-      retval = retrogui_get_ctl_text(
-         &(con->gui), RETROCON_IDC_CON_BASE + i - 1,
-         sbuffer_shift, RETROCON_LBUFFER_SZ_MAX );
-      retval = retrogui_set_ctl_text(
-         &(con->gui), RETROCON_IDC_CON_BASE + i,
-         RETROCON_LBUFFER_SZ_MAX, sbuffer_shift );
-      retrogui_unlock( &(con->gui) );
-      maug_cleanup_if_not_ok();
+   if( 0 == lines_sz ) {
+      lines_sz = maug_strlen( lines );
    }
 
-   /* Put line in first sbuffer line. */
-   retrogui_lock( &(con->gui) );
-   retval = retrogui_set_ctl_text(
-      &(con->gui), RETROCON_IDC_CON_BASE,
-      RETROCON_LBUFFER_SZ_MAX, line );
-   retrogui_unlock( &(con->gui) );
-   maug_cleanup_if_not_ok();
+   for( i = 0 ; lines_sz >= i ; i++ ) {
+      if( lines_sz > i && '\n' != lines[i] ) {
+         continue;
+      }
 
-cleanup:
+      if( lines_sz == i && line_start == i && 0 < i ) {
+         /* Don't print an empty line after a trailing newline. */
+         break;
+      }
+
+      /* Overwrite the oldest line with this one. */
+      con->sbuffer_head = (con->sbuffer_head + 1) % RETROCON_SBUFFER_LINES_MAX;
+      if( RETROCON_SBUFFER_LINES_MAX > con->sbuffer_ct ) {
+         con->sbuffer_ct++;
+      }
+
+      line_sz = i - line_start;
+      if( RETROCON_SBUFFER_LINE_SZ_MAX < line_sz ) {
+         line_sz = RETROCON_SBUFFER_LINE_SZ_MAX;
+      }
+      memcpy( con->sbuffer[con->sbuffer_head], &(lines[line_start]), line_sz );
+      con->sbuffer[con->sbuffer_head][line_sz] = '\0';
+
+      line_start = i + 1;
+   }
+
+   con->flags |= RETROCON_FLAG_SBUFFER_DIRTY;
 
    return retval;
 }
@@ -352,35 +615,148 @@ MERROR_RETVAL retrocon_exec_line(
    struct RETROCON* con, char* line, size_t line_sz
 ) {
    MERROR_RETVAL retval = MERROR_OK;
-   size_t i = 0;
-   char line_cap[RETROCON_LBUFFER_SZ_MAX + 1];
-
-   /* Create an uppercase for comparison. */
-   maug_mzero( line_cap, RETROCON_LBUFFER_SZ_MAX + 1 );
-   strncpy( line_cap, line, RETROCON_LBUFFER_SZ_MAX );
-   maug_str_upper( line_cap, line_sz );
-
-   /* Find callback with name starting line. */
-   for( i = 0 ; con->callbacks_sz > i ; i++ ) {
-      if(
-         0 == strncmp(
-            /* TODO: Compare up to first space in line. */
-            con->callback_names[i], line_cap,
-            maug_strlen( con->callback_names[i] ) )
+   size_t i = 0,
+      args_sz = line_sz;
+   ssize_t idx = -1;
+   char name[RETROCON_CB_NAME_SZ_MAX + 1];
+   struct RETROCON_CMD* p_cmd = NULL;
+   retrocon_cb cb = NULL;
+   void* cb_data = NULL;
+
+   /* Split a copy of the line into tokens for the callback. */
+   if( RETROCON_LBUFFER_SZ_MAX < args_sz ) {
+      args_sz = RETROCON_LBUFFER_SZ_MAX;
+   }
+   maug_mzero( con->args, RETROCON_LBUFFER_SZ_MAX + 1 );
+   memcpy( con->args, line, args_sz );
+   con->argc = 0;
+   for( i = 0 ; args_sz > i && '\0' != con->args[i] ; i++ ) {
+      if( ' ' == con->args[i] ) {
+         con->args[i] = '\0';
+      } else if(
+         (0 == i || '\0' == con->args[i - 1]) && RETROCON_ARGS_MAX > con->argc
       ) {
-         retval = con->callbacks[i](
-            con, line, line_sz, con->callback_data[i] );
-         goto cleanup;
+         con->argv[con->argc++] = &(con->args[i]);
+      }
+   }
+
+   /* Look up the command by the first token. */
+   if(
+      0 < con->argc && 0 < mdata_vector_ct( &(con->cmds) ) &&
+      RETROCON_CB_NAME_SZ_MAX >= maug_strlen( con->argv[0] )
+   ) {
+      maug_mzero( name, RETROCON_CB_NAME_SZ_MAX + 1 );
+      maug_strncpy( name, con->argv[0], RETROCON_CB_NAME_SZ_MAX );
+      maug_str_upper( name, maug_strlen( name ) );
+
+      mdata_vector_lock( &(con->cmds) );
+      idx = _retrocon_cmd_find( con, name );
+      if( 0 <= idx ) {
+         p_cmd = mdata_vector_get( &(con->cmds), idx, struct RETROCON_CMD );
+         cb = p_cmd->cb;
+         cb_data = p_cmd->data;
       }
+      /* Unlock before calling, in case the callback adds commands. */
+      mdata_vector_unlock( &(con->cmds) );
+   }
+
+   if( NULL == cb ) {
+      retrocon_print_line( con, "COMMAND NOT FOUND!" );
+      goto cleanup;
+   }
+
+   retval = cb( con, line, line_sz, cb_data );
+
+cleanup:
+
+   mdata_vector_unlock( &(con->cmds) );
+
+   con->argc = 0;
+
+   return retval;
+}
+
+/* === */
+
+MERROR_RETVAL retrocon_complete(
+   struct RETROCON* con, char* line, size_t line_sz_max
+) {
+   MERROR_RETVAL retval = MERROR_OK;
+   char prefix[RETROCON_CB_NAME_SZ_MAX + 1];
+   size_t prefix_sz = 0,
+      common_sz = 0,
+      first = 0,
+      last = 0;
+   struct RETROCON_CMD* p_first = NULL;
+   struct RETROCON_CMD* p_last = NULL;
+
+   prefix_sz = maug_strlen( line );
+   if(
+      RETROCON_CB_NAME_SZ_MAX < prefix_sz || NULL != strchr( line, ' ' ) ||
+      0 == mdata_vector_ct( &(con->cmds) )
+   ) {
+      /* Only the command itself can be completed. */
+      goto cleanup;
+   }
+
+   maug_mzero( prefix, RETROCON_CB_NAME_SZ_MAX + 1 );
+   maug_strncpy( prefix, line, RETROCON_CB_NAME_SZ_MAX );
+   maug_str_upper( prefix, prefix_sz );
+
+   mdata_vector_lock( &(con->cmds) );
+
+   /* Commands are sorted, so all the matches are together. */
+   first = _retrocon_cmd_lower_bound( con, prefix, prefix_sz );
+   for(
+      last = first ;
+      mdata_vector_ct( &(con->cmds) ) > last &&
+         0 == strncmp( mdata_vector_get(
+            &(con->cmds), last, struct RETROCON_CMD )->name,
+               prefix, prefix_sz ) ;
+      last++
+   ) {}
+
+   if( first == last ) {
+      goto cleanup;
    }
 
-   retrocon_print_line( con, "COMMAND NOT FOUND!" );
+   /* The prefix all matches share is the prefix the first and last share. */
+   p_first = mdata_vector_get( &(con->cmds), first, struct RETROCON_CMD );
+   p_last = mdata_vector_get( &(con->cmds), last - 1, struct RETROCON_CMD );
+   while(
+      '\0' != p_first->name[common_sz] &&
+      p_first->name[common_sz] == p_last->name[common_sz]
+   ) {
+      common_sz++;
+   }
+
+   if( first + 1 == last && line_sz_max > common_sz + 1 ) {
+      /* Only one match, so finish it and start the arguments. */
+      memcpy( line, p_first->name, common_sz );
+      line[common_sz] = ' ';
+      line[common_sz + 1] = '\0';
+
+   } else if( prefix_sz < common_sz && line_sz_max > common_sz ) {
+      memcpy( line, p_first->name, common_sz );
+      line[common_sz] = '\0';
+
+   } else if( first + 1 < last ) {
+      /* Can't go any further, so show the options. */
+      for( ; last > first ; first++ ) {
+         retrocon_print_line( con, mdata_vector_get(
+            &(con->cmds), first, struct RETROCON_CMD )->name );
+      }
+   }
 
 cleanup:
 
+   mdata_vector_unlock( &(con->cmds) );
+
    return retval;
 }
 
+/* === */
+
 MERROR_RETVAL retrocon_input(
    struct RETROCON* con, RETROFLAT_IN_KEY* p_c,
    struct RETROFLAT_INPUT* input_evt,
@@ -427,6 +803,26 @@ MERROR_RETVAL retrocon_input(
       goto cleanup;
    } else if( RETROCON_FLAG_ACTIVE != (RETROCON_FLAG_ACTIVE & (con)->flags) ) {
       goto cleanup;
+
+   } else if( 0 != *p_c && RETROFLAT_KEY_TAB == *p_c ) {
+      /* Complete the command in the textbox. */
+      retrogui_lock( &(con->gui) );
+      retval = retrogui_get_ctl_text(
+         &(con->gui), RETROCON_IDC_TEXTBOX, lbuffer, RETROCON_LBUFFER_SZ_MAX );
+      retrogui_unlock( &(con->gui) );
+      maug_cleanup_if_not_ok();
+
+      retval = retrocon_complete( con, lbuffer, RETROCON_LBUFFER_SZ_MAX + 1 );
+      maug_cleanup_if_not_ok();
+
+      retrogui_lock( &(con->gui) );
+      retval = retrogui_set_ctl_text(
+         &(con->gui), RETROCON_IDC_TEXTBOX, RETROCON_LBUFFER_SZ_MAX,
+         "%s", lbuffer );
+      retrogui_unlock( &(con->gui) );
+
+      *p_c = 0;
+      goto cleanup;
    }
 
    /* debug_printf( RETROCON_TRACE_LVL, "processing console input..." ); */
@@ -521,6 +917,8 @@ MERROR_RETVAL retrocon_display(
    struct RETROCON* con, struct RETROFLAT_BITMAP* gui_bmp
 ) {
    MERROR_RETVAL retval = MERROR_OK;
+   size_t i = 0,
+      line_idx = 0;
 
    if( RETROCON_FLAG_ACTIVE != (RETROCON_FLAG_ACTIVE & (con)->flags) ) {
       goto cleanup;
@@ -529,10 +927,42 @@ MERROR_RETVAL retrocon_display(
    (con)->gui.draw_bmp = (gui_bmp);
    (con)->gui.flags |= RETROGUI_FLAGS_DIRTY;
 
+   /* The GUI background will be redrawn over the printed lines. */
+   con->flags |= RETROCON_FLAG_SBUFFER_DIRTY;
+
    retrogui_lock( &((con)->gui) );
    retrogui_redraw_ctls( &((con)->gui) );
    retrogui_unlock( &((con)->gui) );
 
+   if(
+      RETROCON_FLAG_SBUFFER_DIRTY != (RETROCON_FLAG_SBUFFER_DIRTY & con->flags)
+   ) {
+      goto cleanup;
+   }
+
+   con->flags &= ~RETROCON_FLAG_SBUFFER_DIRTY;
+
+   /* Draw printed lines, newest first, over the GUI background. */
+   for( i = 0 ; con->sbuffer_lines > i && con->sbuffer_ct > i ; i++ ) {
+      line_idx = (con->sbuffer_head + RETROCON_SBUFFER_LINES_MAX - i) %
+         RETROCON_SBUFFER_LINES_MAX;
+#ifdef RETROGXC_PRESENT
+      retrogxc_string(
+#else
+      retrofont_string(
+#endif /* RETROGXC_PRESENT */
+         con->gui.draw_bmp, con->sbuffer_color, con->sbuffer[line_idx], 0,
+#ifdef RETROGXC_PRESENT
+         con->gui.font_idx,
+#else
+         con->gui.font_h,
+#endif /* RETROGXC_PRESENT */
+         con->gui.x + 5 + RETROGUI_PADDING,
+         con->gui.y + con->sbuffer_y + RETROGUI_PADDING +
+            (i * (RETROCON_SBUFFER_LINE_H + 1)),
+         con->gui.w - 10, RETROCON_SBUFFER_LINE_H, 0 );
+   }
+
 cleanup:
 
    return retval;
@@ -540,9 +970,15 @@ cleanup:
 
 void retrocon_shutdown( struct RETROCON* con ) {
 #ifndef RETROGXC_PRESENT
+   retrofont_cache_free( con->gui.font_h );
    maug_mfree( con->gui.font_h );
 #endif /* !RETROGXC_PRESENT */
    retrogui_free( &(con->gui) );
+   mdata_vector_free( &(con->cmds) );
+   if( (MAUG_MHANDLE)NULL != con->cmd_hash_h ) {
+      maug_mfree( con->cmd_hash_h );
+      con->cmd_hash_h = (MAUG_MHANDLE)NULL;
+   }
 }
 
 #endif /* RETROCON_C */
@@ -185,15 +185,17 @@
  *
  * These are \b NOT mutually exclusive.
  *
- * | Define                 | Description                                      |
- * | ---------------------- | -------------------------------------------------|
- * | RETROFLAT_MOUSE        | Force-enable mouse on broken APIs (DANGEROUS!)   |
- * | RETROFLAT_TXP_R        | Specify R component of bitmap transparent color. |
- * | RETROFLAT_TXP_G        | Specify G component of bitmap transparent color. |
- * | RETROFLAT_TXP_B        | Specify B component of bitmap transparent color. |
- * | RETROFLAT_BITMAP_EXT   | Specify file extension for bitmap assets.        |
- * | RETROFLAT_NO_RESIZABLE | Disallow resizing the RetroFlat window.          |
- * | RETROFLAT_NO_BLANK_INIT| Do not blank screen on retroflat_ini().          |
+ * | Define                   | Description                                      |
+ * | ------------------------ | -------------------------------------------------|
+ * | RETROFLAT_MOUSE          | Force-enable mouse on broken APIs (DANGEROUS!)   |
+ * | RETROFLAT_TXP_R          | Specify R component of bitmap transparent color. |
+ * | RETROFLAT_TXP_G          | Specify G component of bitmap transparent color. |
+ * | RETROFLAT_TXP_B          | Specify B component of bitmap transparent color. |
+ * | RETROFLAT_BITMAP_EXT     | Specify file extension for bitmap assets.        |
+ * | RETROFLAT_NO_RESIZABLE   | Disallow resizing the RetroFlat window.          |
+ * | RETROFLAT_NO_BLANK_INIT  | Do not blank screen on retroflat_ini().          |
+ * | RETROFLAT_SDL2_STREAMING | Draw the SDL2 screen in software and upload it   |
+ * |                          | to a streaming texture once per frame.           |
  *
  * \page maug_retroflt_makefile_page RetroFlat Project Makefiles
  *
@@ -485,6 +487,10 @@ struct RETROFLAT_STATE;
  * in RETROFLAT_STATE::vdp_buffer which it processes and outputs to
  * RETROFLAT_STATE::buffer, which is then displayed on the screen.
  *
+ * RETROFLAT_STATE::vdp_buffer is created after retroflat_vdp_init() returns,
+ * so the VDP may set RETROFLAT_STATE::vdp_scale there to get a smaller one to
+ * scale up.
+ *
  * \{
  */
 
@@ -510,6 +516,21 @@ struct RETROFLAT_STATE;
  */
 typedef MERROR_RETVAL (*retroflat_vdp_proc_t)( struct RETROFLAT_STATE* );
 
+/**
+ * \brief Index of retroflat_vdp_init() in RETROFLAT_STATE::vdp_procs, to
+ *        pass to retroflat_vdp_call().
+ */
+#define RETROFLAT_VDP_PROC_INIT 0
+
+/*! \brief Index of retroflat_vdp_flip() in RETROFLAT_STATE::vdp_procs. */
+#define RETROFLAT_VDP_PROC_FLIP 1
+
+/*! \brief Index of retroflat_vdp_shutdown() in RETROFLAT_STATE::vdp_procs. */
+#define RETROFLAT_VDP_PROC_SHUTDOWN 2
+
+/*! \brief Number of procs in RETROFLAT_STATE::vdp_procs. */
+#define RETROFLAT_VDP_PROC_SZ 3
+
 /*! \} */ /* maug_retroflt_vdp */
 
 typedef MERROR_RETVAL (*retroflat_proc_resize_t)(
@@ -884,6 +905,16 @@ struct RETROFLAT_GLTEX {
    uint32_t id;
    size_t w;
    size_t h;
+   /**
+    * \brief Area of bytes modified since the texture was last uploaded.
+    *
+    * Right/bottom edges are exclusive. Nothing is dirty if dirty_x2 is
+    * not greater than dirty_x1. Maintained by retroglu_tex_dirty().
+    */
+   size_t dirty_x1;
+   size_t dirty_y1;
+   size_t dirty_x2;
+   size_t dirty_y2;
 };
 #endif /* RETROFLAT_OPENGL */
 
@@ -1284,6 +1315,11 @@ defined( RETROVDP_C )
    /*! \brief A handle for the loaded \ref maug_retroflt_vdp module. */
    void* vdp_exe;
 #     endif /* RETROFLAT_OS_WIN */
+   /**
+    * \brief Procs exported by the \ref maug_retroflt_vdp, looked up once
+    *        when it is loaded, or NULL if it doesn't export them.
+    */
+   retroflat_vdp_proc_t vdp_procs[RETROFLAT_VDP_PROC_SZ];
    /**
     * \brief Pointer to data defined by the \ref maug_retroflt_vdp for its
     *        use.
@@ -1293,6 +1329,13 @@ defined( RETROVDP_C )
    char vdp_args[RETROFLAT_VDP_ARGS_SZ_MAX];
    /*! \brief Flags set by the \ref maug_retroflt_vdp. */
    uint8_t vdp_flags;
+   /**
+    * \brief Factor the \ref maug_retroflt_vdp scales frames up by, which it
+    *        may set during retroflat_vdp_init(). RETROFLAT_STATE::vdp_buffer
+    *        and retroflat_screen_w()/retroflat_screen_h() are the screen
+    *        size divided by this.
+    */
+   uint8_t vdp_scale;
 #  endif /* RETROFLAT_VDP || DOCUMENTATION || RETROVDP_C */
 
    /* These are used by VDP so should be standardized/not put in plat-spec! */
@@ -1394,8 +1437,11 @@ void retroflat_shutdown( int retval );
 
 /**
  * \brief Call a function from the retroflat VDP.
+ * \param proc_id Index of the function in RETROFLAT_STATE::vdp_procs, e.g.
+ *        ::RETROFLAT_VDP_PROC_FLIP. Functions the VDP doesn't export are
+ *        skipped.
  */
-MERROR_RETVAL retroflat_vdp_call( const char* proc_name );
+MERROR_RETVAL retroflat_vdp_call( uint8_t proc_id );
 
 /*! \} */ /* maug_retroflt_vdp */
 #  endif /* RETROFLAT_VDP || DOCUMENTATION */
@@ -1492,6 +1538,26 @@ void retroflat_px(
    struct RETROFLAT_BITMAP* target, const RETROFLAT_COLOR color,
    size_t x, size_t y, uint8_t flags );
 
+/**
+ * \brief Fill w pixels of row y on a locked bitmap, starting at x.
+ *
+ * Platforms that define RETROFLAT_PX_ROW write the run directly into the
+ * bitmap (e.g. with memset() or word-wide stores). Others fall back to one
+ * retroflat_px() per pixel. The run is clipped to the bitmap.
+ */
+void retroflat_px_row(
+   struct RETROFLAT_BITMAP* target, const RETROFLAT_COLOR color_idx,
+   size_t x, size_t y, size_t w );
+
+/**
+ * \brief Write a row of w palette indexes starting at x, y on a locked
+ *        bitmap, skipping pixels equal to txp_idx (or none if it is
+ *        ::RETROFLAT_COLOR_NULL). The row is clipped to the bitmap.
+ */
+void retroflat_idx_row(
+   struct RETROFLAT_BITMAP* target, const uint8_t* idx_row,
+   size_t x, size_t y, size_t w, RETROFLAT_COLOR txp_idx );
+
 #ifdef RETROFLAT_SOFT_SHAPES
 #  ifdef RETROFLAT_OPENGL
 /* Make sure we're not passing NULL to openGL texture drawers... they can't
@@ -1657,6 +1723,15 @@ MAUG_CONST int16_t SEG_MCONST gc_retroflat_offsets4_y[4] =
 MAUG_MHANDLE g_retroflat_state_h = (MAUG_MHANDLE)NULL;
 struct RETROFLAT_STATE* g_retroflat_state = NULL;
 
+#  ifdef RETROFLAT_VDP
+/* Names of the procs in RETROFLAT_STATE::vdp_procs, in the same order. */
+MAUG_CONST char* SEG_MCONST gc_retroflat_vdp_proc_names[] = {
+   "retroflat_vdp_init",
+   "retroflat_vdp_flip",
+   "retroflat_vdp_shutdown"
+};
+#  endif /* RETROFLAT_VDP */
+
 #  define RETROFLAT_COLOR_TABLE_CONSTS( idx, name_l, name_u, r, g, b, cgac, cgad ) \
       MAUG_CONST RETROFLAT_COLOR RETROFLAT_COLOR_ ## name_u = idx;
 
@@ -1701,8 +1776,11 @@ MERROR_RETVAL retroflat_build_filename_path(
 
 /* === */
 
+/* OpenGL includes retrosft.h below, after retroglu.h, so soft spans can
+ * write to textures directly.
+ */
 #  if (defined( RETROFLAT_SOFT_SHAPES ) || defined( RETROFLAT_SOFT_LINES )) \
-   && !defined( MAUG_NO_AUTO_C )
+   && !defined( RETROFLAT_OPENGL ) && !defined( MAUG_NO_AUTO_C )
 #     define RETROFP_C
 #     include <retrofp.h>
 #     define RETROSFT_C
@@ -2145,6 +2223,10 @@ int retroflat_init( int argc, char* argv[], struct RETROFLAT_ARGS* args ) {
    /* = Declare Init Vars = */
 
    int retval = 0;
+#  ifdef RETROFLAT_VDP
+   size_t i = 0;
+   mplug_proc_t vdp_proc = (mplug_proc_t)NULL;
+#  endif /* RETROFLAT_VDP */
 
    /* = Begin Init Procedure = */
 
@@ -2320,6 +2402,71 @@ int retroflat_init( int argc, char* argv[], struct RETROFLAT_ARGS* args ) {
    retval = retroflat_init_platform( argc, argv, args );
    maug_cleanup_if_not_ok();
 
+   /* Platform init seeds the platform's generator, so use it to seed ours.
+    * Call mrand_seed_streams() after this to replay from a known seed.
+    */
+   mrand_seed_streams(
+      retroflat_get_rand() ^ (retroflat_get_rand() << 16) );
+
+   /* Load the VDP before the refresh grid, as it may change the screen size
+    * the program sees.
+    */
+#  ifdef RETROFLAT_VDP
+#     if defined( RETROFLAT_OS_UNIX )
+   g_retroflat_state->vdp_exe = dlopen(
+      "./" RETROFLAT_VDP_LIB_NAME ".so", RTLD_LAZY );
+#     elif defined( RETROFLAT_OS_WIN )
+   g_retroflat_state->vdp_exe = LoadLibrary(
+      "./" RETROFLAT_VDP_LIB_NAME ".dll" );
+#     else
+#        error "dlopen undefined!"
+#     endif /* RETROFLAT_OS_UNIX */
+
+   if( !(g_retroflat_state->vdp_exe) ) {
+      error_printf( "not loading VDP" );
+      /* Skip creating the buffer or trying to run the init proc. */
+      goto skip_vdp;
+   }
+
+   /* Look up the procs now so they aren't looked up on every frame. */
+#     if !defined( RETROFLAT_OS_UNIX ) && !defined( RETROFLAT_OS_WIN )
+#        error "dlsym undefined!"
+#     endif /* !RETROFLAT_OS_UNIX && !RETROFLAT_OS_WIN */
+   for( i = 0 ; RETROFLAT_VDP_PROC_SZ > i ; i++ ) {
+      /* Missing procs are logged and left NULL so they're skipped. */
+      mplug_resolve(
+         g_retroflat_state->vdp_exe, gc_retroflat_vdp_proc_names[i],
+         &vdp_proc );
+      g_retroflat_state->vdp_procs[i] = (retroflat_vdp_proc_t)vdp_proc;
+   }
+
+   /* Init the VDP first, so it can ask for a smaller buffer to scale up. */
+   debug_printf( 1, "initializing VDP..." );
+   g_retroflat_state->vdp_scale = 1;
+   retval = retroflat_vdp_call( RETROFLAT_VDP_PROC_INIT );
+   maug_cleanup_if_not_ok();
+   if( 0 == g_retroflat_state->vdp_scale ) {
+      g_retroflat_state->vdp_scale = 1;
+   }
+
+   /* Create intermediary screen buffer. */
+   debug_printf( 1, "creating VDP buffer, " SIZE_T_FMT " x " SIZE_T_FMT,
+      g_retroflat_state->screen_v_w / g_retroflat_state->vdp_scale,
+      g_retroflat_state->screen_v_h / g_retroflat_state->vdp_scale );
+   g_retroflat_state->vdp_buffer =
+      calloc( 1, sizeof( struct RETROFLAT_BITMAP ) );
+   maug_cleanup_if_null_alloc(
+      struct RETROFLAT_BITMAP*, g_retroflat_state->vdp_buffer );
+   retval = retroflat_create_bitmap(
+      g_retroflat_state->screen_v_w / g_retroflat_state->vdp_scale,
+      g_retroflat_state->screen_v_h / g_retroflat_state->vdp_scale,
+      g_retroflat_state->vdp_buffer, RETROFLAT_FLAGS_OPAQUE );
+   maug_cleanup_if_not_ok();
+
+skip_vdp:
+
+#  endif /* RETROFLAT_VDP */
+
    /* Setup the refresh grid, if requested, only after screen space has been
     * determined by the platform!
     */
@@ -2362,42 +2509,6 @@ int retroflat_init( int argc, char* argv[], struct RETROFLAT_ARGS* args ) {
 #     endif /* !RETROFLAT_NO_STRING */
 #  endif /* RETROFLAT_OPENGL */
 
-#  ifdef RETROFLAT_VDP
-#     if defined( RETROFLAT_OS_UNIX )
-   g_retroflat_state->vdp_exe = dlopen(
-      "./" RETROFLAT_VDP_LIB_NAME ".so", RTLD_LAZY );
-#     elif defined( RETROFLAT_OS_WIN )
-   g_retroflat_state->vdp_exe = LoadLibrary(
-      "./" RETROFLAT_VDP_LIB_NAME ".dll" );
-#     else
-#        error "dlopen undefined!"
-#     endif /* RETROFLAT_OS_UNIX */
-
-   if( !(g_retroflat_state->vdp_exe) ) {
-      error_printf( "not loading VDP" );
-      /* Skip creating the buffer or trying to run the init proc. */
-      goto skip_vdp;
-   }
-
-   /* Create intermediary screen buffer. */
-   debug_printf( 1, "creating VDP buffer, " SIZE_T_FMT " x " SIZE_T_FMT,
-      g_retroflat_state->screen_v_w, g_retroflat_state->screen_v_h );
-   g_retroflat_state->vdp_buffer =
-      calloc( 1, sizeof( struct RETROFLAT_BITMAP ) );
-   maug_cleanup_if_null_alloc(
-      struct RETROFLAT_BITMAP*, g_retroflat_state->vdp_buffer );
-   retval = retroflat_create_bitmap(
-      g_retroflat_state->screen_v_w, g_retroflat_state->screen_v_h,
-      g_retroflat_state->vdp_buffer, RETROFLAT_FLAGS_OPAQUE );
-   maug_cleanup_if_not_ok();
-
-   debug_printf( 1, "initializing VDP..." );
-   retval = retroflat_vdp_call( "retroflat_vdp_init" );
-
-skip_vdp:
-
-#  endif /* RETROFLAT_VDP */
-
 #  if !defined( RETROFLAT_NO_BLANK_INIT ) && !defined( RETROFLAT_OPENGL )
    retroflat_draw_lock( NULL );
    retroflat_rect(
@@ -2424,7 +2535,7 @@ void retroflat_shutdown( int retval ) {
 
 #  if defined( RETROFLAT_VDP )
    if( NULL != g_retroflat_state->vdp_exe ) {
-      retroflat_vdp_call( "retroflat_vdp_shutdown" );
+      retroflat_vdp_call( RETROFLAT_VDP_PROC_SHUTDOWN );
 #     ifdef RETROFLAT_OS_UNIX
       dlclose( g_retroflat_state->vdp_exe );
 #     elif defined( RETROFLAT_OS_WIN )
@@ -2465,27 +2576,17 @@ defined( RETROFLAT_OPENGL )
 
 #  ifdef RETROFLAT_VDP
 
-MERROR_RETVAL retroflat_vdp_call( const char* proc_name ) {
+MERROR_RETVAL retroflat_vdp_call( uint8_t proc_id ) {
    MERROR_RETVAL retval = MERROR_OK;
    retroflat_vdp_proc_t vdp_proc = (retroflat_vdp_proc_t)NULL;
-#     ifdef RETROFLAT_OS_WIN
-   char proc_name_ex[256];
-#     endif /* RETROFLAT_OS_WIN */
+
+   assert( RETROFLAT_VDP_PROC_SZ > proc_id );
 
    if( NULL == g_retroflat_state->vdp_exe ) {
       goto cleanup;
    }
 
-#     ifdef RETROFLAT_OS_UNIX
-   vdp_proc = dlsym( g_retroflat_state->vdp_exe, proc_name );
-#     elif defined( RETROFLAT_OS_WIN )
-   /* Append a _ to the proc_name because Watcom? Windows? */
-   maug_snprintf( proc_name_ex, 255, "%s_", proc_name );
-   vdp_proc = (retroflat_vdp_proc_t)GetProcAddress(
-      g_retroflat_state->vdp_exe, proc_name_ex );
-#     else
-#        error "dlsym undefined!"
-#     endif
+   vdp_proc = g_retroflat_state->vdp_procs[proc_id];
    if( (retroflat_vdp_proc_t)NULL == vdp_proc ) {
       goto cleanup;
    }
@@ -2496,7 +2597,7 @@ MERROR_RETVAL retroflat_vdp_call( const char* proc_name ) {
 
    if(
       /* Don't pxlock before init can set the flag! */
-      0 == strcmp( "retroflat_vdp_flip", proc_name ) &&
+      RETROFLAT_VDP_PROC_FLIP == proc_id &&
       RETROFLAT_VDP_FLAG_PXLOCK ==
          (RETROFLAT_VDP_FLAG_PXLOCK & g_retroflat_state->vdp_flags)
    ) {
@@ -2507,7 +2608,7 @@ MERROR_RETVAL retroflat_vdp_call( const char* proc_name ) {
    retval = vdp_proc( g_retroflat_state );
 
    if(
-      0 == strcmp( "retroflat_vdp_flip", proc_name ) &&
+      RETROFLAT_VDP_PROC_FLIP == proc_id &&
       RETROFLAT_VDP_FLAG_PXLOCK ==
          (RETROFLAT_VDP_FLAG_PXLOCK & g_retroflat_state->vdp_flags)
    ) {
@@ -2527,6 +2628,41 @@ cleanup:
 
 /* === */
 
+#  ifndef RETROFLAT_PX_ROW
+
+/* Platforms without a faster way to fill rows draw them a pixel at a time. */
+
+void retroflat_px_row(
+   struct RETROFLAT_BITMAP* target, const RETROFLAT_COLOR color_idx,
+   size_t x, size_t y, size_t w
+) {
+   size_t i = 0;
+
+   for( i = 0 ; w > i ; i++ ) {
+      retroflat_px( target, color_idx, x + i, y, 0 );
+   }
+}
+
+/* === */
+
+void retroflat_idx_row(
+   struct RETROFLAT_BITMAP* target, const uint8_t* idx_row,
+   size_t x, size_t y, size_t w, RETROFLAT_COLOR txp_idx
+) {
+   size_t i = 0;
+
+   for( i = 0 ; w > i ; i++ ) {
+      if( txp_idx == idx_row[i] ) {
+         continue;
+      }
+      retroflat_px( target, idx_row[i], x + i, y, 0 );
+   }
+}
+
+#  endif /* !RETROFLAT_PX_ROW */
+
+/* === */
+
 #if 0
 
 void retroflat_cursor( struct RETROFLAT_BITMAP* target, uint8_t flags ) {
@@ -2866,7 +3002,7 @@ extern MAUG_CONST char* SEG_MCONST gc_retroflat_color_names[];
 #  include <uprintf.h>
 
 #  if (defined( RETROFLAT_SOFT_SHAPES ) || defined( RETROFLAT_SOFT_LINES)) \
-   && !defined( MAUG_NO_AUTO_C )
+   && !defined( RETROFLAT_OPENGL ) && !defined( MAUG_NO_AUTO_C )
 #     include <retrofp.h>
 #     include <retrosft.h>
 #  endif /* RETROFLAT_SOFT_SHAPES || RETROFLAT_SOFT_LINES */
@@ -14,6 +14,14 @@
 #  define RETROFONT_LINE_SZ 80
 #endif /* !RETROFONT_LINE_SZ */
 
+#ifndef RETROFONT_READ_BUF_SZ
+/**
+ * \brief Size of the chunks a .hex font is read in. Must hold at least one
+ *        whole line.
+ */
+#  define RETROFONT_READ_BUF_SZ (RETROFONT_LINE_SZ * 16)
+#endif /* !RETROFONT_READ_BUF_SZ */
+
 #ifndef RETROFONT_TRACE_LVL
 #  define RETROFONT_TRACE_LVL 0
 #endif /* !RETROFONT_TRACE_LVL */
@@ -26,15 +34,161 @@
  */
 #define RETROFONT_FLAG_OUTLINE  0x04
 
+/**
+ * \addtogroup retrofont_cache RetroFont Glyph Cache
+ * \brief Rasterize each glyph once per font/color/outline and blit it from
+ *        then on.
+ *
+ * The first retrofont_string() call for a given font, color, and outline
+ * flag draws every glyph in the font into an atlas bitmap with
+ * retrofont_blit_glyph(). Later calls blit from the atlas. A small table of
+ * retrofont_string_sz() results is kept alongside, keyed on a hash of the
+ * string and the sizing parameters.
+ *
+ * Define RETROFONT_NO_CACHE to draw every glyph pixel by pixel as before.
+ * \{
+ */
+
+#ifndef RETROFONT_CACHE_ENTRIES_MAX
+/**
+ * \brief Number of font/color/outline atlases kept at once. The least
+ *        recently used atlas is replaced when a new one is needed.
+ */
+#  define RETROFONT_CACHE_ENTRIES_MAX 8
+#endif /* !RETROFONT_CACHE_ENTRIES_MAX */
+
+#ifndef RETROFONT_CACHE_ATLAS_W
+/*! \brief Maximum width of a glyph atlas bitmap in pixels. */
+#  define RETROFONT_CACHE_ATLAS_W 256
+#endif /* !RETROFONT_CACHE_ATLAS_W */
+
+#ifndef RETROFONT_SZ_CACHE_MAX
+/*! \brief Number of retrofont_string_sz() results remembered. */
+#  define RETROFONT_SZ_CACHE_MAX 16
+#endif /* !RETROFONT_SZ_CACHE_MAX */
+
+#ifndef retrofont_cache_color_ok
+#  ifdef RETROFLAT_OPENGL
+#     define retrofont_cache_color_ok( color ) (1)
+#  else
+/**
+ * \brief Whether glyphs in the given color can go through an atlas.
+ *
+ * Color-keyed backends treat ::RETROFLAT_TXP_R, ::RETROFLAT_TXP_G, and
+ * ::RETROFLAT_TXP_B (black by default) as transparent, so glyphs in black
+ * would vanish when blitted. Those are drawn directly instead.
+ */
+#     define retrofont_cache_color_ok( color ) \
+         (RETROFLAT_COLOR_BLACK != (color))
+#  endif /* RETROFLAT_OPENGL */
+#endif /* !retrofont_cache_color_ok */
+
+/*! \} */ /* retrofont_cache */
+
 struct RETROFONT {
    uint16_t sz;
    uint16_t first_glyph;
+   /**
+    * \brief Last glyph of the requested range. Space is kept for every glyph
+    *        from first_glyph through this, even those missing from the file.
+    */
+   uint16_t last_glyph;
+   /*! \brief Number of glyphs actually decoded. */
    uint16_t glyphs_count;
    uint8_t glyph_w;
    uint8_t glyph_h;
    uint8_t glyph_sz;
 };
 
+/**
+ * \addtogroup retrofont_cache
+ * \{
+ */
+
+/**
+ * \brief Atlas holding every glyph of one font in one color.
+ */
+struct RETROFONT_CACHE {
+   /*! \brief Font handle this atlas was drawn from, or NULL if unused. */
+   MAUG_MHANDLE font_h;
+   RETROFLAT_COLOR color;
+   /*! \brief ::RETROFONT_FLAG_OUTLINE if the glyphs are outlined. */
+   uint8_t flags;
+   /*! \brief Value of the use counter the last time this atlas was used. */
+   uint32_t last_use;
+   uint16_t first_glyph;
+   uint16_t glyphs_count;
+   uint8_t cell_w;
+   uint8_t cell_h;
+   uint8_t cells_per_row;
+   struct RETROFLAT_BITMAP atlas;
+};
+
+/**
+ * \brief Remembered retrofont_string_sz() result.
+ *
+ * Results are stored relative to 0 so they can be applied to whatever the
+ * caller passes in *out_w_p and *out_h_p.
+ */
+struct RETROFONT_SZ_CACHE {
+   /*! \brief Font handle this size was measured with, or NULL if unused. */
+   MAUG_MHANDLE font_h;
+   uint32_t str_hash;
+   size_t str_sz;
+   size_t max_w;
+   size_t max_h;
+   /*! \brief Widest line, before the final 1px added to the width. */
+   size_t w;
+   /*! \brief Height of all lines. */
+   size_t h;
+   /*! \brief Height before the last wrap, or -1 if the string never wraps. */
+   ssize_t wrap_h;
+};
+
+/*! \} */ /* retrofont_cache */
+
+/**
+ * \addtogroup retrofont_bin RetroFont Binary Fonts
+ * \brief Precompiled fonts that load with one read.
+ *
+ * A font blob is a ::RETROFONT_BIN_HEADER followed by the font exactly as
+ * retrofont_load() leaves it in memory: a ::RETROFONT and its glyphs. Blobs
+ * are stored in the native layout of the program that wrote them, so they
+ * are only valid for the build that created them. retrofont_load()
+ * recognizes blobs by their magic number, so they can stand in for the
+ * .hex font they were made from.
+ * \{
+ */
+
+#define RETROFONT_BIN_MAGIC "RFNT"
+
+#define RETROFONT_BIN_VERSION 2
+
+struct RETROFONT_BIN_HEADER {
+   /*! \brief Always ::RETROFONT_BIN_MAGIC. */
+   char magic[4];
+   uint16_t version;
+   /*! \brief sizeof( struct RETROFONT ) in the build that wrote the blob. */
+   uint16_t font_sz;
+   /*! \brief Size of the font, including its ::RETROFONT header. */
+   uint32_t data_sz;
+};
+
+/**
+ * \brief Write a font loaded with retrofont_load() to a blob that can be
+ *        loaded in its place.
+ */
+MERROR_RETVAL retrofont_write_bin( const char* filename, MAUG_MHANDLE font_h );
+
+/*! \} */ /* retrofont_bin */
+
+/**
+ * \brief Load a font from a .hex file or a font blob.
+ *
+ * .hex files are read in ::RETROFONT_READ_BUF_SZ chunks (or decoded in
+ * place if the file is in memory), and reading stops at the first glyph
+ * past the requested range.
+ */
 MERROR_RETVAL retrofont_load(
    const char* font_name, MAUG_MHANDLE* p_font_h,
    uint8_t glyph_h, uint16_t first_glyph, uint16_t glyphs_count );
@@ -54,6 +208,12 @@ MERROR_RETVAL retrofont_string_sz(
    MAUG_MHANDLE font_h, size_t max_w, size_t max_h,
    size_t* out_w_p, size_t* out_h_p, uint8_t flags );
 
+/**
+ * \brief Drop cached glyph atlases and sizes for the given font, e.g. before
+ *        freeing it. Pass NULL to drop everything.
+ */
+void retrofont_cache_free( MAUG_MHANDLE font_h );
+
 /**
  * \brief Get a pointer to the glyph with the given index in the given font.
  */
@@ -63,6 +223,12 @@ MERROR_RETVAL retrofont_string_sz(
 
 #ifdef RETROFNT_C
 
+#  ifndef RETROFONT_NO_CACHE
+static struct RETROFONT_CACHE gs_retrofont_cache[RETROFONT_CACHE_ENTRIES_MAX];
+static struct RETROFONT_SZ_CACHE gs_retrofont_sz_cache[RETROFONT_SZ_CACHE_MAX];
+static uint32_t gs_retrofont_cache_uses = 0;
+#  endif /* !RETROFONT_NO_CACHE */
+
 void retrofont_dump_glyph( uint8_t* glyph, uint8_t w, uint8_t h ) {
    size_t x = 0, y = 0;
    char glyph_bin[65];
@@ -115,152 +281,291 @@ static size_t retrofont_sz_from_filename( const char* font_name ) {
    return glyph_h;
 }
 
-MERROR_RETVAL retrofont_load(
-   const char* font_name, MAUG_MHANDLE* p_font_h,
+/**
+ * \brief Decode any complete lines of .hex font data in buf into the font,
+ *        allocating the font from the first line if it has not been yet.
+ * \param final Nonzero if buf runs to the end of the file, so a last line
+ *              without a newline should be decoded too.
+ * \param p_consumed Set to the number of bytes fully decoded.
+ * \param p_done Set to 1 if a glyph past the requested range was reached.
+ *               .hex files are sorted by codepoint, so nothing more is
+ *               needed after that.
+ */
+static MERROR_RETVAL retrofont_parse_hex(
+   const char* buf, size_t buf_sz, uint8_t final, size_t* p_consumed,
+   uint8_t* p_done, MAUG_MHANDLE* p_font_h, struct RETROFONT** p_font,
    uint8_t glyph_h, uint16_t first_glyph, uint16_t glyphs_count
 ) {
    MERROR_RETVAL retval = MERROR_OK;
-   mfile_t font_file;
-   char line[RETROFONT_LINE_SZ];
-   struct RETROFONT* font = NULL;
-   char* line_bytes = NULL;
-   uint16_t glyph_idx = 0;
-   uint8_t* p_glyph = NULL;
-   size_t i = 0;
+   size_t i = 0,
+      line_end = 0,
+      hex_start = 0,
+      hex_end = 0,
+      j = 0;
+   uint32_t glyph_idx = 0;
    uint8_t glyph_w_bytes = 0;
-   uint8_t glyph_w = 0;
+   uint8_t* p_glyph = NULL;
+   struct RETROFONT* font = *p_font;
 
-   maug_mzero( &font_file, sizeof( mfile_t ) );
+   while( buf_sz > i ) {
+      /* Find the end of this line. */
+      for( line_end = i ; buf_sz > line_end ; line_end++ ) {
+         if( '\n' == buf[line_end] ) {
+            break;
+         }
+      }
+      if( buf_sz <= line_end && !final ) {
+         /* Incomplete line; wait for the rest of it. */
+         break;
+      }
 
-   /* TODO: Font loading seems to be very slow on a 486. This needs
-    *       investigation.
-    */
+      /* Separate the line into index:glyph bytes. */
+      for( hex_start = i ; line_end > hex_start ; hex_start++ ) {
+         if( ':' == buf[hex_start] ) {
+            break;
+         }
+      }
+      hex_end = line_end;
+      while( hex_end > hex_start && '\r' == buf[hex_end - 1] ) {
+         hex_end--;
+      }
+      if( line_end <= hex_start ) {
+         /* The line couldn't parse, so skip it, but don't give up entirely
+          * and keep going to the next line.
+          */
+         goto next_line;
+      }
+      glyph_idx = maug_atou32( &(buf[i]), hex_start - i, 16 );
+      hex_start++;
+
+      if( NULL == font ) {
+         /* Figure out font width from file and alloc just enough. */
+         glyph_w_bytes = ((hex_end - hex_start) / glyph_h) >> 1;
+         debug_printf( RETROFONT_TRACE_LVL, "glyph_w_bytes: %u", glyph_w_bytes );
+         if( 0 == glyph_w_bytes ) {
+            error_printf( "invalid first glyph line!" );
+            retval = MERROR_PARSE;
+            goto cleanup;
+         }
 
-   if( 0 == glyph_h ) {
-      glyph_h = retrofont_sz_from_filename( font_name );
-   }
-   if( 0 == glyph_h ) {
-      error_printf( "unable to determine font height!" );
-      retval = MERROR_GUI;
-      goto cleanup;
+         /* Alloc enough for each glyph, plus the size of the font header. */
+         *p_font_h = maug_malloc( 1,
+            sizeof( struct RETROFONT ) +
+            (glyph_h * glyph_w_bytes * (1 + glyphs_count)) );
+         maug_cleanup_if_null_alloc( MAUG_MHANDLE, *p_font_h );
+
+         maug_mlock( *p_font_h, font );
+         maug_cleanup_if_null_alloc( struct RETROFONT*, font );
+         *p_font = font;
+
+         /* Set initial font parameters. */
+         font->sz = sizeof( struct RETROFONT );
+         font->first_glyph = first_glyph;
+         font->last_glyph = first_glyph + glyphs_count;
+         font->glyph_w = glyph_w_bytes * 8;
+         font->glyph_h = glyph_h;
+         font->glyph_sz = glyph_h * glyph_w_bytes;
+         font->glyphs_count = 0;
+      }
+
+      if( glyph_idx > first_glyph + glyphs_count ) {
+         *p_done = 1;
+         i = buf_sz;
+         break;
+      } else if(
+         glyph_idx < first_glyph ||
+         (size_t)(font->glyph_sz << 1) > hex_end - hex_start
+      ) {
+         /* Skip glyph out of range or too short. */
+         goto next_line;
+      }
+
+      /* Decode straight into the glyph's place in the font. */
+      p_glyph = retrofont_glyph_at( font, glyph_idx );
+      for( j = 0 ; font->glyph_sz > j ; j++ ) {
+         p_glyph[j] = (maug_hctoi( buf[hex_start + (j << 1)] ) << 4) |
+            maug_hctoi( buf[hex_start + (j << 1) + 1] );
+      }
+
+#if 0 < RETROFONT_TRACE_LVL
+      /* Test dump to verify glyph integrity. */
+      if( glyph_idx == '0' ) {
+         retrofont_dump_glyph( p_glyph, font->glyph_w, font->glyph_h );
+      }
+#endif
+
+      font->glyphs_count++;
+
+next_line:
+      i = line_end + 1;
    }
 
-   /* Try to separate the string into index:glyph bytes.  */
-   #define retrofont_split_glyph_line( line, line_bytes ) \
-      line_bytes = maug_strchr( line, ':' ); \
-      if( NULL == line_bytes ) { \
-         error_printf( "invalid line: %s", line ); \
-         retval = MERROR_PARSE; \
-      } \
-      line_bytes[0] = '\0'; \
-      line_bytes++;
+   *p_consumed = buf_sz < i ? buf_sz : i;
 
-   retval = mfile_open_read( font_name, &font_file );
-   maug_cleanup_if_not_ok();
+cleanup:
 
-   /* Figure out font width from file and alloc just enough. */
-   retval = font_file.read_line( &font_file, line, RETROFONT_LINE_SZ, 0 );
-   maug_cleanup_if_not_ok();
-   retrofont_split_glyph_line( line, line_bytes );
+   return retval;
+}
+
+/**
+ * \brief Load a font blob written by retrofont_write_bin() with one read.
+ */
+static MERROR_RETVAL retrofont_load_bin(
+   mfile_t* p_font_file, MAUG_MHANDLE* p_font_h,
+   uint8_t glyph_h, uint16_t first_glyph, uint16_t glyphs_count
+) {
+   MERROR_RETVAL retval = MERROR_OK;
+   struct RETROFONT_BIN_HEADER header;
+   struct RETROFONT* font = NULL;
+
+   p_font_file->seek( p_font_file, 0 );
+   retval = p_font_file->read_int( p_font_file, (uint8_t*)&header,
+      sizeof( struct RETROFONT_BIN_HEADER ), MFILE_READ_FLAG_LSBF );
    maug_cleanup_if_not_ok();
-   glyph_w_bytes = (maug_strlen( line_bytes ) / glyph_h) >> 1; /* 2 hex per byte */
-   debug_printf( RETROFONT_TRACE_LVL, "glyph_w_bytes: %u", glyph_w_bytes );
-   glyph_w = glyph_w_bytes * 8;
 
-#if 0 < RETROFONT_TRACE_LVL
-   debug_printf( RETROFONT_TRACE_LVL, "glyph_w: %u, glyph_sz: %u",
-      glyph_w, glyph_h * glyph_w_bytes );
-#endif
+   if(
+      RETROFONT_BIN_VERSION != header.version ||
+      sizeof( struct RETROFONT ) != header.font_sz ||
+      sizeof( struct RETROFONT ) > header.data_sz ||
+      mfile_get_sz( p_font_file ) <
+         (off_t)(sizeof( struct RETROFONT_BIN_HEADER ) + header.data_sz)
+   ) {
+      error_printf( "font blob does not match this build!" );
+      retval = MERROR_FILE;
+      goto cleanup;
+   }
 
-   /* Alloc enough for each glyph, plus the size of the font header. */
-   *p_font_h = maug_malloc( 1,
-      sizeof( struct RETROFONT ) +
-      (glyph_h * glyph_w_bytes * (1 + glyphs_count)) );
+   *p_font_h = maug_malloc( 1, header.data_sz );
    maug_cleanup_if_null_alloc( MAUG_MHANDLE, *p_font_h );
 
-#if 0 < RETROFONT_TRACE_LVL
-   debug_printf( RETROFONT_TRACE_LVL, "allocated font %s: " SIZE_T_FMT " bytes",
-      font_name, (glyph_h * glyph_w_bytes * (1 + glyphs_count)) + 
-         sizeof( struct RETROFONT ) );
-#endif
-
    maug_mlock( *p_font_h, font );
    maug_cleanup_if_null_alloc( struct RETROFONT*, font );
 
-   /* Set initial font parameters. */
-   font->sz = sizeof( struct RETROFONT );
-   font->first_glyph = first_glyph;
-   font->glyph_w = glyph_w;
-   font->glyph_h = glyph_h;
-   font->glyph_sz = glyph_h * glyph_w_bytes;
+   retval = p_font_file->read_int(
+      p_font_file, (uint8_t*)font, header.data_sz, MFILE_READ_FLAG_LSBF );
+   maug_cleanup_if_not_ok();
 
-   while( mfile_has_bytes( &font_file ) ) {
-      retval = font_file.read_line( &font_file, line, RETROFONT_LINE_SZ, 0 );
+   if(
+      (0 != glyph_h && glyph_h != font->glyph_h) ||
+      first_glyph != font->first_glyph ||
+      (uint16_t)(first_glyph + glyphs_count) > font->last_glyph ||
+      header.data_sz < font->sz + ((uint32_t)font->glyph_sz *
+         (1 + font->last_glyph - font->first_glyph))
+   ) {
+      error_printf( "font blob does not match requested glyphs!" );
+      retval = MERROR_FILE;
+      goto cleanup;
+   }
 
-      retrofont_split_glyph_line( line, line_bytes );
-      if( MERROR_PARSE == retval ) {
-         /* The line couldn't parse, so skip it, but don't give up entirely and
-          * keep going to the next line.
-          */
-         retval = MERROR_OK;
-         continue;
-      }
+   debug_printf( RETROFONT_TRACE_LVL, "loaded font blob: %u glyphs",
+      font->glyphs_count );
 
-      /* Figure out the index of this glyph. */
-      glyph_idx = maug_atou32( line, 0, 16 );
-      if( glyph_idx < first_glyph || glyph_idx > first_glyph + glyphs_count ) {
-         /* Skip glyph out of range. */
-         continue;
-      }
+cleanup:
 
-      debug_printf( RETROFONT_TRACE_LVL, "found glyph: %u", glyph_idx );
+   if( NULL != font ) {
+      maug_munlock( *p_font_h, font );
+   }
 
-      /* Find where to put the decoded glyph. */
-      p_glyph = retrofont_glyph_at( font, glyph_idx );
+   if( MERROR_OK != retval && (MAUG_MHANDLE)NULL != *p_font_h ) {
+      maug_mfree( *p_font_h );
+      *p_font_h = (MAUG_MHANDLE)NULL;
+   }
 
-      for( i = 0 ; font->glyph_h > i ; i++ ) {
-         switch( font->glyph_w ) {
-         case 8:
-            p_glyph[i] = 0;
-            p_glyph[i] |= maug_hctoi( line_bytes[i << 1] ) << 4;
-            p_glyph[i] |= maug_hctoi( line_bytes[(i << 1) + 1] );
-            break;
+   return retval;
+}
 
-         case 16:
-            /* TODO */
-            break;
+MERROR_RETVAL retrofont_load(
+   const char* font_name, MAUG_MHANDLE* p_font_h,
+   uint8_t glyph_h, uint16_t first_glyph, uint16_t glyphs_count
+) {
+   MERROR_RETVAL retval = MERROR_OK;
+   mfile_t font_file;
+   char buf[RETROFONT_READ_BUF_SZ];
+   struct RETROFONT* font = NULL;
+   size_t buf_sz = 0,
+      consumed = 0,
+      read_sz = 0;
+   off_t read_pos = 0;
+   uint8_t done = 0;
 
-         case 32:
-            /* TODO */
-            break;
+   maug_mzero( &font_file, sizeof( mfile_t ) );
 
-         default:
-            error_printf( "invalid font width: %u", font->glyph_w );
-            retval = MERROR_PARSE;
-            goto cleanup;
-         }
-      }
+   retval = mfile_open_read( font_name, &font_file );
+   maug_cleanup_if_not_ok();
 
-#if 0 < RETROFONT_TRACE_LVL
-      /* Test dump to verify glyph integrity. */
-      if( glyph_idx == '0' ) {
-         retrofont_dump_glyph( p_glyph, glyph_w, glyph_h );
+   /* Check for a precompiled blob before treating the file as .hex. */
+   if( sizeof( struct RETROFONT_BIN_HEADER ) <= mfile_get_sz( &font_file ) ) {
+      retval = font_file.read_int(
+         &font_file, (uint8_t*)buf, 4, MFILE_READ_FLAG_LSBF );
+      maug_cleanup_if_not_ok();
+      if( 0 == memcmp( buf, RETROFONT_BIN_MAGIC, 4 ) ) {
+         retval = retrofont_load_bin(
+            &font_file, p_font_h, glyph_h, first_glyph, glyphs_count );
+         goto cleanup;
       }
-#endif
+      font_file.seek( &font_file, 0 );
+   }
 
-      font->glyphs_count++;
+   if( 0 == glyph_h ) {
+      glyph_h = retrofont_sz_from_filename( font_name );
+   }
+   if( 0 == glyph_h ) {
+      error_printf( "unable to determine font height!" );
+      retval = MERROR_GUI;
+      goto cleanup;
+   }
 
-      debug_printf( RETROFONT_TRACE_LVL,
-         "parsed %u glyphs...", font->glyphs_count );
+   if( MFILE_CADDY_TYPE_MEM_BUFFER == font_file.type ) {
+      /* The whole file is already in memory, so decode it in place. */
+      retval = retrofont_parse_hex(
+         (const char*)font_file.mem_buffer, font_file.sz, 1, &consumed,
+         &done, p_font_h, &font, glyph_h, first_glyph, glyphs_count );
+      maug_cleanup_if_not_ok();
+
+   } else {
+      /* Read the file in big chunks and decode whole lines from each,
+       * carrying any partial line over to the next chunk.
+       */
+      while( !done ) {
+         read_sz = RETROFONT_READ_BUF_SZ - buf_sz;
+         if( (off_t)read_sz > mfile_get_sz( &font_file ) - read_pos ) {
+            read_sz = mfile_get_sz( &font_file ) - read_pos;
+         }
+         if( 0 < read_sz ) {
+            retval = font_file.read_int( &font_file,
+               (uint8_t*)&(buf[buf_sz]), read_sz, MFILE_READ_FLAG_LSBF );
+            maug_cleanup_if_not_ok();
+            buf_sz += read_sz;
+            read_pos += read_sz;
+         }
 
-      /* If we're not tracing, try to omit printfs from the inner loop! */
-#if 0 < RETROFONT_TRACE_LVL
-      debug_printf( RETROFONT_TRACE_LVL,
-         "%u %s (" SIZE_T_FMT " hbytes)", glyph_idx - first_glyph, line_bytes,
-         maug_strlen( line_bytes ) );
-#endif
+         retval = retrofont_parse_hex(
+            buf, buf_sz, read_pos >= mfile_get_sz( &font_file ), &consumed,
+            &done, p_font_h, &font, glyph_h, first_glyph, glyphs_count );
+         maug_cleanup_if_not_ok();
+
+         if( read_pos >= mfile_get_sz( &font_file ) ) {
+            break;
+         } else if( 0 == consumed && RETROFONT_READ_BUF_SZ == buf_sz ) {
+            error_printf( "font line longer than read buffer!" );
+            retval = MERROR_OVERFLOW;
+            goto cleanup;
+         }
+
+         memmove( buf, &(buf[consumed]), buf_sz - consumed );
+         buf_sz -= consumed;
+      }
+   }
+
+   if( NULL == font ) {
+      error_printf( "no glyphs found in font: %s", font_name );
+      retval = MERROR_PARSE;
+      goto cleanup;
    }
 
+   debug_printf( RETROFONT_TRACE_LVL, "parsed %u glyphs...",
+      font->glyphs_count );
+
 cleanup:
 
    if( NULL != font ) {
@@ -272,6 +577,54 @@ cleanup:
    return retval;
 }
 
+MERROR_RETVAL retrofont_write_bin( const char* filename, MAUG_MHANDLE font_h ) {
+   MERROR_RETVAL retval = MERROR_OK;
+   struct RETROFONT_BIN_HEADER header;
+   struct RETROFONT* font = NULL;
+   FILE* bin_file = NULL;
+
+   maug_mlock( font_h, font );
+   maug_cleanup_if_null_alloc( struct RETROFONT*, font );
+
+   maug_mzero( &header, sizeof( struct RETROFONT_BIN_HEADER ) );
+   memcpy( header.magic, RETROFONT_BIN_MAGIC, 4 );
+   header.version = RETROFONT_BIN_VERSION;
+   header.font_sz = sizeof( struct RETROFONT );
+   /* Glyphs are stored by index, so write the whole requested range even if
+    * some of it was missing from the file.
+    */
+   header.data_sz = font->sz + ((uint32_t)font->glyph_sz *
+      (1 + font->last_glyph - font->first_glyph));
+
+   bin_file = fopen( filename, "wb" );
+   if( NULL == bin_file ) {
+      error_printf( "could not open font blob for writing: %s", filename );
+      retval = MERROR_FILE;
+      goto cleanup;
+   }
+
+   if(
+      1 != fwrite(
+         &header, sizeof( struct RETROFONT_BIN_HEADER ), 1, bin_file ) ||
+      1 != fwrite( font, header.data_sz, 1, bin_file )
+   ) {
+      error_printf( "could not write font blob!" );
+      retval = MERROR_FILE;
+   }
+
+cleanup:
+
+   if( NULL != bin_file ) {
+      fclose( bin_file );
+   }
+
+   if( NULL != font ) {
+      maug_munlock( font_h, font );
+   }
+
+   return retval;
+}
+
 void retrofont_blit_glyph(
    struct RETROFLAT_BITMAP* target, RETROFLAT_COLOR color,
    char c, struct RETROFONT* font, size_t x, size_t y, uint8_t flags
@@ -325,6 +678,176 @@ void retrofont_blit_glyph(
    }
 }
 
+#  ifndef RETROFONT_NO_CACHE
+
+/**
+ * \brief Find the atlas for the given font, color, and outline flag, drawing
+ *        a new one over the least recently used atlas if needed.
+ * \return The atlas, or NULL if it could not be created. The caller should
+ *         then draw glyphs directly.
+ */
+static struct RETROFONT_CACHE* retrofont_cache_get(
+   MAUG_MHANDLE font_h, struct RETROFONT* font, RETROFLAT_COLOR color,
+   uint8_t flags
+) {
+   MERROR_RETVAL retval = MERROR_OK;
+   struct RETROFONT_CACHE* entry = NULL;
+   size_t i = 0;
+   uint16_t glyph_iter = 0;
+   uint16_t cells_per_row = 0;
+   uint16_t rows = 0;
+   uint8_t cell_w = 0;
+   uint8_t cell_h = 0;
+   uint8_t y_off = 0;
+
+   flags &= RETROFONT_FLAG_OUTLINE;
+   gs_retrofont_cache_uses++;
+
+   for( i = 0 ; RETROFONT_CACHE_ENTRIES_MAX > i ; i++ ) {
+      if(
+         font_h == gs_retrofont_cache[i].font_h &&
+         color == gs_retrofont_cache[i].color &&
+         flags == gs_retrofont_cache[i].flags
+      ) {
+         gs_retrofont_cache[i].last_use = gs_retrofont_cache_uses;
+         return &(gs_retrofont_cache[i]);
+      }
+   }
+
+   if( !retrofont_cache_color_ok( color ) || 0 == font->glyphs_count ) {
+      return NULL;
+   }
+
+   /* Outlines extend one pixel right, above, and below the glyph. */
+   y_off = RETROFONT_FLAG_OUTLINE == flags ? 1 : 0;
+   cell_w = font->glyph_w + y_off;
+   cell_h = font->glyph_h + (2 * y_off);
+   if( RETROFONT_CACHE_ATLAS_W < cell_w ) {
+      return NULL;
+   }
+   cells_per_row = RETROFONT_CACHE_ATLAS_W / cell_w;
+   rows = (font->glyphs_count + cells_per_row - 1) / cells_per_row;
+
+   /* Take an unused entry, or else the least recently used one. */
+   entry = &(gs_retrofont_cache[0]);
+   for( i = 0 ; RETROFONT_CACHE_ENTRIES_MAX > i ; i++ ) {
+      if( (MAUG_MHANDLE)NULL == gs_retrofont_cache[i].font_h ) {
+         entry = &(gs_retrofont_cache[i]);
+         break;
+      } else if( gs_retrofont_cache[i].last_use < entry->last_use ) {
+         entry = &(gs_retrofont_cache[i]);
+      }
+   }
+
+   if( (MAUG_MHANDLE)NULL != entry->font_h ) {
+      debug_printf( RETROFONT_TRACE_LVL, "evicting glyph atlas: %p, %d",
+         entry->font_h, entry->color );
+      retroflat_destroy_bitmap( &(entry->atlas) );
+      entry->font_h = (MAUG_MHANDLE)NULL;
+   }
+
+   debug_printf( RETROFONT_TRACE_LVL,
+      "drawing glyph atlas: %p, %d, %u x %u",
+      font_h, color, cells_per_row * cell_w, rows * cell_h );
+
+   /* Create a transparent bitmap to draw on. */
+   retval = retroflat_create_bitmap(
+      cells_per_row * cell_w, rows * cell_h, &(entry->atlas), 0 );
+   if( MERROR_OK != retval ) {
+      error_printf( "could not create glyph atlas!" );
+      return NULL;
+   }
+
+   /* Normally draw lock is called from the main loop, but we're making an
+    * off-screen bitmap, here!
+    */
+   retroflat_draw_lock( &(entry->atlas) );
+   retroflat_px_lock( &(entry->atlas) );
+
+   for( glyph_iter = 0 ; font->glyphs_count > glyph_iter ; glyph_iter++ ) {
+      retrofont_blit_glyph(
+         &(entry->atlas), color, (char)(font->first_glyph + glyph_iter), font,
+         (glyph_iter % cells_per_row) * cell_w,
+         ((glyph_iter / cells_per_row) * cell_h) + y_off, flags );
+   }
+
+   retroflat_px_release( &(entry->atlas) );
+   retroflat_draw_release( &(entry->atlas) );
+
+   entry->color = color;
+   entry->flags = flags;
+   entry->last_use = gs_retrofont_cache_uses;
+   entry->first_glyph = font->first_glyph;
+   entry->glyphs_count = font->glyphs_count;
+   entry->cell_w = cell_w;
+   entry->cell_h = cell_h;
+   entry->cells_per_row = cells_per_row;
+   entry->font_h = font_h;
+
+   return entry;
+}
+
+/**
+ * \brief Blit a glyph from an atlas so it lines up with where
+ *        retrofont_blit_glyph() would have drawn it.
+ */
+static void retrofont_cache_blit(
+   struct RETROFONT_CACHE* entry, struct RETROFLAT_BITMAP* target,
+   char c, size_t x, size_t y
+) {
+   size_t glyph_idx = (uint8_t)c - entry->first_glyph,
+      s_x = 0,
+      s_y = 0,
+      h = entry->cell_h;
+
+   s_x = (glyph_idx % entry->cells_per_row) * entry->cell_w;
+   s_y = (glyph_idx / entry->cells_per_row) * entry->cell_h;
+
+   if( RETROFONT_FLAG_OUTLINE == entry->flags ) {
+      /* The cell starts with the outline row above the glyph. */
+      if( 0 < y ) {
+         y--;
+      } else {
+         s_y++;
+         h--;
+      }
+   }
+
+   retroflat_blit_bitmap(
+      target, &(entry->atlas), s_x, s_y, x, y, entry->cell_w, h,
+      RETROFLAT_INSTANCE_NULL );
+}
+
+#  endif /* !RETROFONT_NO_CACHE */
+
+void retrofont_cache_free( MAUG_MHANDLE font_h ) {
+#  ifndef RETROFONT_NO_CACHE
+   size_t i = 0;
+
+   for( i = 0 ; RETROFONT_CACHE_ENTRIES_MAX > i ; i++ ) {
+      if(
+         (MAUG_MHANDLE)NULL == gs_retrofont_cache[i].font_h || (
+            (MAUG_MHANDLE)NULL != font_h &&
+            font_h != gs_retrofont_cache[i].font_h
+         )
+      ) {
+         continue;
+      }
+      retroflat_destroy_bitmap( &(gs_retrofont_cache[i].atlas) );
+      gs_retrofont_cache[i].font_h = (MAUG_MHANDLE)NULL;
+   }
+
+   for( i = 0 ; RETROFONT_SZ_CACHE_MAX > i ; i++ ) {
+      if(
+         (MAUG_MHANDLE)NULL == font_h ||
+         font_h == gs_retrofont_sz_cache[i].font_h
+      ) {
+         gs_retrofont_sz_cache[i].font_h = (MAUG_MHANDLE)NULL;
+      }
+   }
+#  endif /* !RETROFONT_NO_CACHE */
+}
+
 void retrofont_string(
    struct RETROFLAT_BITMAP* target, RETROFLAT_COLOR color,
    const char* str, size_t str_sz,
@@ -335,6 +858,11 @@ void retrofont_string(
    size_t x_iter = x;
    size_t y_iter = y;
    struct RETROFONT* font = NULL;
+#  ifndef RETROFONT_NO_CACHE
+   struct RETROFONT_CACHE* cache = NULL;
+   /* Locking NULLs font_h, so keep a copy to key the cache on. */
+   MAUG_MHANDLE cache_font_h = font_h;
+#  endif /* !RETROFONT_NO_CACHE */
 
    if( (MAUG_MHANDLE)NULL == font_h ) {
       error_printf( "NULL font specified!" );
@@ -351,6 +879,10 @@ void retrofont_string(
       goto cleanup;
    }
 
+#  ifndef RETROFONT_NO_CACHE
+   cache = retrofont_cache_get( cache_font_h, font, color, flags );
+#  endif /* !RETROFONT_NO_CACHE */
+
    /* TODO: Stop at max_w/max_h */
 
    for( i = 0 ; str_sz > i ; i++ ) {
@@ -382,8 +914,17 @@ void retrofont_string(
 
       /* TODO: More dynamic way to determine space character? */
       if( ' ' != str[i] ) {
+#  ifndef RETROFONT_NO_CACHE
+         if( NULL != cache ) {
+            retrofont_cache_blit( cache, target, str[i], x_iter, y_iter );
+         } else {
+            retrofont_blit_glyph(
+               target, color, str[i], font, x_iter, y_iter, flags );
+         }
+#  else
          retrofont_blit_glyph(
             target, color, str[i], font, x_iter, y_iter, flags );
+#  endif /* !RETROFONT_NO_CACHE */
       }
 
       x_iter += font->glyph_w;
@@ -409,6 +950,15 @@ MERROR_RETVAL retrofont_string_sz(
    size_t i = 0;
    MERROR_RETVAL retval = MERROR_OK;
    struct RETROFONT* font = NULL;
+   size_t line_w = 0;
+   size_t lines_h = 0;
+   ssize_t wrap_h = -1;
+#  ifndef RETROFONT_NO_CACHE
+   struct RETROFONT_SZ_CACHE* sz_cache = NULL;
+   uint32_t str_hash = 0;
+   /* Locking NULLs font_h, so keep a copy to key the cache on. */
+   MAUG_MHANDLE cache_font_h = font_h;
+#  endif /* !RETROFONT_NO_CACHE */
 
    if( (MAUG_MHANDLE)NULL == font_h ) {
       error_printf( "NULL font specified!" );
@@ -420,42 +970,83 @@ MERROR_RETVAL retrofont_string_sz(
       str_sz = maug_strlen( str );
    }
 
-   maug_mlock( font_h, font );
-   maug_cleanup_if_null_alloc( struct RETROFONT*, font );
-
+   /* Only measure up to a premature null. */
    for( i = 0 ; str_sz > i ; i++ ) {
-      /* Terminate prematurely at null. */
       if( '\0' == str[i] ) {
+         str_sz = i;
          break;
       }
+   }
+
+#  ifndef RETROFONT_NO_CACHE
+   str_hash = mdata_hash( str, str_sz );
+   sz_cache = &(gs_retrofont_sz_cache[str_hash % RETROFONT_SZ_CACHE_MAX]);
+   if(
+      cache_font_h == sz_cache->font_h &&
+      str_hash == sz_cache->str_hash &&
+      str_sz == sz_cache->str_sz &&
+      max_w == sz_cache->max_w &&
+      max_h == sz_cache->max_h
+   ) {
+      line_w = sz_cache->w;
+      lines_h = sz_cache->h;
+      wrap_h = sz_cache->wrap_h;
+      goto apply_sz;
+   }
+#  endif /* !RETROFONT_NO_CACHE */
 
+   maug_mlock( font_h, font );
+   maug_cleanup_if_null_alloc( struct RETROFONT*, font );
+
+   for( i = 0 ; str_sz > i ; i++ ) {
       /* Handle forced newline. */
       if( '\r' == str[i] || '\n' == str[i] ) {
          x_iter = 0;
-         *out_h_p += font->glyph_h;
+         lines_h += font->glyph_h;
          continue;
       }
 
       x_iter += font->glyph_w;
 
-      if( *out_w_p <= x_iter ) {
-         *out_w_p = x_iter;
+      if( line_w <= x_iter ) {
+         line_w = x_iter;
       }
       if( 0 < max_w && max_w < x_iter + font->glyph_w ) {
          x_iter = 0;
-         *out_h_p += font->glyph_h;
-         if( 0 < max_h && *out_h_p + font->glyph_h >= max_h && i < str_sz ) {
-            error_printf( "string will not fit!" );
-
-            /* Do not quit; just make a note and keep going. */
-            retval = MERROR_GUI;
-         }
+         lines_h += font->glyph_h;
+         /* Remember how tall the text was here for the fit check below. */
+         wrap_h = lines_h + font->glyph_h;
       }
    }
 
    /* Add the height of the last line. */
-   *out_h_p += font->glyph_h;
+   lines_h += font->glyph_h;
+
+#  ifndef RETROFONT_NO_CACHE
+   sz_cache->font_h = cache_font_h;
+   sz_cache->str_hash = str_hash;
+   sz_cache->str_sz = str_sz;
+   sz_cache->max_w = max_w;
+   sz_cache->max_h = max_h;
+   sz_cache->w = line_w;
+   sz_cache->h = lines_h;
+   sz_cache->wrap_h = wrap_h;
+
+apply_sz:
+#  endif /* !RETROFONT_NO_CACHE */
+
+   if( 0 < max_h && 0 <= wrap_h && *out_h_p + wrap_h >= max_h ) {
+      error_printf( "string will not fit!" );
+
+      /* Do not quit; just make a note and keep going. */
+      retval = MERROR_GUI;
+   }
+
+   if( *out_w_p < line_w ) {
+      *out_w_p = line_w;
+   }
    *out_w_p += 1;
+   *out_h_p += lines_h;
 
 cleanup:
 
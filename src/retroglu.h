@@ -26,6 +26,14 @@
 #  define RETROGLU_TRACE_LVL 0
 #endif /* !RETROGLU_TRACE_LVL */
 
+#ifndef RETROGLU_MESH_HASH_BUF_SZ
+/**
+ * \brief Size of the stack buffer used to read OBJ/MTL sources when checking
+ *        them against a mesh cache.
+ */
+#  define RETROGLU_MESH_HASH_BUF_SZ 1024
+#endif /* !RETROGLU_MESH_HASH_BUF_SZ */
+
 #ifndef RETROGLU_SPRITE_TEX_FRAMES_SZ
 #  define RETROGLU_SPRITE_TEX_FRAMES_SZ 10
 #endif /* !RETROGLU_SPRITE_TEX_FRAMES_SZ */
@@ -95,6 +103,14 @@
 #  define RETROGLU_MATERIAL_LIB_SZ_MAX 32
 #endif /* !RETROGLU_MATERIAL_LIB_SZ_MAX */
 
+#ifndef RETROGLU_MESH_EXT
+/**
+ * \brief Extension appended to an OBJ filename to get the filename of its
+ *        compiled mesh cache. See retroglu_load_obj_cached().
+ */
+#  define RETROGLU_MESH_EXT "rglm"
+#endif /* !RETROGLU_MESH_EXT */
+
 typedef float RETROGLU_COLOR[4];
 
 struct RETROGLU_VERTEX {
@@ -151,6 +167,8 @@ struct RETROGLU_OBJ {
    uint16_t faces_sz;
    struct RETROGLU_MATERIAL materials[RETROGLU_MATERIALS_SZ_MAX];
    uint16_t materials_sz;
+   /*! \brief Filename of the last material library loaded by the parser. */
+   char mtllib[RETROGLU_MATERIAL_LIB_SZ_MAX];
 };
 
 /**
@@ -204,6 +222,49 @@ struct RETROGLU_TILE {
    struct RETROFLAT_BITMAP texture;
 };
 
+/**
+ * \addtogroup maug_retroglu_batch RetroGLU Sprite Batches
+ * \brief Accumulate textured quads from shared texture pages (e.g. the
+ *        retrogxc atlas) and draw them with one call per page.
+ * \{
+ */
+
+#ifndef RETROGLU_BATCH_PAGES_MAX
+/**
+ * \brief Maximum number of different textures a ::RETROGLU_BATCH can draw
+ *        from between flushes.
+ */
+#  define RETROGLU_BATCH_PAGES_MAX 8
+#endif /* !RETROGLU_BATCH_PAGES_MAX */
+
+struct RETROGLU_BATCH_VERTEX {
+   float x;
+   float y;
+   float s;
+   float t;
+};
+
+/**
+ * \brief Two triangles, laid out so a vector of quads can be handed
+ *        straight to glDrawArrays().
+ */
+struct RETROGLU_BATCH_QUAD {
+   struct RETROGLU_BATCH_VERTEX v[6];
+};
+
+struct RETROGLU_BATCH_PAGE {
+   uint32_t tex_id;
+   /*! \brief Vector of ::RETROGLU_BATCH_QUAD to draw from this texture. */
+   struct MDATA_VECTOR quads;
+};
+
+struct RETROGLU_BATCH {
+   struct RETROGLU_BATCH_PAGE pages[RETROGLU_BATCH_PAGES_MAX];
+   size_t pages_sz;
+};
+
+/*! \} */ /* maug_retroglu_batch */
+
 
 /*! \} */ /* maug_retroglu_sprite */
 
@@ -351,6 +412,45 @@ struct RETROGLU_PARSER {
 
 typedef int (*retroglu_token_cb)( struct RETROGLU_PARSER* parser );
 
+/**
+ * \addtogroup maug_retroglu_mesh RetroGLU Mesh Cache
+ * \brief Compiled binary copies of parsed OBJ files.
+ *
+ * A mesh cache file is a ::RETROGLU_MESH_HEADER followed by the vertex,
+ * normal, texture coordinate, face, and material blocks of a ::RETROGLU_OBJ,
+ * in that order, with the sizes given in the header. Blocks are stored in the
+ * native layout of the program that wrote them, so caches are only valid
+ * for the build that created them. The struct sizes in the header are used
+ * to detect this.
+ * \{
+ */
+
+#define RETROGLU_MESH_VERSION 1
+
+struct RETROGLU_MESH_HEADER {
+   /*! \brief Always "RGLM". */
+   char magic[4];
+   uint16_t version;
+   uint16_t header_sz;
+   uint16_t vertex_sz;
+   uint16_t vtexture_sz;
+   uint16_t face_sz;
+   uint16_t material_sz;
+   /*! \brief Combined size of the OBJ and MTL source files in bytes. */
+   uint32_t src_sz;
+   /*! \brief mdata_hash() of the OBJ and MTL source files, in that order. */
+   uint32_t src_hash;
+   uint16_t vertices_sz;
+   uint16_t vnormals_sz;
+   uint16_t vtextures_sz;
+   uint16_t faces_sz;
+   uint16_t materials_sz;
+   /*! \brief Material library the OBJ loaded, to include it in src_hash. */
+   char mtllib[RETROGLU_MATERIAL_LIB_SZ_MAX];
+};
+
+/*! \} */ /* maug_retroglu_mesh */
+
 void retroglu_init_scene( uint8_t flags );
 void retroglu_init_projection( struct RETROGLU_PROJ_ARGS* args );
 
@@ -380,6 +480,52 @@ MERROR_RETVAL retroglu_parse_obj_file(
 
 /*! \} */ /* maug_retroglu_obj_fsm */
 
+/**
+ * \addtogroup maug_retroglu_mesh
+ * \{
+ */
+
+/**
+ * \brief Hash OBJ and MTL source files under the assets path to validate a
+ *        mesh cache against.
+ * \param mtllib Material library filename, or NULL/empty if none.
+ */
+MERROR_RETVAL retroglu_hash_obj_src(
+   const char* filename, const char* mtllib,
+   uint32_t* p_src_sz, uint32_t* p_src_hash );
+
+/**
+ * \brief Write the given parsed object to a mesh cache file.
+ * \param filename Full path of the mesh cache file to write.
+ */
+MERROR_RETVAL retroglu_write_mesh(
+   const char* filename, struct RETROGLU_OBJ* obj,
+   uint32_t src_sz, uint32_t src_hash );
+
+/**
+ * \brief Read a mesh cache file into the given object.
+ * \param filename Full path of the mesh cache file to read.
+ * \param obj_src Name of the OBJ under the assets path the cache was written
+ *                from. If this is not NULL, the cache is only loaded if the
+ *                source still matches the hash stored in it.
+ * \return MERROR_OK if the mesh was loaded, or MERROR_FILE if the cache is
+ *         missing, stale, or was written by an incompatible build.
+ */
+MERROR_RETVAL retroglu_read_mesh(
+   const char* filename, const char* obj_src, struct RETROGLU_OBJ* obj );
+
+/**
+ * \brief Load an OBJ file from its mesh cache if the cache is up to date,
+ *        or parse it with retroglu_parse_obj_file() and write a new cache.
+ *
+ * The cache is written next to the OBJ with ::RETROGLU_MESH_EXT appended to
+ * its filename. Failure to write the cache is not fatal.
+ */
+MERROR_RETVAL retroglu_load_obj_cached(
+   const char* filename, struct RETROGLU_OBJ* obj );
+
+/*! \} */ /* maug_retroglu_mesh */
+
 void retroglu_draw_poly( struct RETROGLU_OBJ* obj );
 
 void retroglu_set_tile_clip(
@@ -441,15 +587,80 @@ void retroglu_string(
 
 MERROR_RETVAL retroglu_check_errors( const char* desc );
 
+/**
+ * \brief Grow the dirty area of a texture to include the given rectangle,
+ *        so it is uploaded on the next retroglu_draw_release().
+ */
+void retroglu_tex_dirty(
+   struct RETROFLAT_GLTEX* tex, size_t x, size_t y, size_t w, size_t h );
+
+#define retroglu_tex_is_dirty( tex ) \
+   ((tex)->dirty_x2 > (tex)->dirty_x1 && (tex)->dirty_y2 > (tex)->dirty_y1)
+
+#define retroglu_tex_clean( tex ) \
+   do { \
+      (tex)->dirty_x1 = 0; \
+      (tex)->dirty_y1 = 0; \
+      (tex)->dirty_x2 = 0; \
+      (tex)->dirty_y2 = 0; \
+   } while( 0 )
+
 /* int retroglu_draw_lock( struct RETROFLAT_BITMAP* bmp ); */
 
 int retroglu_draw_release( struct RETROFLAT_BITMAP* bmp );
 
 MERROR_RETVAL retroglu_blit_bitmap(
    struct RETROFLAT_BITMAP* target, struct RETROFLAT_BITMAP* src,
-   size_t s_x, size_t s_y, size_t d_x, size_t d_y, size_t w, size_t h,
+   size_t s_x, size_t s_y, int16_t d_x, int16_t d_y, size_t w, size_t h,
    int16_t instance );
 
+/**
+ * \brief Fill a horizontal run of w pixels starting at x, y on a locked
+ *        bitmap, growing the dirty area once for the whole run.
+ *
+ * The first pixel is written from the texture palette and then copied in
+ * doubling blocks, so a run costs a handful of memcpy() calls rather than
+ * one retroglu_px() per pixel. Runs are clipped to the texture.
+ */
+void retroglu_hspan(
+   struct RETROFLAT_BITMAP* target, const RETROFLAT_COLOR color_idx,
+   size_t x, size_t y, size_t w );
+
+/**
+ * \brief Write a row of w palette indexes starting at x, y on a locked
+ *        bitmap, skipping pixels equal to txp_idx (or none if it is
+ *        ::RETROFLAT_COLOR_NULL). The row is clipped to the texture.
+ */
+void retroglu_idx_row(
+   struct RETROFLAT_BITMAP* target, const uint8_t* idx_row,
+   size_t x, size_t y, size_t w, RETROFLAT_COLOR txp_idx );
+
+/**
+ * \addtogroup maug_retroglu_batch
+ * \{
+ */
+
+/**
+ * \brief Add a quad to the batch that draws the given area of page to the
+ *        given area of the screen on the next retroglu_batch_flush().
+ *
+ * Coordinates are in the same pixels as retroflat_blit_bitmap(), with the
+ *  origin in the upper left of the screen.
+ */
+MERROR_RETVAL retroglu_batch_quad(
+   struct RETROGLU_BATCH* batch, struct RETROFLAT_BITMAP* page,
+   size_t s_x, size_t s_y, int16_t d_x, int16_t d_y, size_t w, size_t h );
+
+/**
+ * \brief Draw all quads in the batch to the screen with one bind and one
+ *        draw per page, then empty the batch for the next frame.
+ */
+MERROR_RETVAL retroglu_batch_flush( struct RETROGLU_BATCH* batch );
+
+void retroglu_batch_free( struct RETROGLU_BATCH* batch );
+
+/*! \} */ /* maug_retroglu_batch */
+
 #ifdef RETROGLU_C
 
 #  define RETROFLAT_COLOR_TABLE_GL( idx, name_l, name_u, r, g, b, cgac, cgad ) \
@@ -685,6 +896,10 @@ retroglu_parse_token( struct RETROGLU_PARSER* parser ) {
 
       debug_printf(
          RETROGLU_TRACE_LVL, "parsing material lib: %s", parser->token );
+      maug_strncpy(
+         parser->obj->mtllib, parser->token,
+         sizeof( parser->obj->mtllib ) );
+      parser->obj->mtllib[sizeof( parser->obj->mtllib ) - 1] = '\0';
       retroglu_parser_state( parser, RETROGLU_PARSER_STATE_NONE );
       assert( NULL != parser->load_mtl );
       return parser->load_mtl( parser->token, parser, parser->load_mtl_data );
@@ -997,6 +1212,288 @@ cleanup:
    return retval;
 }
 
+/* === */
+
+/* Continue *p_src_hash with the contents of filename, and add its size to
+ * *p_src_sz.
+ */
+static MERROR_RETVAL _retroglu_hash_file(
+   const char* filename, uint32_t* p_src_sz, uint32_t* p_src_hash
+) {
+   MERROR_RETVAL retval = MERROR_OK;
+   char filename_path[RETROFLAT_PATH_MAX + 1];
+   uint8_t buf[RETROGLU_MESH_HASH_BUF_SZ];
+   off_t read_sz = 0,
+      read_total = 0;
+   mfile_t src_file;
+
+   maug_mzero( &src_file, sizeof( mfile_t ) );
+
+   maug_mzero( filename_path, RETROFLAT_PATH_MAX + 1 );
+   maug_snprintf( filename_path, RETROFLAT_PATH_MAX, "%s%c%s",
+      g_retroflat_state->assets_path, RETROFLAT_PATH_SEP, filename );
+
+   retval = mfile_open_read( filename_path, &src_file );
+   maug_cleanup_if_not_ok();
+
+   /* Hash the file in large chunks rather than byte-by-byte. */
+   while( mfile_has_bytes( &src_file ) ) {
+      read_sz = mfile_get_sz( &src_file ) - read_total;
+      if( RETROGLU_MESH_HASH_BUF_SZ < read_sz ) {
+         read_sz = RETROGLU_MESH_HASH_BUF_SZ;
+      }
+      retval = src_file.read_int(
+         &src_file, buf, read_sz, MFILE_READ_FLAG_LSBF );
+      maug_cleanup_if_not_ok();
+      *p_src_hash = mdata_hash_cont( *p_src_hash, buf, read_sz );
+      read_total += read_sz;
+   }
+
+   *p_src_sz += read_total;
+
+cleanup:
+
+   mfile_close( &src_file );
+
+   return retval;
+}
+
+/* === */
+
+MERROR_RETVAL retroglu_hash_obj_src(
+   const char* filename, const char* mtllib,
+   uint32_t* p_src_sz, uint32_t* p_src_hash
+) {
+   MERROR_RETVAL retval = MERROR_OK;
+
+   *p_src_sz = 0;
+   *p_src_hash = MDATA_HASH_INIT;
+
+   retval = _retroglu_hash_file( filename, p_src_sz, p_src_hash );
+   maug_cleanup_if_not_ok();
+
+   if( NULL != mtllib && '\0' != mtllib[0] ) {
+      retval = _retroglu_hash_file( mtllib, p_src_sz, p_src_hash );
+      maug_cleanup_if_not_ok();
+   }
+
+   debug_printf( RETROGLU_TRACE_LVL,
+      "hashed %s: " UPRINTF_U32_FMT " bytes, hash: 0x%08x",
+      filename, *p_src_sz, *p_src_hash );
+
+cleanup:
+
+   return retval;
+}
+
+/* === */
+
+#define retroglu_mesh_header_check_sz( header, field, type ) \
+   if( sizeof( type ) != (header)->field ) { \
+      error_printf( "mesh cache " #type " size mismatch!" ); \
+      retval = MERROR_FILE; \
+      goto cleanup; \
+   }
+
+#define RETROGLU_MESH_BLOCKS( f ) \
+   f( vertices, vertices_sz, RETROGLU_VERTICES_SZ_MAX ) \
+   f( vnormals, vnormals_sz, RETROGLU_VERTICES_SZ_MAX ) \
+   f( vtextures, vtextures_sz, RETROGLU_VERTICES_SZ_MAX ) \
+   f( faces, faces_sz, RETROGLU_FACES_SZ_MAX ) \
+   f( materials, materials_sz, RETROGLU_MATERIALS_SZ_MAX )
+
+MERROR_RETVAL retroglu_write_mesh(
+   const char* filename, struct RETROGLU_OBJ* obj,
+   uint32_t src_sz, uint32_t src_hash
+) {
+   MERROR_RETVAL retval = MERROR_OK;
+   struct RETROGLU_MESH_HEADER header;
+   FILE* mesh_file = NULL;
+
+   maug_mzero( &header, sizeof( struct RETROGLU_MESH_HEADER ) );
+   header.magic[0] = 'R';
+   header.magic[1] = 'G';
+   header.magic[2] = 'L';
+   header.magic[3] = 'M';
+   header.version = RETROGLU_MESH_VERSION;
+   header.header_sz = sizeof( struct RETROGLU_MESH_HEADER );
+   header.vertex_sz = sizeof( struct RETROGLU_VERTEX );
+   header.vtexture_sz = sizeof( struct RETROGLU_VTEXTURE );
+   header.face_sz = sizeof( struct RETROGLU_FACE );
+   header.material_sz = sizeof( struct RETROGLU_MATERIAL );
+   header.src_sz = src_sz;
+   header.src_hash = src_hash;
+   header.vertices_sz = obj->vertices_sz;
+   header.vnormals_sz = obj->vnormals_sz;
+   header.vtextures_sz = obj->vtextures_sz;
+   header.faces_sz = obj->faces_sz;
+   header.materials_sz = obj->materials_sz;
+   maug_strncpy( header.mtllib, obj->mtllib, sizeof( header.mtllib ) );
+   header.mtllib[sizeof( header.mtllib ) - 1] = '\0';
+
+   mesh_file = fopen( filename, "wb" );
+   maug_cleanup_if_null_file( mesh_file );
+
+   if( 1 != fwrite(
+      &header, sizeof( struct RETROGLU_MESH_HEADER ), 1, mesh_file
+   ) ) {
+      error_printf( "could not write mesh header!" );
+      retval = MERROR_FILE;
+      goto cleanup;
+   }
+
+#  define RETROGLU_MESH_BLOCKS_WRITE( array, sz, sz_max ) \
+   if( \
+      0 < obj->sz && \
+      obj->sz != fwrite( obj->array, sizeof( obj->array[0] ), \
+         obj->sz, mesh_file ) \
+   ) { \
+      error_printf( "could not write mesh " #array "!" ); \
+      retval = MERROR_FILE; \
+      goto cleanup; \
+   }
+
+   RETROGLU_MESH_BLOCKS( RETROGLU_MESH_BLOCKS_WRITE )
+
+   debug_printf( 1, "wrote mesh cache: %s", filename );
+
+cleanup:
+
+   if( NULL != mesh_file ) {
+      fclose( mesh_file );
+   }
+
+   return retval;
+}
+
+/* === */
+
+MERROR_RETVAL retroglu_read_mesh(
+   const char* filename, const char* obj_src, struct RETROGLU_OBJ* obj
+) {
+   MERROR_RETVAL retval = MERROR_OK;
+   struct RETROGLU_MESH_HEADER header;
+   uint32_t src_sz = 0,
+      src_hash = 0;
+   mfile_t mesh_file;
+
+   maug_mzero( &mesh_file, sizeof( mfile_t ) );
+
+   retval = mfile_open_read( filename, &mesh_file );
+   maug_cleanup_if_not_ok();
+
+   if( sizeof( struct RETROGLU_MESH_HEADER ) > mfile_get_sz( &mesh_file ) ) {
+      error_printf( "mesh cache too small!" );
+      retval = MERROR_FILE;
+      goto cleanup;
+   }
+
+   retval = mesh_file.read_int( &mesh_file, (uint8_t*)&header,
+      sizeof( struct RETROGLU_MESH_HEADER ), MFILE_READ_FLAG_LSBF );
+   maug_cleanup_if_not_ok();
+
+   if(
+      'R' != header.magic[0] || 'G' != header.magic[1] ||
+      'L' != header.magic[2] || 'M' != header.magic[3] ||
+      RETROGLU_MESH_VERSION != header.version
+   ) {
+      error_printf( "invalid mesh cache header!" );
+      retval = MERROR_FILE;
+      goto cleanup;
+   }
+
+   retroglu_mesh_header_check_sz(
+      &header, header_sz, struct RETROGLU_MESH_HEADER );
+   retroglu_mesh_header_check_sz( &header, vertex_sz, struct RETROGLU_VERTEX );
+   retroglu_mesh_header_check_sz(
+      &header, vtexture_sz, struct RETROGLU_VTEXTURE );
+   retroglu_mesh_header_check_sz( &header, face_sz, struct RETROGLU_FACE );
+   retroglu_mesh_header_check_sz(
+      &header, material_sz, struct RETROGLU_MATERIAL );
+
+   /* Make sure strings from the file are terminated. */
+   header.mtllib[RETROGLU_MATERIAL_LIB_SZ_MAX - 1] = '\0';
+
+   if( NULL != obj_src ) {
+      retval = retroglu_hash_obj_src(
+         obj_src, header.mtllib, &src_sz, &src_hash );
+      maug_cleanup_if_not_ok();
+
+      if( header.src_sz != src_sz || header.src_hash != src_hash ) {
+         debug_printf( 1, "mesh cache %s is stale!", filename );
+         retval = MERROR_FILE;
+         goto cleanup;
+      }
+   }
+
+   /* Read each block straight into the object arrays. */
+#  define RETROGLU_MESH_BLOCKS_READ( array, sz, sz_max ) \
+   if( sz_max < header.sz ) { \
+      error_printf( "mesh cache " #array " exceeds " #sz_max "!" ); \
+      retval = MERROR_OVERFLOW; \
+      goto cleanup; \
+   } \
+   obj->sz = header.sz; \
+   if( 0 < obj->sz ) { \
+      retval = mesh_file.read_int( &mesh_file, (uint8_t*)(obj->array), \
+         sizeof( obj->array[0] ) * obj->sz, MFILE_READ_FLAG_LSBF ); \
+      maug_cleanup_if_not_ok(); \
+   }
+
+   RETROGLU_MESH_BLOCKS( RETROGLU_MESH_BLOCKS_READ )
+
+   maug_strncpy( obj->mtllib, header.mtllib, RETROGLU_MATERIAL_LIB_SZ_MAX );
+
+   debug_printf( 1, "loaded mesh cache %s: %u vertices, %u faces",
+      filename, obj->vertices_sz, obj->faces_sz );
+
+cleanup:
+
+   mfile_close( &mesh_file );
+
+   return retval;
+}
+
+/* === */
+
+MERROR_RETVAL retroglu_load_obj_cached(
+   const char* filename, struct RETROGLU_OBJ* obj
+) {
+   MERROR_RETVAL retval = MERROR_OK;
+   char mesh_path[RETROFLAT_PATH_MAX + 1];
+   uint32_t src_sz = 0,
+      src_hash = 0;
+
+   maug_mzero( mesh_path, RETROFLAT_PATH_MAX + 1 );
+   maug_snprintf( mesh_path, RETROFLAT_PATH_MAX, "%s%c%s.%s",
+      g_retroflat_state->assets_path, RETROFLAT_PATH_SEP, filename,
+      RETROGLU_MESH_EXT );
+
+   if( MERROR_OK == retroglu_read_mesh( mesh_path, filename, obj ) ) {
+      goto cleanup;
+   }
+
+   /* Cache missing or stale, so parse the source the long way. */
+   maug_mzero( obj, sizeof( struct RETROGLU_OBJ ) );
+   retval = retroglu_parse_obj_file( filename, NULL, obj );
+   maug_cleanup_if_not_ok();
+
+   if(
+      MERROR_OK == retroglu_hash_obj_src(
+         filename, obj->mtllib, &src_sz, &src_hash ) &&
+      MERROR_OK != retroglu_write_mesh( mesh_path, obj, src_sz, src_hash )
+   ) {
+      /* Not fatal; we'll just parse again next time. */
+      error_printf( "unable to write mesh cache: %s", mesh_path );
+   }
+
+cleanup:
+
+   return retval;
+}
+
+/* === */
+
 void retroglu_draw_poly( struct RETROGLU_OBJ* obj ) {
    int i = 0;
    int j = 0;
@@ -1598,6 +2095,45 @@ MERROR_RETVAL retroglu_check_errors( const char* desc ) {
 
 /* === */
 
+void retroglu_tex_dirty(
+   struct RETROFLAT_GLTEX* tex, size_t x, size_t y, size_t w, size_t h
+) {
+
+   /* Clip to the texture. */
+   if( x >= tex->w || y >= tex->h || 0 == w || 0 == h ) {
+      return;
+   }
+   if( x + w > tex->w ) {
+      w = tex->w - x;
+   }
+   if( y + h > tex->h ) {
+      h = tex->h - y;
+   }
+
+   if( !retroglu_tex_is_dirty( tex ) ) {
+      tex->dirty_x1 = x;
+      tex->dirty_y1 = y;
+      tex->dirty_x2 = x + w;
+      tex->dirty_y2 = y + h;
+      return;
+   }
+
+   if( x < tex->dirty_x1 ) {
+      tex->dirty_x1 = x;
+   }
+   if( y < tex->dirty_y1 ) {
+      tex->dirty_y1 = y;
+   }
+   if( x + w > tex->dirty_x2 ) {
+      tex->dirty_x2 = x + w;
+   }
+   if( y + h > tex->dirty_y2 ) {
+      tex->dirty_y2 = y + h;
+   }
+}
+
+/* === */
+
 MERROR_RETVAL retroglu_draw_lock( struct RETROFLAT_BITMAP* bmp ) {
    MERROR_RETVAL retval = RETROFLAT_OK;
 
@@ -1642,11 +2178,37 @@ MERROR_RETVAL retroglu_draw_release( struct RETROFLAT_BITMAP* bmp ) {
       assert( 0 < bmp->tex.id );
       assert( NULL != bmp->tex.bytes );
 
-      /* Update stored texture if it exists. */
-      glBindTexture( GL_TEXTURE_2D, bmp->tex.id );
-      glTexImage2D( GL_TEXTURE_2D, 0, GL_RGBA, bmp->tex.w, bmp->tex.h, 0,
-         GL_RGBA, GL_UNSIGNED_BYTE, bmp->tex.bytes ); 
-      glBindTexture( GL_TEXTURE_2D, 0 );
+      /* Update only the part of the stored texture that was drawn on since
+       * the last upload.
+       */
+      if( retroglu_tex_is_dirty( &(bmp->tex) ) ) {
+         debug_printf( RETROGLU_TRACE_LVL,
+            "uploading texture " UPRINTF_U32_FMT " area: " SIZE_T_FMT ", "
+               SIZE_T_FMT " to " SIZE_T_FMT ", " SIZE_T_FMT,
+            bmp->tex.id, bmp->tex.dirty_x1, bmp->tex.dirty_y1,
+            bmp->tex.dirty_x2, bmp->tex.dirty_y2 );
+         glBindTexture( GL_TEXTURE_2D, bmp->tex.id );
+#     ifdef GL_UNPACK_ROW_LENGTH
+         glPixelStorei( GL_UNPACK_ROW_LENGTH, bmp->tex.w );
+         glTexSubImage2D( GL_TEXTURE_2D, 0,
+            bmp->tex.dirty_x1, bmp->tex.dirty_y1,
+            bmp->tex.dirty_x2 - bmp->tex.dirty_x1,
+            bmp->tex.dirty_y2 - bmp->tex.dirty_y1,
+            GL_RGBA, GL_UNSIGNED_BYTE,
+            &(bmp->tex.bytes[
+               ((bmp->tex.dirty_y1 * bmp->tex.w) + bmp->tex.dirty_x1) * 4]) );
+         glPixelStorei( GL_UNPACK_ROW_LENGTH, 0 );
+#     else
+         /* Can't skip pixels inside of a row, so upload whole rows. */
+         glTexSubImage2D( GL_TEXTURE_2D, 0,
+            0, bmp->tex.dirty_y1,
+            bmp->tex.w, bmp->tex.dirty_y2 - bmp->tex.dirty_y1,
+            GL_RGBA, GL_UNSIGNED_BYTE,
+            &(bmp->tex.bytes[bmp->tex.dirty_y1 * bmp->tex.w * 4]) );
+#     endif /* GL_UNPACK_ROW_LENGTH */
+         glBindTexture( GL_TEXTURE_2D, 0 );
+         retroglu_tex_clean( &(bmp->tex) );
+      }
 #  endif /* !RETROGLU_NO_TEXTURE_LISTS */
 
       /* Unlock texture bitmap. */
@@ -1858,6 +2420,16 @@ MERROR_RETVAL retroglu_create_bitmap(
       "assigned bitmap texture: " UPRINTF_U32_FMT, bmp_out->tex.id );
    retval = retroglu_check_errors( "gentextures" );
    maug_cleanup_if_not_ok();
+
+   /* Allocate texture storage up front so retroglu_draw_release() only has
+    * to upload the parts that get drawn on.
+    */
+   glBindTexture( GL_TEXTURE_2D, bmp_out->tex.id );
+   glTexImage2D( GL_TEXTURE_2D, 0, GL_RGBA, bmp_out->tex.w, bmp_out->tex.h, 0,
+      GL_RGBA, GL_UNSIGNED_BYTE, bmp_out->tex.bytes ); 
+   glBindTexture( GL_TEXTURE_2D, 0 );
+   retval = retroglu_check_errors( "teximage" );
+   maug_cleanup_if_not_ok();
 #     endif /* !RETROGLU_NO_TEXTURE_LISTS */
 
 cleanup:
@@ -1882,6 +2454,7 @@ void retroglu_destroy_bitmap( struct RETROFLAT_BITMAP* bmp ) {
    
    if( NULL != bmp->tex.bytes_h ) {
       maug_mfree( bmp->tex.bytes_h );
+      bmp->tex.bytes_h = NULL;
    }
 
 #  ifndef RETROGLU_NO_TEXTURE_LISTS
@@ -1898,13 +2471,15 @@ void retroglu_destroy_bitmap( struct RETROFLAT_BITMAP* bmp ) {
 
 MERROR_RETVAL retroglu_blit_bitmap(
    struct RETROFLAT_BITMAP* target, struct RETROFLAT_BITMAP* src,
-   size_t s_x, size_t s_y, size_t d_x, size_t d_y, size_t w, size_t h,
+   size_t s_x, size_t s_y, int16_t d_x, int16_t d_y, size_t w, size_t h,
    int16_t instance
 ) {
    MERROR_RETVAL retval = MERROR_OK;
-   int y_iter = 0;
-
-   /* TODO: Check memcpy, etc? */
+   size_t y_iter = 0,
+      x_iter = 0,
+      run_start = 0;
+   uint8_t* src_row = NULL;
+   uint8_t* target_row = NULL;
 
    if( NULL == target || retroflat_screen_buffer() == target ) {
       /* TODO: Create ortho sprite on screen. */
@@ -1914,20 +2489,78 @@ MERROR_RETVAL retroglu_blit_bitmap(
 
       assert( NULL != target->tex.bytes );
 
+      /* Clip the blit to both bitmaps so the row copies stay in bounds,
+       * starting with anything off the top or left of the target.
+       */
+      if( 0 > d_x ) {
+         if( w <= (size_t)-d_x ) {
+            goto cleanup;
+         }
+         s_x += -d_x;
+         w -= -d_x;
+         d_x = 0;
+      }
+      if( 0 > d_y ) {
+         if( h <= (size_t)-d_y ) {
+            goto cleanup;
+         }
+         s_y += -d_y;
+         h -= -d_y;
+         d_y = 0;
+      }
+      if(
+         s_x >= src->tex.w || s_y >= src->tex.h ||
+         (size_t)d_x >= target->tex.w || (size_t)d_y >= target->tex.h
+      ) {
+         goto cleanup;
+      }
+      if( s_x + w > src->tex.w ) {
+         w = src->tex.w - s_x;
+      }
+      if( (size_t)d_x + w > target->tex.w ) {
+         w = target->tex.w - d_x;
+      }
+      if( s_y + h > src->tex.h ) {
+         h = src->tex.h - s_y;
+      }
+      if( (size_t)d_y + h > target->tex.h ) {
+         h = target->tex.h - d_y;
+      }
+
       /* TODO: Some kind of source-autolock? */
       assert( !retroflat_bitmap_locked( src ) );
       maug_mlock( src->tex.bytes_h, src->tex.bytes );
       for( y_iter = 0 ; h > y_iter ; y_iter++ ) {
-         /* TODO: Handle transparency! */
-         memcpy(
-            &(target->tex.bytes[(((y_iter * target->tex.w) + d_x) * 4)]),
-            &(src->tex.bytes[(((y_iter * src->tex.w) + s_x) * 4)]),
-            w * 4 );
+         src_row = &(src->tex.bytes[(((s_y + y_iter) * src->tex.w) + s_x) * 4]);
+         target_row = &(target->tex.bytes[
+            ((((d_y + y_iter) * target->tex.w) + d_x) * 4)]);
+
+         /* Copy runs of opaque pixels, skipping ones with 0 alpha so
+          * glyphs and sprites keep their transparency.
+          */
+         x_iter = 0;
+         while( w > x_iter ) {
+            while( w > x_iter && 0 == src_row[(x_iter * 4) + 3] ) {
+               x_iter++;
+            }
+            run_start = x_iter;
+            while( w > x_iter && 0 != src_row[(x_iter * 4) + 3] ) {
+               x_iter++;
+            }
+            if( x_iter > run_start ) {
+               memcpy(
+                  &(target_row[run_start * 4]), &(src_row[run_start * 4]),
+                  (x_iter - run_start) * 4 );
+            }
+         }
       }
       maug_munlock( src->tex.bytes_h, src->tex.bytes );
 
+      retroglu_tex_dirty( &(target->tex), d_x, d_y, w, h );
    }
 
+cleanup:
+
    return retval;
 }
 
@@ -1960,6 +2593,283 @@ void retroglu_px(
 
    /* Set pixel as opaque. */
    target->tex.bytes[(((y * target->tex.w) + x) * 4) + 3] = 0xff;
+
+   retroglu_tex_dirty( &(target->tex), x, y, 1, 1 );
+}
+
+/* === */
+
+void retroglu_hspan(
+   struct RETROFLAT_BITMAP* target, const RETROFLAT_COLOR color_idx,
+   size_t x, size_t y, size_t w
+) {
+   uint8_t* row = NULL;
+   size_t copied = 1,
+      copy_sz = 0;
+
+   if(
+      RETROFLAT_FLAGS_BITMAP_RO ==
+         (RETROFLAT_FLAGS_BITMAP_RO & target->flags) ||
+      target->tex.w <= x ||
+      target->tex.h <= y ||
+      0 == w
+   ) {
+      return;
+   }
+
+   if( x + w > target->tex.w ) {
+      w = target->tex.w - x;
+   }
+
+   assert( NULL != target->tex.bytes );
+
+   row = &(target->tex.bytes[((y * target->tex.w) + x) * 4]);
+
+   /* Draw the first pixel from the texture palette. */
+   row[0] = g_retroflat_state->tex_palette[color_idx][0];
+   row[1] = g_retroflat_state->tex_palette[color_idx][1];
+   row[2] = g_retroflat_state->tex_palette[color_idx][2];
+   row[3] = 0xff;
+
+   /* Copy what's already filled onto the rest of the run, doubling each
+    * time.
+    */
+   while( w > copied ) {
+      copy_sz = w - copied < copied ? w - copied : copied;
+      memcpy( &(row[copied * 4]), row, copy_sz * 4 );
+      copied += copy_sz;
+   }
+
+   retroglu_tex_dirty( &(target->tex), x, y, w, 1 );
+}
+
+/* === */
+
+void retroglu_idx_row(
+   struct RETROFLAT_BITMAP* target, const uint8_t* idx_row,
+   size_t x, size_t y, size_t w, RETROFLAT_COLOR txp_idx
+) {
+   uint8_t* row = NULL;
+   size_t i = 0;
+
+   if(
+      RETROFLAT_FLAGS_BITMAP_RO ==
+         (RETROFLAT_FLAGS_BITMAP_RO & target->flags) ||
+      target->tex.w <= x ||
+      target->tex.h <= y ||
+      0 == w
+   ) {
+      return;
+   }
+
+   if( x + w > target->tex.w ) {
+      w = target->tex.w - x;
+   }
+
+   assert( NULL != target->tex.bytes );
+
+   row = &(target->tex.bytes[((y * target->tex.w) + x) * 4]);
+
+   for( i = 0 ; w > i ; i++ ) {
+      if( txp_idx == idx_row[i] ) {
+         continue;
+      }
+      assert( RETROFLAT_COLORS_SZ > idx_row[i] );
+      row[(i * 4) + 0] = g_retroflat_state->tex_palette[idx_row[i]][0];
+      row[(i * 4) + 1] = g_retroflat_state->tex_palette[idx_row[i]][1];
+      row[(i * 4) + 2] = g_retroflat_state->tex_palette[idx_row[i]][2];
+      row[(i * 4) + 3] = 0xff;
+   }
+
+   retroglu_tex_dirty( &(target->tex), x, y, w, 1 );
+}
+
+/* === */
+
+MERROR_RETVAL retroglu_batch_quad(
+   struct RETROGLU_BATCH* batch, struct RETROFLAT_BITMAP* page,
+   size_t s_x, size_t s_y, int16_t d_x, int16_t d_y, size_t w, size_t h
+) {
+   MERROR_RETVAL retval = MERROR_OK;
+   struct RETROGLU_BATCH_QUAD quad;
+   size_t i = 0;
+   ssize_t append_retval = 0;
+   float s1 = 0,
+      t1 = 0,
+      s2 = 0,
+      t2 = 0;
+
+   assert( NULL != page );
+   assert( 0 < page->tex.w && 0 < page->tex.h );
+
+   /* Find the page this texture is drawn on, or start a new one. */
+   for( i = 0 ; batch->pages_sz > i ; i++ ) {
+      if( batch->pages[i].tex_id == page->tex.id ) {
+         break;
+      }
+   }
+   if( i == batch->pages_sz ) {
+      if( RETROGLU_BATCH_PAGES_MAX <= batch->pages_sz ) {
+         error_printf( "too many textures in batch!" );
+         retval = MERROR_OVERFLOW;
+         goto cleanup;
+      }
+      batch->pages[i].tex_id = page->tex.id;
+      batch->pages_sz++;
+   }
+
+   s1 = (float)s_x / page->tex.w;
+   t1 = (float)s_y / page->tex.h;
+   s2 = (float)(s_x + w) / page->tex.w;
+   t2 = (float)(s_y + h) / page->tex.h;
+
+   /* Upper Left */
+   quad.v[0].x = d_x;
+   quad.v[0].y = d_y;
+   quad.v[0].s = s1;
+   quad.v[0].t = t1;
+
+   /* Lower Left */
+   quad.v[1].x = d_x;
+   quad.v[1].y = d_y + h;
+   quad.v[1].s = s1;
+   quad.v[1].t = t2;
+
+   /* Lower Right */
+   quad.v[2].x = d_x + w;
+   quad.v[2].y = d_y + h;
+   quad.v[2].s = s2;
+   quad.v[2].t = t2;
+
+   /* Lower Right */
+   quad.v[3] = quad.v[2];
+
+   /* Upper Right */
+   quad.v[4].x = d_x + w;
+   quad.v[4].y = d_y;
+   quad.v[4].s = s2;
+   quad.v[4].t = t1;
+
+   /* Upper Left */
+   quad.v[5] = quad.v[0];
+
+   append_retval = mdata_vector_append(
+      &(batch->pages[i].quads), &quad, sizeof( struct RETROGLU_BATCH_QUAD ) );
+   retval = mdata_retval( append_retval );
+
+cleanup:
+
+   return retval;
+}
+
+/* === */
+
+MERROR_RETVAL retroglu_batch_flush( struct RETROGLU_BATCH* batch ) {
+   MERROR_RETVAL retval = MERROR_OK;
+   struct RETROGLU_BATCH_PAGE* page = NULL;
+   struct RETROGLU_BATCH_QUAD* quads = NULL;
+   GLboolean depth_test = GL_FALSE;
+   size_t i = 0;
+#  ifdef RETROGLU_NO_VERTEX_ARRAYS
+   size_t j = 0,
+      k = 0;
+#  endif /* RETROGLU_NO_VERTEX_ARRAYS */
+
+   /* Switch to an ortho projection measured in screen pixels. */
+   glMatrixMode( GL_PROJECTION );
+   glPushMatrix();
+   glLoadIdentity();
+   glOrtho( 0, retroflat_screen_w(), retroflat_screen_h(), 0, -1.0f, 1.0f );
+   glMatrixMode( GL_MODELVIEW );
+   glPushMatrix();
+   glLoadIdentity();
+
+   depth_test = glIsEnabled( GL_DEPTH_TEST );
+   glDisable( GL_DEPTH_TEST );
+   glColor3f( 1.0f, 1.0f, 1.0f );
+
+#  ifndef RETROGLU_NO_VERTEX_ARRAYS
+   glEnableClientState( GL_VERTEX_ARRAY );
+   glEnableClientState( GL_TEXTURE_COORD_ARRAY );
+#  endif /* !RETROGLU_NO_VERTEX_ARRAYS */
+
+   for( i = 0 ; batch->pages_sz > i ; i++ ) {
+      page = &(batch->pages[i]);
+      if( 0 == mdata_vector_ct( &(page->quads) ) ) {
+         continue;
+      }
+
+      debug_printf( RETROGLU_TRACE_LVL,
+         "flushing " SIZE_T_FMT " quads from texture " UPRINTF_U32_FMT,
+         mdata_vector_ct( &(page->quads) ), page->tex_id );
+
+      glBindTexture( GL_TEXTURE_2D, page->tex_id );
+      glTexEnvf( GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE );
+      glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST );
+      glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST );
+
+      mdata_vector_lock( &(page->quads) );
+      quads = (struct RETROGLU_BATCH_QUAD*)(page->quads.data_bytes);
+
+#  ifdef RETROGLU_NO_VERTEX_ARRAYS
+      glBegin( GL_TRIANGLES );
+      for( j = 0 ; mdata_vector_ct( &(page->quads) ) > j ; j++ ) {
+         for( k = 0 ; 6 > k ; k++ ) {
+            glTexCoord2f( quads[j].v[k].s, quads[j].v[k].t );
+            glVertex2f( quads[j].v[k].x, quads[j].v[k].y );
+         }
+      }
+      glEnd();
+#  else
+      glVertexPointer( 2, GL_FLOAT, sizeof( struct RETROGLU_BATCH_VERTEX ),
+         &(quads[0].v[0].x) );
+      glTexCoordPointer( 2, GL_FLOAT, sizeof( struct RETROGLU_BATCH_VERTEX ),
+         &(quads[0].v[0].s) );
+      glDrawArrays( GL_TRIANGLES, 0, mdata_vector_ct( &(page->quads) ) * 6 );
+#  endif /* RETROGLU_NO_VERTEX_ARRAYS */
+
+      mdata_vector_unlock( &(page->quads) );
+      quads = NULL;
+
+      /* Keep the allocation around for the next frame. */
+      page->quads.ct = 0;
+   }
+
+cleanup:
+
+   if( NULL != quads ) {
+      mdata_vector_unlock( &(page->quads) );
+   }
+
+#  ifndef RETROGLU_NO_VERTEX_ARRAYS
+   glDisableClientState( GL_TEXTURE_COORD_ARRAY );
+   glDisableClientState( GL_VERTEX_ARRAY );
+#  endif /* !RETROGLU_NO_VERTEX_ARRAYS */
+
+   glBindTexture( GL_TEXTURE_2D, 0 );
+
+   if( depth_test ) {
+      glEnable( GL_DEPTH_TEST );
+   }
+
+   glPopMatrix();
+   glMatrixMode( GL_PROJECTION );
+   glPopMatrix();
+   glMatrixMode( GL_MODELVIEW );
+
+   return retval;
+}
+
+/* === */
+
+void retroglu_batch_free( struct RETROGLU_BATCH* batch ) {
+   size_t i = 0;
+
+   for( i = 0 ; batch->pages_sz > i ; i++ ) {
+      mdata_vector_free( &(batch->pages[i].quads) );
+   }
+
+   maug_mzero( batch, sizeof( struct RETROGLU_BATCH ) );
 }
 
 #else
@@ -15,6 +15,18 @@
 /*! \brief RETROGUI::flags indicating controls should be redrawn. */
 #define RETROGUI_FLAGS_DIRTY 0x01
 
+/**
+ * \brief RETROGUI::flags indicating only controls with
+ *        ::RETROGUI_CTL_FLAG_DIRTY set should be redrawn.
+ */
+#define RETROGUI_FLAGS_DIRTY_CTLS 0x02
+
+/**
+ * \brief RETROGUI_CTL_BASE::flags indicating the control should be redrawn
+ *        over its own area on the next retrogui_redraw_ctls().
+ */
+#define RETROGUI_CTL_FLAG_DIRTY 0x01
+
 #ifndef RETROGUI_TRACE_LVL
 #  define RETROGUI_TRACE_LVL 0
 #endif /* !RETROGUI_TRACE_LVL */
@@ -53,6 +65,25 @@
 
 #define retrogui_is_locked( gui ) (mdata_vector_is_locked( &((gui)->ctls) ))
 
+/**
+ * \brief Mark a single control to be redrawn, without redrawing the rest of
+ *        the GUI.
+ */
+#define retrogui_ctl_dirty( gui, ctl ) \
+   do { \
+      (ctl)->base.flags |= RETROGUI_CTL_FLAG_DIRTY; \
+      (gui)->flags |= RETROGUI_FLAGS_DIRTY_CTLS; \
+   } while( 0 )
+
+/**
+ * \brief Whether the areas of two controls overlap.
+ */
+#define retrogui_ctl_overlap( ctl_a, ctl_b ) \
+   ((ctl_a)->base.x < (ctl_b)->base.x + (ctl_b)->base.w && \
+   (ctl_b)->base.x < (ctl_a)->base.x + (ctl_a)->base.w && \
+   (ctl_a)->base.y < (ctl_b)->base.y + (ctl_b)->base.h && \
+   (ctl_b)->base.y < (ctl_a)->base.y + (ctl_a)->base.h)
+
 #define _retrogui_copy_str( field, src_str, dest_ctl, str_tmp, str_sz ) \
    /* Sanity checking. */ \
    assert( NULL != src_str ); \
@@ -124,6 +155,7 @@ typedef size_t retrogui_idc_t;
 /*! \brief Fields common to ALL ::RETROGUI_CTL types. */
 struct RETROGUI_CTL_BASE {
    uint8_t type;
+   uint8_t flags;
    retrogui_idc_t idc;
    size_t x;
    size_t y;
@@ -164,6 +196,13 @@ union RETROGUI_CTL {
 
 typedef void (*retrogui_xy_cb)( size_t* x, size_t* y, void* data );
 
+/*! \brief Entry in RETROGUI::ctls_idx pointing an IDC to its control. */
+struct RETROGUI_IDC_IDX {
+   retrogui_idc_t idc;
+   /*! \brief Index of the control in RETROGUI::ctls. */
+   size_t idx;
+};
+
 struct RETROGUI {
    uint8_t flags;
    size_t x;
@@ -173,6 +212,11 @@ struct RETROGUI {
    RETROFLAT_COLOR bg_color;
    retrogui_idc_t idc_prev;
    struct MDATA_VECTOR ctls;
+   /**
+    * \brief ::RETROGUI_IDC_IDX for each control in RETROGUI::ctls, sorted by
+    *        IDC so controls can be found without scanning.
+    */
+   struct MDATA_VECTOR ctls_idx;
    retrogui_idc_t focus;
    struct RETROFLAT_BITMAP* draw_bmp;
 #ifdef RETROGXC_PRESENT
@@ -650,7 +694,8 @@ static void retrogui_redraw_BUTTON(
       h = 0,
       text_offset = 0;
 
-   retroflat_rect( gui->draw_bmp, ctl->base.bg_color, ctl->base.x, ctl->base.y,
+   retroflat_rect( gui->draw_bmp, ctl->base.bg_color,
+      gui->x + ctl->base.x, gui->y + ctl->base.y,
       ctl->base.w, ctl->base.h, RETROFLAT_FLAGS_FILL );
 
    retroflat_rect( gui->draw_bmp, RETROFLAT_COLOR_BLACK,
@@ -667,7 +712,8 @@ static void retrogui_redraw_BUTTON(
          gui->x + ctl->base.x + 1, gui->y + ctl->base.y + 2,
          gui->x + ctl->base.x + 1, gui->y + ctl->base.y + ctl->base.h - 3, 0 );
 
-      gui->flags |= RETROGUI_FLAGS_DIRTY; /* Mark dirty for push animation. */
+      /* Mark dirty for push animation. */
+      retrogui_ctl_dirty( gui, ctl );
       ctl->BUTTON.push_frames--;
       text_offset = 1;
    } else {
@@ -1010,7 +1056,8 @@ cleanup:
       ctl->TEXTBOX.blink_frames = RETROGUI_CTL_TEXT_BLINK_FRAMES;
    }
    
-   gui->flags |= RETROGUI_FLAGS_DIRTY; /* Mark dirty for blink animation. */
+   /* Mark dirty for blink animation. */
+   retrogui_ctl_dirty( gui, ctl );
 
 #  endif
 
@@ -1223,22 +1270,175 @@ static MERROR_RETVAL retrogui_init_LABEL( union RETROGUI_CTL* ctl ) {
 
 /* === Static Internal Functions === */
 
-static union RETROGUI_CTL* _retrogui_get_ctl_by_idc(
-   struct RETROGUI* gui, size_t idc
+/**
+ * \brief Get the position of the first entry in RETROGUI::ctls_idx with an
+ *        IDC not less than idc. RETROGUI::ctls_idx must be locked.
+ */
+static size_t _retrogui_idx_lower_bound(
+   struct RETROGUI* gui, retrogui_idc_t idc
+) {
+   size_t lo = 0,
+      hi = mdata_vector_ct( &(gui->ctls_idx) ),
+      mid = 0;
+   struct RETROGUI_IDC_IDX* idc_idx = NULL;
+
+   assert( mdata_vector_is_locked( &(gui->ctls_idx) ) );
+
+   while( lo < hi ) {
+      mid = lo + ((hi - lo) >> 1);
+      idc_idx = mdata_vector_get(
+         &(gui->ctls_idx), mid, struct RETROGUI_IDC_IDX );
+      if( idc_idx->idc < idc ) {
+         lo = mid + 1;
+      } else {
+         hi = mid;
+      }
+   }
+
+   return lo;
+}
+
+/**
+ * \brief Get the index of a control in RETROGUI::ctls, or -1 if no control
+ *        has the given IDC.
+ */
+static ssize_t _retrogui_idx_find( struct RETROGUI* gui, retrogui_idc_t idc ) {
+   ssize_t idx_out = -1;
+   struct RETROGUI_IDC_IDX* idc_idx = NULL;
+   MERROR_RETVAL retval = MERROR_OK;
+
+   if( 0 == mdata_vector_ct( &(gui->ctls_idx) ) ) {
+      goto cleanup;
+   }
+
+   mdata_vector_lock( &(gui->ctls_idx) );
+
+   idc_idx = mdata_vector_get( &(gui->ctls_idx),
+      _retrogui_idx_lower_bound( gui, idc ), struct RETROGUI_IDC_IDX );
+   if( NULL != idc_idx && idc == idc_idx->idc ) {
+      idx_out = idc_idx->idx;
+   }
+
+cleanup:
+
+   mdata_vector_unlock( &(gui->ctls_idx) );
+
+   if( MERROR_OK != retval ) {
+      idx_out = -1;
+   }
+
+   return idx_out;
+}
+
+/**
+ * \brief Add an entry to RETROGUI::ctls_idx, keeping it sorted by IDC.
+ * \return MERROR_OK, or MERROR_GUI if a control already has the IDC.
+ */
+static MERROR_RETVAL _retrogui_idx_insert(
+   struct RETROGUI* gui, retrogui_idc_t idc, size_t ctl_idx
 ) {
+   MERROR_RETVAL retval = MERROR_OK;
+   ssize_t append_idx = 0;
    size_t i = 0;
-   union RETROGUI_CTL* ctl = NULL;
+   struct RETROGUI_IDC_IDX idc_idx_new;
+   struct RETROGUI_IDC_IDX* idc_idx = NULL;
+   struct RETROGUI_IDC_IDX* idc_idx_prev = NULL;
 
-   assert( retrogui_is_locked( gui ) );
+   if( 0 <= _retrogui_idx_find( gui, idc ) ) {
+      error_printf( "duplicate control IDC: " SIZE_T_FMT, idc );
+      retval = MERROR_GUI;
+      goto cleanup;
+   }
 
-   for( i = 0 ; mdata_vector_ct( &(gui->ctls) ) > i ; i++ ) {
-      ctl = mdata_vector_get( &(gui->ctls), i, union RETROGUI_CTL );
-      if( idc == ctl->base.idc ) {
+   idc_idx_new.idc = idc;
+   idc_idx_new.idx = ctl_idx;
+   append_idx = mdata_vector_append(
+      &(gui->ctls_idx), &idc_idx_new, sizeof( struct RETROGUI_IDC_IDX ) );
+   if( 0 > append_idx ) {
+      retval = mdata_retval( append_idx );
+      goto cleanup;
+   }
+
+   mdata_vector_lock( &(gui->ctls_idx) );
+
+   /* Move the new entry down until it's past all entries with lower IDCs. */
+   for( i = append_idx ; 0 < i ; i-- ) {
+      idc_idx_prev = mdata_vector_get(
+         &(gui->ctls_idx), i - 1, struct RETROGUI_IDC_IDX );
+      if( idc_idx_prev->idc < idc ) {
          break;
       }
-      ctl = NULL;
+      idc_idx = mdata_vector_get(
+         &(gui->ctls_idx), i, struct RETROGUI_IDC_IDX );
+      memcpy( idc_idx, idc_idx_prev, sizeof( struct RETROGUI_IDC_IDX ) );
+      memcpy( idc_idx_prev, &idc_idx_new, sizeof( struct RETROGUI_IDC_IDX ) );
+   }
+
+cleanup:
+
+   mdata_vector_unlock( &(gui->ctls_idx) );
+
+   return retval;
+}
+
+/**
+ * \brief Remove an entry from RETROGUI::ctls_idx, and update the entries
+ *        for the controls after it, which shift down in RETROGUI::ctls.
+ * \return Index the control had in RETROGUI::ctls, or -1 if not found.
+ */
+static ssize_t _retrogui_idx_remove( struct RETROGUI* gui, retrogui_idc_t idc ) {
+   ssize_t idx_out = -1;
+   size_t i = 0,
+      pos = 0;
+   struct RETROGUI_IDC_IDX* idc_idx = NULL;
+   MERROR_RETVAL retval = MERROR_OK;
+
+   if( 0 == mdata_vector_ct( &(gui->ctls_idx) ) ) {
+      goto cleanup;
+   }
+
+   mdata_vector_lock( &(gui->ctls_idx) );
+
+   pos = _retrogui_idx_lower_bound( gui, idc );
+   idc_idx = mdata_vector_get( &(gui->ctls_idx), pos, struct RETROGUI_IDC_IDX );
+   if( NULL == idc_idx || idc != idc_idx->idc ) {
+      goto cleanup;
+   }
+   idx_out = idc_idx->idx;
+
+   for( i = 0 ; mdata_vector_ct( &(gui->ctls_idx) ) > i ; i++ ) {
+      idc_idx = mdata_vector_get(
+         &(gui->ctls_idx), i, struct RETROGUI_IDC_IDX );
+      if( idc_idx->idx > (size_t)idx_out ) {
+         idc_idx->idx--;
+      }
    }
 
+   mdata_vector_unlock( &(gui->ctls_idx) );
+
+   retval = mdata_vector_remove( &(gui->ctls_idx), pos );
+
+cleanup:
+
+   mdata_vector_unlock( &(gui->ctls_idx) );
+
+   if( MERROR_OK != retval ) {
+      idx_out = -1;
+   }
+
+   return idx_out;
+}
+
+static union RETROGUI_CTL* _retrogui_get_ctl_by_idc(
+   struct RETROGUI* gui, size_t idc
+) {
+   union RETROGUI_CTL* ctl = NULL;
+
+   assert( retrogui_is_locked( gui ) );
+
+   ctl = mdata_vector_get( &(gui->ctls),
+      _retrogui_idx_find( gui, idc ), union RETROGUI_CTL );
+
    if( NULL == ctl ) {
       retroflat_message( RETROFLAT_MSG_FLAG_ERROR, "Error",
          "Could not find GUI item: " SIZE_T_FMT, idc );
@@ -1332,12 +1532,12 @@ retrogui_idc_t retrogui_poll_ctls(
 
    #define RETROGUI_CTL_TABLE_CLICK( idx, c_name, c_fields ) \
       } else if( RETROGUI_CTL_TYPE_ ## c_name == ctl->base.type ) { \
-         gui->flags |= RETROGUI_FLAGS_DIRTY; \
+         retrogui_ctl_dirty( gui, ctl ); \
          idc_out = retrogui_click_ ## c_name( gui, ctl, p_input, input_evt );
 
    #define RETROGUI_CTL_TABLE_KEY( idx, c_name, c_fields ) \
       } else if( RETROGUI_CTL_TYPE_ ## c_name == ctl->base.type ) { \
-         gui->flags |= RETROGUI_FLAGS_DIRTY; \
+         retrogui_ctl_dirty( gui, ctl ); \
          idc_out = retrogui_key_ ## c_name( ctl, p_input, input_evt );
 
    if( 0 == *p_input ) {
@@ -1349,6 +1549,14 @@ retrogui_idc_t retrogui_poll_ctls(
       RETROFLAT_MOUSE_B_RIGHT == *p_input
    ) {
       /* Remove all focus before testing if a new control has focus. */
+      if( RETROGUI_IDC_NONE != gui->focus ) {
+         /* Redraw the control losing focus, e.g. to hide its cursor. */
+         ctl = mdata_vector_get( &(gui->ctls),
+            _retrogui_idx_find( gui, gui->focus ), union RETROGUI_CTL );
+         if( NULL != ctl ) {
+            retrogui_ctl_dirty( gui, ctl );
+         }
+      }
       gui->focus = RETROGUI_IDC_NONE;
 
       mouse_x = input_evt->mouse_x - gui->x;
@@ -1421,12 +1629,58 @@ cleanup:
    return idc_out;
 }
 
+/**
+ * \brief Mark every control overlapping a dirty control dirty too, since
+ *        clearing the dirty control's area would erase part of it.
+ *
+ * Repeats until nothing changes, as newly dirty controls clear their own
+ * areas as well.
+ */
+static void _retrogui_dirty_overlaps( struct RETROGUI* gui ) {
+   size_t i = 0,
+      j = 0;
+   union RETROGUI_CTL* ctl = NULL;
+   union RETROGUI_CTL* other = NULL;
+   uint8_t changed = 1;
+
+   while( changed ) {
+      changed = 0;
+      for( i = 0 ; mdata_vector_ct( &(gui->ctls) ) > i ; i++ ) {
+         ctl = mdata_vector_get( &(gui->ctls), i, union RETROGUI_CTL );
+         if(
+            RETROGUI_CTL_FLAG_DIRTY !=
+               (RETROGUI_CTL_FLAG_DIRTY & ctl->base.flags)
+         ) {
+            continue;
+         }
+
+         for( j = 0 ; mdata_vector_ct( &(gui->ctls) ) > j ; j++ ) {
+            other = mdata_vector_get( &(gui->ctls), j, union RETROGUI_CTL );
+            if(
+               RETROGUI_CTL_FLAG_DIRTY !=
+                  (RETROGUI_CTL_FLAG_DIRTY & other->base.flags) &&
+               retrogui_ctl_overlap( ctl, other )
+            ) {
+               debug_printf( RETROGUI_TRACE_LVL,
+                  "control " SIZE_T_FMT " overlaps dirty control " SIZE_T_FMT,
+                  other->base.idc, ctl->base.idc );
+               other->base.flags |= RETROGUI_CTL_FLAG_DIRTY;
+               changed = 1;
+            }
+         }
+      }
+   }
+}
+
 MERROR_RETVAL retrogui_redraw_ctls( struct RETROGUI* gui ) {
    size_t i = 0;
    union RETROGUI_CTL* ctl = NULL;
    MERROR_RETVAL retval = MERROR_OK;
+   uint8_t redraw_all = 0;
 
-   if( RETROGUI_FLAGS_DIRTY != (RETROGUI_FLAGS_DIRTY & gui->flags) ) {
+   if(
+      0 == ((RETROGUI_FLAGS_DIRTY | RETROGUI_FLAGS_DIRTY_CTLS) & gui->flags)
+   ) {
       /* Shortcut! */
       return MERROR_OK;
    }
@@ -1434,22 +1688,51 @@ MERROR_RETVAL retrogui_redraw_ctls( struct RETROGUI* gui ) {
    assert( !retrogui_is_locked( gui ) );
    mdata_vector_lock( &(gui->ctls) );
 
+   redraw_all = RETROGUI_FLAGS_DIRTY == (RETROGUI_FLAGS_DIRTY & gui->flags);
+
+   /* Unmark dirty first so redraws can mark it again for animation! */
+   gui->flags &= ~(RETROGUI_FLAGS_DIRTY | RETROGUI_FLAGS_DIRTY_CTLS);
+
    if(
+      redraw_all &&
       RETROFLAT_COLOR_BLACK != gui->bg_color &&
       0 < gui->w && 0 < gui->h
    ) {
       retroflat_rect( gui->draw_bmp,
          gui->bg_color, gui->x, gui->y, gui->w, gui->h, RETROFLAT_FLAGS_FILL );
+   } else if( !redraw_all && RETROFLAT_COLOR_BLACK != gui->bg_color ) {
+      /* Clearing dirty controls erases any they cover, so redraw those. */
+      _retrogui_dirty_overlaps( gui );
+
+      /* Clear them all before redrawing any, so none are drawn over. */
+      for( i = 0 ; mdata_vector_ct( &(gui->ctls) ) > i ; i++ ) {
+         ctl = mdata_vector_get( &(gui->ctls), i, union RETROGUI_CTL );
+         if(
+            RETROGUI_CTL_FLAG_DIRTY ==
+               (RETROGUI_CTL_FLAG_DIRTY & ctl->base.flags)
+         ) {
+            retroflat_rect( gui->draw_bmp, gui->bg_color,
+               gui->x + ctl->base.x, gui->y + ctl->base.y,
+               ctl->base.w, ctl->base.h, RETROFLAT_FLAGS_FILL );
+         }
+      }
    }
 
    #define RETROGUI_CTL_TABLE_REDRAW( idx, c_name, c_fields ) \
       } else if( RETROGUI_CTL_TYPE_ ## c_name == ctl->base.type ) { \
-         /* Mark dirty first so redraw can unmark it for animation! */ \
-         gui->flags &= ~RETROGUI_FLAGS_DIRTY; \
          retrogui_redraw_ ## c_name( gui, ctl );
 
    for( i = 0 ; mdata_vector_ct( &(gui->ctls) ) > i ; i++ ) {
       ctl = mdata_vector_get( &(gui->ctls), i, union RETROGUI_CTL );
+      if(
+         !redraw_all &&
+         RETROGUI_CTL_FLAG_DIRTY != (RETROGUI_CTL_FLAG_DIRTY & ctl->base.flags)
+      ) {
+         continue;
+      }
+
+      ctl->base.flags &= ~RETROGUI_CTL_FLAG_DIRTY;
+
       if( 0 ) {
       RETROGUI_CTL_TABLE( RETROGUI_CTL_TABLE_REDRAW )
       }
@@ -1514,6 +1797,7 @@ MERROR_RETVAL retrogui_push_ctl(
    struct RETROGUI* gui, union RETROGUI_CTL* ctl
 ) {
    MERROR_RETVAL retval = MERROR_OK;
+   ssize_t push_idx = 0;
 
    assert( 0 < ctl->base.idc );
 
@@ -1536,8 +1820,6 @@ MERROR_RETVAL retrogui_push_ctl(
    }
    */
 
-   /* TODO: Hunt for control IDC and fail if duplicate found! */
-
    debug_printf( RETROGUI_TRACE_LVL,
       "gui->ctls_ct: " SIZE_T_FMT, mdata_vector_ct( &(gui->ctls) ) );
 
@@ -1564,7 +1846,18 @@ MERROR_RETVAL retrogui_push_ctl(
       gc_retrogui_ctl_names[ctl->base.type], ctl->base.idc,
       mdata_vector_ct( &(gui->ctls) ) );
 
-   mdata_vector_append( &(gui->ctls), ctl, sizeof( union RETROGUI_CTL ) );
+   /* Index the control first, since this also rejects duplicate IDCs. */
+   retval = _retrogui_idx_insert(
+      gui, ctl->base.idc, mdata_vector_ct( &(gui->ctls) ) );
+   maug_cleanup_if_not_ok();
+
+   push_idx = mdata_vector_append(
+      &(gui->ctls), ctl, sizeof( union RETROGUI_CTL ) );
+   if( 0 > push_idx ) {
+      retval = mdata_retval( push_idx );
+      _retrogui_idx_remove( gui, ctl->base.idc );
+      goto cleanup;
+   }
 
    gui->flags |= RETROGUI_FLAGS_DIRTY;
 
@@ -1573,9 +1866,7 @@ MERROR_RETVAL retrogui_push_ctl(
     */
    mdata_vector_lock( &(gui->ctls) );
 
-   /* TODO: More elegant way to grab index. */
-   ctl = mdata_vector_get_last( &(gui->ctls),
-      union RETROGUI_CTL );
+   ctl = mdata_vector_get( &(gui->ctls), push_idx, union RETROGUI_CTL );
    assert( NULL != ctl );
 
    #define RETROGUI_CTL_TABLE_PUSH( idx, c_name, c_fields ) \
@@ -1609,7 +1900,7 @@ cleanup:
 }
 
 MERROR_RETVAL retrogui_remove_ctl( struct RETROGUI* gui, retrogui_idc_t idc ) {
-   size_t i = 0;
+   ssize_t idx = -1;
    union RETROGUI_CTL* ctl = NULL;
    MERROR_RETVAL retval = MERROR_OK;
 
@@ -1618,6 +1909,11 @@ MERROR_RETVAL retrogui_remove_ctl( struct RETROGUI* gui, retrogui_idc_t idc ) {
       goto cleanup;
    }
 
+   idx = _retrogui_idx_remove( gui, idc );
+   if( 0 > idx ) {
+      goto cleanup;
+   }
+
    assert( !retrogui_is_locked( gui ) );
    mdata_vector_lock( &(gui->ctls) );
 
@@ -1625,28 +1921,26 @@ MERROR_RETVAL retrogui_remove_ctl( struct RETROGUI* gui, retrogui_idc_t idc ) {
       } else if( RETROGUI_CTL_TYPE_ ## c_name == ctl->base.type ) { \
          retrogui_free_ ## c_name( ctl );
 
-   for( i = 0 ; mdata_vector_ct( &(gui->ctls) ) > i ; i++ ) {
-      ctl = mdata_vector_get( &(gui->ctls), i, union RETROGUI_CTL );
-      if( idc != ctl->base.idc ) {
-         continue;
-      }
-
-      /* Free the control data. */
-      if( 0 ) {
-      RETROGUI_CTL_TABLE( RETROGUI_CTL_TABLE_FREE_CTL )
-      }
+   ctl = mdata_vector_get( &(gui->ctls), idx, union RETROGUI_CTL );
+   assert( NULL != ctl );
+   assert( idc == ctl->base.idc );
 
-      /* Remove the control. */
-      mdata_vector_unlock( &(gui->ctls) );
-      mdata_vector_remove( &(gui->ctls), i );
-      mdata_vector_lock( &(gui->ctls) );
-      break;
+   /* Free the control data. */
+   if( 0 ) {
+   RETROGUI_CTL_TABLE( RETROGUI_CTL_TABLE_FREE_CTL )
    }
 
+   /* Remove the control. */
    mdata_vector_unlock( &(gui->ctls) );
+   retval = mdata_vector_remove( &(gui->ctls), idx );
+
+   /* Clear the area the control was in. */
+   gui->flags |= RETROGUI_FLAGS_DIRTY;
 
 cleanup:
 
+   mdata_vector_unlock( &(gui->ctls) );
+
    return retval;
 }
 
@@ -1794,7 +2088,12 @@ MERROR_RETVAL retrogui_set_ctl_text(
       label_sz = RETROGUI_CTL_TEXT_SZ_MAX;
       _retrogui_copy_str(
          text, buffer, ctl->TEXTBOX, label_tmp, label_sz );
-      ctl->TEXTBOX.text_cur = 0;
+      /* Put the cursor after the new text so typing continues from it. */
+      ctl->TEXTBOX.text_sz = maug_strlen( buffer );
+      if( ctl->TEXTBOX.text_sz >= ctl->TEXTBOX.text_sz_max ) {
+         ctl->TEXTBOX.text_sz = ctl->TEXTBOX.text_sz_max - 1;
+      }
+      ctl->TEXTBOX.text_cur = ctl->TEXTBOX.text_sz;
 #endif /* !RETROGUI_NO_TEXTBOX */
    } else {
       error_printf( "invalid control type! no label!" );
@@ -1802,7 +2101,7 @@ MERROR_RETVAL retrogui_set_ctl_text(
    }
 
    /* New text! Redraw! */
-   gui->flags |= RETROGUI_FLAGS_DIRTY;
+   retrogui_ctl_dirty( gui, ctl );
 
 cleanup:
 
@@ -1874,6 +2173,7 @@ MERROR_RETVAL retrogui_free( struct RETROGUI* gui ) {
 cleanup:
 
    mdata_vector_free( &(gui->ctls) );
+   mdata_vector_free( &(gui->ctls_idx) );
 
    return retval;
 }
@@ -18,8 +18,38 @@
 #  define RETROGXC_TRACE_LVL 0
 #endif /* !RETROGXC_TRACE_LVL */
 
+#ifndef RETROGXC_ATLAS_PAGE_W
+/**
+ * \brief Width of atlas pages created by retrogxc_pack_atlas(). Kept at 256
+ *        by default, since larger textures may not work on Win32.
+ */
+#  define RETROGXC_ATLAS_PAGE_W 256
+#endif /* !RETROGXC_ATLAS_PAGE_W */
+
+#ifndef RETROGXC_ATLAS_PAGE_H
+#  define RETROGXC_ATLAS_PAGE_H 256
+#endif /* !RETROGXC_ATLAS_PAGE_H */
+
+#ifndef RETROGXC_ATLAS_PAGES_MAX
+#  define RETROGXC_ATLAS_PAGES_MAX 8
+#endif /* !RETROGXC_ATLAS_PAGES_MAX */
+
+#ifndef RETROGXC_ATLAS_PAD
+/**
+ * \brief Empty pixels left between bitmaps on an atlas page, so filtering
+ *        does not bleed neighbors into each other.
+ */
+#  define RETROGXC_ATLAS_PAD 1
+#endif /* !RETROGXC_ATLAS_PAD */
+
 #define RETROGXC_ERROR_CACHE_MISS (-1)
 
+/**
+ * \brief Value of RETROGXC_ATLAS_REGION::page for a bitmap that is not
+ *        packed into the atlas.
+ */
+#define RETROGXC_ATLAS_PAGE_NONE (-1)
+
 #define RETROGXC_ASSET_TYPE_NONE    0
 #define RETROGXC_ASSET_TYPE_BITMAP  1
 #define RETROGXC_ASSET_TYPE_FONT    2
@@ -36,10 +66,23 @@ typedef RETROGXC_ASSET_TYPE (*retrogxc_loader)(
    const retroflat_asset_path res_p, MAUG_MHANDLE* handle_p,
    void* data, uint8_t flags );
 
+/**
+ * \brief Where a cached bitmap was copied to by retrogxc_pack_atlas().
+ */
+struct RETROGXC_ATLAS_REGION {
+   /*! \brief Index of the atlas page, or ::RETROGXC_ATLAS_PAGE_NONE. */
+   int8_t page;
+   uint16_t x;
+   uint16_t y;
+   uint16_t w;
+   uint16_t h;
+};
+
 struct RETROFLAT_CACHE_ASSET {
    uint8_t type;
    MAUG_MHANDLE handle;
    retroflat_asset_path id;
+   struct RETROGXC_ATLAS_REGION atlas;
 };
 
 struct RETROGXC_FONT_PARMS {
@@ -92,10 +135,51 @@ MERROR_RETVAL retrogxc_string_sz(
 
 MERROR_RETVAL retrogxc_bitmap_w( size_t bitmap_idx );
 
+/**
+ * \brief Copy all cached bitmaps that fit into shared atlas pages, so they
+ *        can be drawn together with retrogxc_batch_bitmap().
+ *
+ * Bitmaps are packed tallest-first onto shelves. Bitmaps that are too large
+ * for a page, or that do not fit once ::RETROGXC_ATLAS_PAGES_MAX pages are
+ * full, are left out of the atlas. This should be called again after loading
+ * new bitmaps into the cache, which replaces any previous atlas.
+ */
+MERROR_RETVAL retrogxc_pack_atlas();
+
+/**
+ * \brief Destroy atlas pages created by retrogxc_pack_atlas().
+ */
+void retrogxc_free_atlas();
+
+/**
+ * \brief Get the location of a cached bitmap in the atlas.
+ * \return MERROR_OK, or MERROR_FILE if the bitmap is not in the atlas.
+ */
+MERROR_RETVAL retrogxc_atlas_region(
+   size_t bitmap_idx, struct RETROGXC_ATLAS_REGION* region_out );
+
+#ifdef RETROFLAT_OPENGL
+
+/**
+ * \brief Add an area of a cached bitmap to a ::RETROGLU_BATCH, drawing from
+ *        its atlas page, with the same parameters as retrogxc_blit_bitmap().
+ * \return MERROR_OK, or MERROR_FILE if the bitmap is not in the atlas, in
+ *         which case it should be drawn with retrogxc_blit_bitmap().
+ */
+MERROR_RETVAL retrogxc_batch_bitmap(
+   struct RETROGLU_BATCH* batch, size_t bitmap_idx,
+   size_t s_x, size_t s_y, int16_t d_x, int16_t d_y, size_t w, size_t h );
+
+#endif /* RETROFLAT_OPENGL */
+
 #ifdef RETROGXC_C
 
 static struct MDATA_VECTOR gs_retrogxc_bitmaps;
 
+static struct RETROFLAT_BITMAP
+   gs_retrogxc_atlas_pages[RETROGXC_ATLAS_PAGES_MAX];
+static size_t gs_retrogxc_atlas_pages_sz = 0;
+
 /* === */
 
 MERROR_RETVAL retrogxc_init() {
@@ -119,6 +203,8 @@ void retrogxc_clear_cache() {
    struct RETROFLAT_BITMAP* bitmap = NULL;
    MERROR_RETVAL retval = MERROR_OK;
 
+   retrogxc_free_atlas();
+
    mdata_vector_lock( &gs_retrogxc_bitmaps );
 
    while( 0 < mdata_vector_ct( &gs_retrogxc_bitmaps ) ) {
@@ -139,6 +225,9 @@ void retrogxc_clear_cache() {
 
       case RETROGXC_ASSET_TYPE_FONT:
          /* Fonts are just a blob of data after a struct, so just free it! */
+#ifdef RETROFONT_PRESENT
+         retrofont_cache_free( asset->handle );
+#endif /* RETROFONT_PRESENT */
          maug_mfree( asset->handle );
          dropped_count++;
       }
@@ -290,6 +379,7 @@ int16_t retrogxc_load_asset(
    MERROR_RETVAL retval = MERROR_OK;
 
    maug_mzero( &asset_new, sizeof( struct RETROFLAT_CACHE_ASSET ) );
+   asset_new.atlas.page = RETROGXC_ATLAS_PAGE_NONE;
 
    if( 0 == mdata_vector_ct( &gs_retrogxc_bitmaps ) ) {
       goto just_load_asset;
@@ -443,6 +533,264 @@ cleanup:
 
 /* === */
 
+void retrogxc_free_atlas() {
+   size_t i = 0;
+
+   for( i = 0 ; gs_retrogxc_atlas_pages_sz > i ; i++ ) {
+      retroflat_destroy_bitmap( &(gs_retrogxc_atlas_pages[i]) );
+   }
+   gs_retrogxc_atlas_pages_sz = 0;
+}
+
+/* === */
+
+MERROR_RETVAL retrogxc_pack_atlas() {
+   MERROR_RETVAL retval = MERROR_OK;
+   struct RETROFLAT_CACHE_ASSET* asset = NULL;
+   struct RETROFLAT_BITMAP* bitmap = NULL;
+   MAUG_MHANDLE order_h = (MAUG_MHANDLE)NULL;
+   size_t* order = NULL;
+   size_t order_sz = 0,
+      i = 0,
+      j = 0,
+      shelf_x = 0,
+      shelf_y = 0,
+      shelf_h = 0,
+      packed_ct = 0;
+   int8_t page = 0;
+   int pages_locked = 0;
+
+   retrogxc_free_atlas();
+
+   if( 0 == mdata_vector_ct( &gs_retrogxc_bitmaps ) ) {
+      goto cleanup;
+   }
+
+   order_h = maug_malloc( mdata_vector_ct( &gs_retrogxc_bitmaps ),
+      sizeof( size_t ) );
+   maug_cleanup_if_null_alloc( MAUG_MHANDLE, order_h );
+   maug_mlock( order_h, order );
+   maug_cleanup_if_null_lock( size_t*, order );
+
+   mdata_vector_lock( &gs_retrogxc_bitmaps );
+
+   /* Grab the bitmaps and their heights, sorted tallest-first so shelves
+    * waste less space.
+    */
+   for( i = 0 ; mdata_vector_ct( &gs_retrogxc_bitmaps ) > i ; i++ ) {
+      asset = mdata_vector_get(
+         &gs_retrogxc_bitmaps, i, struct RETROFLAT_CACHE_ASSET );
+      asset->atlas.page = RETROGXC_ATLAS_PAGE_NONE;
+      if( RETROGXC_ASSET_TYPE_BITMAP != asset->type ) {
+         continue;
+      }
+
+      maug_mlock( asset->handle, bitmap );
+      maug_cleanup_if_null_lock( struct RETROFLAT_BITMAP*, bitmap );
+      asset->atlas.w = retroflat_bitmap_w( bitmap );
+      asset->atlas.h = retroflat_bitmap_h( bitmap );
+      maug_munlock( asset->handle, bitmap );
+
+      /* Insertion sort by height. */
+      for( j = order_sz ; 0 < j ; j-- ) {
+         if( mdata_vector_get( &gs_retrogxc_bitmaps, order[j - 1],
+            struct RETROFLAT_CACHE_ASSET )->atlas.h >= asset->atlas.h
+         ) {
+            break;
+         }
+         order[j] = order[j - 1];
+      }
+      order[j] = i;
+      order_sz++;
+   }
+
+   /* Assign each bitmap a place on a shelf. */
+   page = 0;
+   for( i = 0 ; order_sz > i ; i++ ) {
+      asset = mdata_vector_get(
+         &gs_retrogxc_bitmaps, order[i], struct RETROFLAT_CACHE_ASSET );
+
+      if(
+         RETROGXC_ATLAS_PAGE_W < asset->atlas.w ||
+         RETROGXC_ATLAS_PAGE_H < asset->atlas.h
+      ) {
+         debug_printf( RETROGXC_TRACE_LVL,
+            "bitmap %s too large for atlas!", asset->id );
+         continue;
+      }
+
+      if( RETROGXC_ATLAS_PAGE_W < shelf_x + asset->atlas.w ) {
+         /* Start a new shelf. */
+         shelf_x = 0;
+         shelf_y += shelf_h;
+         shelf_h = 0;
+      }
+
+      if( RETROGXC_ATLAS_PAGE_H < shelf_y + asset->atlas.h ) {
+         /* Start a new page. */
+         if( RETROGXC_ATLAS_PAGES_MAX <= page + 1 ) {
+            error_printf( "atlas full; bitmap %s left out!", asset->id );
+            continue;
+         }
+         page++;
+         shelf_x = 0;
+         shelf_y = 0;
+         shelf_h = 0;
+      }
+
+      asset->atlas.page = page;
+      asset->atlas.x = shelf_x;
+      asset->atlas.y = shelf_y;
+
+      shelf_x += asset->atlas.w + RETROGXC_ATLAS_PAD;
+      if( shelf_h < asset->atlas.h + RETROGXC_ATLAS_PAD ) {
+         shelf_h = asset->atlas.h + RETROGXC_ATLAS_PAD;
+      }
+
+      gs_retrogxc_atlas_pages_sz = page + 1;
+   }
+
+   /* Create the pages and copy the bitmaps onto them. */
+   for( i = 0 ; gs_retrogxc_atlas_pages_sz > i ; i++ ) {
+      retval = retroflat_create_bitmap(
+         RETROGXC_ATLAS_PAGE_W, RETROGXC_ATLAS_PAGE_H,
+         &(gs_retrogxc_atlas_pages[i]), 0 );
+      if( MERROR_OK != retval ) {
+         gs_retrogxc_atlas_pages_sz = i;
+         goto cleanup;
+      }
+   }
+
+   for( i = 0 ; gs_retrogxc_atlas_pages_sz > i ; i++ ) {
+      retroflat_draw_lock( &(gs_retrogxc_atlas_pages[i]) );
+   }
+   pages_locked = 1;
+
+   for( i = 0 ; order_sz > i ; i++ ) {
+      asset = mdata_vector_get(
+         &gs_retrogxc_bitmaps, order[i], struct RETROFLAT_CACHE_ASSET );
+      if( RETROGXC_ATLAS_PAGE_NONE == asset->atlas.page ) {
+         continue;
+      }
+
+      maug_mlock( asset->handle, bitmap );
+      maug_cleanup_if_null_lock( struct RETROFLAT_BITMAP*, bitmap );
+      retval = retroflat_blit_bitmap(
+         &(gs_retrogxc_atlas_pages[asset->atlas.page]), bitmap,
+         0, 0, asset->atlas.x, asset->atlas.y,
+         asset->atlas.w, asset->atlas.h, RETROFLAT_INSTANCE_NULL );
+      maug_munlock( asset->handle, bitmap );
+      maug_cleanup_if_not_ok();
+      packed_ct++;
+   }
+
+   debug_printf( 1, "packed " SIZE_T_FMT " bitmaps into " SIZE_T_FMT
+      " atlas pages", packed_ct, gs_retrogxc_atlas_pages_sz );
+
+cleanup:
+
+   if( pages_locked ) {
+      for( i = 0 ; gs_retrogxc_atlas_pages_sz > i ; i++ ) {
+         retroflat_draw_release( &(gs_retrogxc_atlas_pages[i]) );
+      }
+   }
+
+   if( NULL != bitmap ) {
+      maug_munlock( asset->handle, bitmap );
+   }
+
+   mdata_vector_unlock( &gs_retrogxc_bitmaps );
+
+   if( NULL != order ) {
+      maug_munlock( order_h, order );
+   }
+
+   if( (MAUG_MHANDLE)NULL != order_h ) {
+      maug_mfree( order_h );
+   }
+
+   if( MERROR_OK != retval ) {
+      retrogxc_free_atlas();
+   }
+
+   return retval;
+}
+
+/* === */
+
+MERROR_RETVAL retrogxc_atlas_region(
+   size_t bitmap_idx, struct RETROGXC_ATLAS_REGION* region_out
+) {
+   MERROR_RETVAL retval = MERROR_OK;
+   struct RETROFLAT_CACHE_ASSET* asset = NULL;
+
+   mdata_vector_lock( &gs_retrogxc_bitmaps );
+
+   if( mdata_vector_ct( &gs_retrogxc_bitmaps ) <= bitmap_idx ) {
+      error_printf( "invalid bitmap index: " SIZE_T_FMT, bitmap_idx );
+      retval = MERROR_OVERFLOW;
+      goto cleanup;
+   }
+
+   asset = mdata_vector_get(
+      &gs_retrogxc_bitmaps, bitmap_idx, struct RETROFLAT_CACHE_ASSET );
+
+   if(
+      RETROGXC_ASSET_TYPE_BITMAP != asset->type ||
+      RETROGXC_ATLAS_PAGE_NONE == asset->atlas.page ||
+      (size_t)(asset->atlas.page) >= gs_retrogxc_atlas_pages_sz
+   ) {
+      retval = MERROR_FILE;
+      goto cleanup;
+   }
+
+   memcpy( region_out, &(asset->atlas), sizeof( struct RETROGXC_ATLAS_REGION ) );
+
+cleanup:
+
+   mdata_vector_unlock( &gs_retrogxc_bitmaps );
+
+   return retval;
+}
+
+/* === */
+
+#ifdef RETROFLAT_OPENGL
+
+MERROR_RETVAL retrogxc_batch_bitmap(
+   struct RETROGLU_BATCH* batch, size_t bitmap_idx,
+   size_t s_x, size_t s_y, int16_t d_x, int16_t d_y, size_t w, size_t h
+) {
+   MERROR_RETVAL retval = MERROR_OK;
+   struct RETROGXC_ATLAS_REGION region;
+
+   retval = retrogxc_atlas_region( bitmap_idx, &region );
+   maug_cleanup_if_not_ok();
+
+   /* Keep the quad inside of its own region on the page. */
+   if( s_x >= region.w || s_y >= region.h ) {
+      goto cleanup;
+   }
+   if( s_x + w > region.w ) {
+      w = region.w - s_x;
+   }
+   if( s_y + h > region.h ) {
+      h = region.h - s_y;
+   }
+
+   retval = retroglu_batch_quad(
+      batch, &(gs_retrogxc_atlas_pages[region.page]),
+      region.x + s_x, region.y + s_y, d_x, d_y, w, h );
+
+cleanup:
+
+   return retval;
+}
+
+#endif /* RETROFLAT_OPENGL */
+
+/* === */
+
 #ifdef RETROFONT_PRESENT
 
 int16_t retrogxc_load_font(
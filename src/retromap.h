@@ -0,0 +1,435 @@
+
+#ifndef RETROMAP_H
+#define RETROMAP_H
+
+/**
+ * \addtogroup retromap RetroMap API
+ * \brief Draw a ::RETROTILE layer through the viewport refresh grid.
+ *
+ * Only tiles whose refresh grid cell does not match the tile under them are
+ * drawn, so a still frame costs nothing. When the viewport scrolls by whole
+ * tiles, what's already on the target is shifted over and only the edge rows
+ * and columns exposed are drawn.
+ *
+ * This requires RETROFLAT_FLAGS_VIEWPORT_REFRESH to be passed to
+ * retroflat_init() so the refresh grid is allocated. Since there is one
+ * refresh grid, only one layer should be drawn this way; anything drawn on
+ * top of it should mark the cells it covers with
+ * retroflat_viewport_set_refresh( x, y, ::RETROMAP_TILE_STALE ).
+ *
+ * Tiles are assumed to be opaque and the target to be the size of the
+ * screen, since tiles are drawn over whatever was under them before.
+ * \{
+ * \file retromap.h
+ */
+
+#ifndef RETROMAP_TRACE_LVL
+#  define RETROMAP_TRACE_LVL 0
+#endif /* !RETROMAP_TRACE_LVL */
+
+/**
+ * \brief Refresh grid value for a cell that must be redrawn, since no tile
+ *        will ever have it.
+ */
+#define RETROMAP_TILE_STALE ((retroflat_tile_t)(-32767 - 1))
+
+/**
+ * \brief ::RETROMAP::flags indicating the world position fields hold the
+ *        position the layer was last drawn at.
+ */
+#define RETROMAP_FLAG_DRAWN   0x01
+
+struct RETROMAP {
+   uint8_t flags;
+   /*! \brief Viewport world X the layer was last drawn at. */
+   int16_t world_x;
+   /*! \brief Viewport world Y the layer was last drawn at. */
+   int16_t world_y;
+   /*! \brief Scratch bitmap used to shift the target when scrolling. */
+   struct RETROFLAT_BITMAP scroll_buf;
+};
+
+/**
+ * \brief Draw the stale tiles of a tilemap layer at the current viewport
+ *        position.
+ * \param target Bitmap the layer is drawn on, or NULL for the screen. It
+ *        must keep its contents between calls for tiles to be skipped; on
+ *        OpenGL, the screen does not, so it is redrawn in full every time.
+ * \param gxc_idxs Index of the ::RETROGXC cached bitmap for each tile ID,
+ *        e.g. as returned by retrogxc_load_bitmap() for each tile def.
+ *        Tiles outside of this list, or with negative indexes, are black.
+ *
+ * The viewport refresh grid may already be locked by the caller, and is
+ * left locked or unlocked as it was found.
+ */
+MERROR_RETVAL retromap_draw_layer(
+   struct RETROMAP* m, struct RETROFLAT_BITMAP* target,
+   struct RETROTILE* t, struct RETROTILE_LAYER* layer,
+   const int16_t* gxc_idxs, size_t gxc_idxs_sz );
+
+/**
+ * \brief Mark every tile stale, e.g. after drawing over the whole target.
+ */
+MERROR_RETVAL retromap_invalidate( struct RETROMAP* m );
+
+/**
+ * \brief Free the scratch bitmap held by a ::RETROMAP.
+ */
+void retromap_free( struct RETROMAP* m );
+
+#ifdef RETROMAP_C
+
+static void retromap_invalidate_grid() {
+   int16_t i = 0;
+
+   for(
+      i = 0 ;
+      g_retroflat_state->viewport.screen_tile_w *
+         g_retroflat_state->viewport.screen_tile_h > i ;
+      i++
+   ) {
+      g_retroflat_state->viewport.refresh_grid[i] = RETROMAP_TILE_STALE;
+   }
+}
+
+/* === */
+
+/**
+ * \brief Move refresh grid cells by the given number of tiles, so they
+ *        still describe the target after it has been shifted the same way.
+ *
+ * Cells shifted in from outside the grid are stale, as are cells whose tiles
+ * were clipped by the edge of the screen at the old position, since the part
+ * that was clipped may now be on screen.
+ */
+static void retromap_shift_grid(
+   int16_t old_world_x, int16_t old_world_y, int16_t d_cx, int16_t d_cy
+) {
+   int16_t
+      cx = 0,
+      cy = 0,
+      s_cx = 0,
+      s_cy = 0,
+      /* Screen position of the old tile in the source cell. */
+      s_x = 0,
+      s_y = 0,
+      /* Screen offset of tiles from a multiple of the tile size. */
+      off_x = (RETROFLAT_TILE_W -
+         (((old_world_x % RETROFLAT_TILE_W) + RETROFLAT_TILE_W) %
+            RETROFLAT_TILE_W)) % RETROFLAT_TILE_W,
+      off_y = (RETROFLAT_TILE_H -
+         (((old_world_y % RETROFLAT_TILE_H) + RETROFLAT_TILE_H) %
+            RETROFLAT_TILE_H)) % RETROFLAT_TILE_H,
+      i = 0,
+      grid_w = g_retroflat_state->viewport.screen_tile_w,
+      grid_h = g_retroflat_state->viewport.screen_tile_h,
+      grid_sz = grid_w * grid_h;
+   retroflat_tile_t* grid = g_retroflat_state->viewport.refresh_grid;
+
+   /* Walk in the direction that reads each cell before it's overwritten. */
+   for( i = 0 ; grid_sz > i ; i++ ) {
+      if( 0 < (d_cy * grid_w) + d_cx ) {
+         cy = i / grid_w;
+         cx = i % grid_w;
+      } else {
+         cy = (grid_sz - 1 - i) / grid_w;
+         cx = (grid_sz - 1 - i) % grid_w;
+      }
+      s_cx = cx + d_cx;
+      s_cy = cy + d_cy;
+
+      /* Cells are indexed by (x + tile size) / tile size. */
+      s_x = ((s_cx - 1) * RETROFLAT_TILE_W) + off_x;
+      s_y = ((s_cy - 1) * RETROFLAT_TILE_H) + off_y;
+
+      if(
+         0 > s_x || retroflat_screen_w() < s_x + RETROFLAT_TILE_W ||
+         0 > s_y || retroflat_screen_h() < s_y + RETROFLAT_TILE_H ||
+         grid_w <= s_cx || grid_h <= s_cy
+      ) {
+         grid[(cy * grid_w) + cx] = RETROMAP_TILE_STALE;
+      } else {
+         grid[(cy * grid_w) + cx] = grid[(s_cy * grid_w) + s_cx];
+      }
+   }
+}
+
+/* === */
+
+#ifdef RETROFLAT_OPENGL
+
+/**
+ * \brief Move the pixels of a locked texture in place. Blitting through a
+ *        scratch bitmap would skip transparent pixels, leaving old ones.
+ */
+static void retromap_shift_tex(
+   struct RETROFLAT_BITMAP* target, int16_t d_x, int16_t d_y,
+   size_t keep_w, size_t keep_h
+) {
+   size_t i = 0,
+      y = 0,
+      s_x = 0 < d_x ? d_x : 0,
+      t_x = 0 > d_x ? -d_x : 0;
+
+   assert( NULL != target->tex.bytes );
+
+   for( i = 0 ; keep_h > i ; i++ ) {
+      /* Walk rows in the direction that reads each before it's written. */
+      y = 0 < d_y ? i : keep_h - 1 - i;
+      memmove(
+         &(target->tex.bytes[(((y + (0 > d_y ? -d_y : 0)) *
+            target->tex.w) + t_x) * 4]),
+         &(target->tex.bytes[(((y + (0 < d_y ? d_y : 0)) *
+            target->tex.w) + s_x) * 4]),
+         keep_w * 4 );
+   }
+
+   retroglu_tex_dirty( &(target->tex), 0, 0, target->tex.w, target->tex.h );
+}
+
+#endif /* RETROFLAT_OPENGL */
+
+/* === */
+
+/**
+ * \brief Shift the contents of the target opposite the viewport movement,
+ *        or mark everything stale if that can't be done.
+ */
+static MERROR_RETVAL retromap_scroll(
+   struct RETROMAP* m, struct RETROFLAT_BITMAP* target, int16_t d_x, int16_t d_y
+) {
+   MERROR_RETVAL retval = MERROR_OK;
+   size_t keep_w = 0,
+      keep_h = 0;
+
+   if(
+      /* The refresh grid can only describe tile-aligned shifts. */
+      0 != d_x % RETROFLAT_TILE_W || 0 != d_y % RETROFLAT_TILE_H ||
+      retroflat_screen_w() <= (0 > d_x ? -d_x : d_x) ||
+      retroflat_screen_h() <= (0 > d_y ? -d_y : d_y)
+   ) {
+      debug_printf( RETROMAP_TRACE_LVL, "redrawing after scroll: %d, %d",
+         d_x, d_y );
+      retromap_invalidate_grid();
+      goto cleanup;
+   }
+
+   keep_w = retroflat_screen_w() - (0 > d_x ? -d_x : d_x);
+   keep_h = retroflat_screen_h() - (0 > d_y ? -d_y : d_y);
+
+#  ifdef RETROFLAT_OPENGL
+   retromap_shift_tex( target, d_x, d_y, keep_w, keep_h );
+#  else
+   if( !retroflat_bitmap_ok( &(m->scroll_buf) ) ) {
+      retval = retroflat_create_bitmap(
+         retroflat_screen_w(), retroflat_screen_h(), &(m->scroll_buf),
+         RETROFLAT_FLAGS_OPAQUE );
+      maug_cleanup_if_not_ok();
+   }
+
+   /* Copy the part that stays on screen out and back in at its new spot,
+    * since blitting a bitmap onto itself is not safe on every platform.
+    */
+   retroflat_draw_lock( &(m->scroll_buf) );
+   retval = retroflat_blit_bitmap(
+      &(m->scroll_buf), target,
+      0 < d_x ? d_x : 0, 0 < d_y ? d_y : 0, 0, 0, keep_w, keep_h, 0 );
+   retroflat_draw_release( &(m->scroll_buf) );
+   maug_cleanup_if_not_ok();
+
+   retval = retroflat_blit_bitmap(
+      target, &(m->scroll_buf),
+      0, 0, 0 > d_x ? -d_x : 0, 0 > d_y ? -d_y : 0, keep_w, keep_h, 0 );
+   maug_cleanup_if_not_ok();
+#  endif /* RETROFLAT_OPENGL */
+
+   retromap_shift_grid(
+      m->world_x, m->world_y, d_x / RETROFLAT_TILE_W, d_y / RETROFLAT_TILE_H );
+
+cleanup:
+
+   return retval;
+}
+
+/* === */
+
+static MERROR_RETVAL retromap_draw_tile(
+   struct RETROFLAT_BITMAP* target, retroflat_tile_t tile_id,
+   const int16_t* gxc_idxs, size_t gxc_idxs_sz, int16_t x, int16_t y
+) {
+   MERROR_RETVAL retval = MERROR_OK;
+   size_t s_x = 0,
+      s_y = 0,
+      w = RETROFLAT_TILE_W,
+      h = RETROFLAT_TILE_H;
+
+   /* Clip tiles hanging off the top/left of the screen. */
+   if( 0 > x ) {
+      s_x = -x;
+      w -= s_x;
+      x = 0;
+   }
+   if( 0 > y ) {
+      s_y = -y;
+      h -= s_y;
+      y = 0;
+   }
+
+   /* Clip tiles hanging off the bottom/right of the screen. */
+   if( x + w > (size_t)retroflat_screen_w() ) {
+      w = retroflat_screen_w() - x;
+   }
+   if( y + h > (size_t)retroflat_screen_h() ) {
+      h = retroflat_screen_h() - y;
+   }
+
+   if(
+      0 > tile_id || gxc_idxs_sz <= (size_t)tile_id || 0 > gxc_idxs[tile_id]
+   ) {
+      retroflat_rect(
+         target, RETROFLAT_COLOR_BLACK, x, y, w, h, RETROFLAT_FLAGS_FILL );
+   } else {
+      retval = retrogxc_blit_bitmap(
+         target, gxc_idxs[tile_id], s_x, s_y, x, y, w, h, 0 );
+   }
+
+   return retval;
+}
+
+/* === */
+
+MERROR_RETVAL retromap_draw_layer(
+   struct RETROMAP* m, struct RETROFLAT_BITMAP* target,
+   struct RETROTILE* t, struct RETROTILE_LAYER* layer,
+   const int16_t* gxc_idxs, size_t gxc_idxs_sz
+) {
+   MERROR_RETVAL retval = MERROR_OK;
+   retroflat_tile_t tile_id = 0;
+   int16_t world_x = retroflat_viewport_world_x(),
+      world_y = retroflat_viewport_world_y(),
+      /* Screen position of the current tile. */
+      x = 0,
+      y = 0,
+      /* Tilemap position of the current tile. */
+      t_x = 0,
+      t_y = 0,
+      /* Tilemap position of the tile at the top left of the screen. */
+      t_x_start = 0,
+      t_y_start = 0;
+   uint8_t grid_locked = 0;
+
+   /* Locking NULLs the handle, so check for a caller's lock, too. */
+   if(
+      (MAUG_MHANDLE)NULL == g_retroflat_state->viewport.refresh_grid_h &&
+      NULL == g_retroflat_state->viewport.refresh_grid
+   ) {
+      error_printf( "refresh grid not allocated!" );
+      retval = MERROR_GUI;
+      goto cleanup;
+   }
+
+   if( NULL == target ) {
+      target = retroflat_screen_buffer();
+   }
+
+   /* If the caller already holds the grid locked, leave it that way. */
+   if( NULL == g_retroflat_state->viewport.refresh_grid ) {
+      grid_locked = 1;
+      retroflat_viewport_lock_refresh();
+   }
+
+   if(
+      RETROMAP_FLAG_DRAWN != (RETROMAP_FLAG_DRAWN & m->flags)
+#  ifdef RETROFLAT_OPENGL
+      /* The OpenGL screen is redrawn from scratch every frame. */
+      || retroflat_screen_buffer() == target
+#  endif /* RETROFLAT_OPENGL */
+   ) {
+      retromap_invalidate_grid();
+
+   } else if( world_x != m->world_x || world_y != m->world_y ) {
+      retval = retromap_scroll(
+         m, target, world_x - m->world_x, world_y - m->world_y );
+      maug_cleanup_if_not_ok();
+   }
+
+   m->world_x = world_x;
+   m->world_y = world_y;
+   m->flags |= RETROMAP_FLAG_DRAWN;
+
+   /* Find the tile at the top-left of the screen, which may hang off. */
+   t_x_start = world_x / RETROFLAT_TILE_W;
+   t_y_start = world_y / RETROFLAT_TILE_H;
+   if( 0 > world_x && 0 != world_x % RETROFLAT_TILE_W ) {
+      t_x_start--;
+   }
+   if( 0 > world_y && 0 != world_y % RETROFLAT_TILE_H ) {
+      t_y_start--;
+   }
+
+   for(
+      t_y = t_y_start, y = (t_y_start * RETROFLAT_TILE_H) - world_y ;
+      (int16_t)retroflat_screen_h() > y ;
+      t_y++, y += RETROFLAT_TILE_H
+   ) {
+      for(
+         t_x = t_x_start, x = (t_x_start * RETROFLAT_TILE_W) - world_x ;
+         (int16_t)retroflat_screen_w() > x ;
+         t_x++, x += RETROFLAT_TILE_W
+      ) {
+         if(
+            0 > t_x || t->tiles_w <= (size_t)t_x ||
+            0 > t_y || t->tiles_h <= (size_t)t_y
+         ) {
+            /* Off the edge of the map. */
+            tile_id = -1;
+         } else {
+            tile_id = retrotile_get_tile( t, layer, t_x, t_y );
+         }
+
+         if( !retroflat_viewport_tile_is_stale( x, y, tile_id ) ) {
+            continue;
+         }
+
+         retval = retromap_draw_tile(
+            target, tile_id, gxc_idxs, gxc_idxs_sz, x, y );
+         maug_cleanup_if_not_ok();
+
+         retroflat_viewport_set_refresh( x, y, tile_id );
+      }
+   }
+
+cleanup:
+
+   if( grid_locked ) {
+      retroflat_viewport_unlock_refresh();
+   }
+
+   return retval;
+}
+
+/* === */
+
+MERROR_RETVAL retromap_invalidate( struct RETROMAP* m ) {
+   MERROR_RETVAL retval = MERROR_OK;
+
+   m->flags &= ~RETROMAP_FLAG_DRAWN;
+
+   return retval;
+}
+
+/* === */
+
+void retromap_free( struct RETROMAP* m ) {
+   if( retroflat_bitmap_ok( &(m->scroll_buf) ) ) {
+      retroflat_destroy_bitmap( &(m->scroll_buf) );
+   }
+   m->flags &= ~RETROMAP_FLAG_DRAWN;
+}
+
+#endif /* RETROMAP_C */
+
+/*! \} */ /* retromap */
+
+#endif /* !RETROMAP_H */
+
@@ -9,10 +9,6 @@
 #  define RETROSOFT_TRACE_LVL 0
 #endif /* RETROSOFT_TRACE_LVL */
 
-MERROR_RETVAL retrosoft_load_glyph(
-   RETROFLAT_COLOR color,
-   size_t set_idx, size_t glyph_idx, struct RETROFLAT_BITMAP* bmp );
-
 MERROR_RETVAL retrosoft_init();
 
 void retrosoft_shutdown();
@@ -47,56 +43,244 @@ void retrosoft_string(
 #  include "mfont8x8.h"
 
 #  ifndef RETROFLAT_NO_STRING
-/* TODO: Create another depth for each color. */
-static struct RETROFLAT_BITMAP
-gc_font_bmps[RETROFLAT_COLORS_SZ][RETROSOFT_SETS_COUNT][RETROSOFT_GLYPHS_COUNT];
+
+#     ifndef RETROSOFT_GLYPH_PAGE_COLS
+/*! \brief Glyphs per row on a glyph atlas page. */
+#        define RETROSOFT_GLYPH_PAGE_COLS 16
+#     endif /* !RETROSOFT_GLYPH_PAGE_COLS */
+
+#     ifndef RETROSOFT_GLYPH_PAGES_MAX
+#        ifdef RETROSOFT_PRELOAD_COLORS
+#           define RETROSOFT_GLYPH_PAGES_MAX \
+               (RETROFLAT_COLORS_SZ * RETROSOFT_SETS_COUNT)
+#        else
+/**
+ * \brief Number of colored glyph atlas pages kept at once. The least
+ *        recently used page is replaced when a new color is drawn.
+ */
+#           define RETROSOFT_GLYPH_PAGES_MAX 4
+#        endif /* RETROSOFT_PRELOAD_COLORS */
+#     endif /* !RETROSOFT_GLYPH_PAGES_MAX */
+
+#     define RETROSOFT_GLYPH_PAGE_ROWS \
+         ((RETROSOFT_GLYPHS_COUNT + RETROSOFT_GLYPH_PAGE_COLS - 1) / \
+            RETROSOFT_GLYPH_PAGE_COLS)
+
+#     define RETROSOFT_GLYPH_PAGE_FLAG_INIT 0x01
+
+#     ifndef retrosoft_glyph_color_ok
+#        ifdef RETROFLAT_OPENGL
+#           define retrosoft_glyph_color_ok( color ) (1)
+#        else
+/* Color-keyed backends would treat black glyphs as transparent. */
+#           define retrosoft_glyph_color_ok( color ) \
+               (RETROFLAT_COLOR_BLACK != (color))
+#        endif /* RETROFLAT_OPENGL */
+#     endif /* !retrosoft_glyph_color_ok */
+
+/**
+ * \brief Atlas of one glyph set in one color, filled in from the
+ *        monochrome masks in gc_font8x8 as glyphs are first drawn.
+ */
+struct RETROSOFT_GLYPH_PAGE {
+   uint8_t flags;
+   RETROFLAT_COLOR color;
+   uint8_t set_idx;
+   uint32_t last_use;
+   /*! \brief Bitfield of glyphs that have been drawn onto the page. */
+   uint8_t ready[(RETROSOFT_GLYPHS_COUNT + 7) / 8];
+   struct RETROFLAT_BITMAP bmp;
+};
+
+static struct RETROSOFT_GLYPH_PAGE
+gs_retrosoft_glyph_pages[RETROSOFT_GLYPH_PAGES_MAX];
+static uint32_t gs_retrosoft_glyph_uses = 0;
+
+#     define retrosoft_glyph_ready( page, glyph_idx ) \
+         (0 != ((page)->ready[(glyph_idx) >> 3] & (1 << ((glyph_idx) & 0x07))))
+
 #  endif /* !RETROFLAT_NO_STRING */
 
 /* === */
 
 #  ifndef RETROFLAT_NO_STRING
 
-MERROR_RETVAL retrosoft_load_glyph(
-   RETROFLAT_COLOR color,
-   size_t set_idx, size_t glyph_idx, struct RETROFLAT_BITMAP* bmp
+/**
+ * \brief Draw a glyph mask straight onto a locked target, for when it can't
+ *        go through a glyph page.
+ */
+static void retrosoft_glyph_px(
+   struct RETROFLAT_BITMAP* target, RETROFLAT_COLOR color,
+   size_t set_idx, size_t glyph_idx, int x_orig, int y_orig
 ) {
-   MERROR_RETVAL retval = MERROR_OK;
    int x = 0,
       y = 0;
    const char* glyph_dots = gc_font8x8[set_idx][glyph_idx];
-   
-   /* Create a transparent bitmap to draw on. */
-   retval = retroflat_create_bitmap(
-      RETROSOFT_GLYPH_W_SZ, RETROSOFT_GLYPH_H_SZ, bmp, 0 );
-   maug_cleanup_if_not_ok();
-
-   /* Normally draw lock is called from the main loop, but we're making an
-    * off-screen bitmap, here!
-    */
-   retroflat_draw_lock( bmp );
-   retroflat_px_lock( bmp );
 
-   /* Draw the glyph onto the bitmap. */
    for( y = 0 ; RETROSOFT_GLYPH_H_SZ > y ; y++ ) {
+      if( 0 > y_orig + y ) {
+         continue;
+      }
       for( x = 0 ; RETROSOFT_GLYPH_W_SZ > x ; x++ ) {
-         if( 1 == ((glyph_dots[y] >> x) & 0x01) ) {
-            retroflat_px( bmp, color, x, y, 0 );
+         if( 0 <= x_orig + x && 1 == ((glyph_dots[y] >> x) & 0x01) ) {
+            retroflat_px( target, color, x_orig + x, y_orig + y, 0 );
          }
       }
    }
+}
 
-   retroflat_px_release( bmp );
-   retroflat_draw_release( bmp );
+/* === */
+
+/**
+ * \brief Find the glyph page for the given color and set, replacing the
+ *        least recently used page if there isn't one yet.
+ * \return The page, or NULL if the glyphs should be drawn directly.
+ */
+static struct RETROSOFT_GLYPH_PAGE* retrosoft_glyph_page(
+   RETROFLAT_COLOR color, size_t set_idx
+) {
+   MERROR_RETVAL retval = MERROR_OK;
+   struct RETROSOFT_GLYPH_PAGE* page = NULL;
+   size_t i = 0;
+
+   gs_retrosoft_glyph_uses++;
 
-   /*
-   retroflat_rect(
-      bmp, RETROFLAT_COLOR_RED, 0, 0, 
-      RETROSOFT_GLYPH_W_SZ, RETROSOFT_GLYPH_H_SZ, RETROFLAT_FLAGS_FILL );
-   */
+   for( i = 0 ; RETROSOFT_GLYPH_PAGES_MAX > i ; i++ ) {
+      if(
+         RETROSOFT_GLYPH_PAGE_FLAG_INIT ==
+            (RETROSOFT_GLYPH_PAGE_FLAG_INIT &
+               gs_retrosoft_glyph_pages[i].flags) &&
+         color == gs_retrosoft_glyph_pages[i].color &&
+         set_idx == gs_retrosoft_glyph_pages[i].set_idx
+      ) {
+         page = &(gs_retrosoft_glyph_pages[i]);
+         goto cleanup;
+      }
+   }
+
+   if( !retrosoft_glyph_color_ok( color ) ) {
+      goto cleanup;
+   }
+
+   /* Take an unused page, or else the least recently used one. */
+   page = &(gs_retrosoft_glyph_pages[0]);
+   for( i = 0 ; RETROSOFT_GLYPH_PAGES_MAX > i ; i++ ) {
+      if(
+         RETROSOFT_GLYPH_PAGE_FLAG_INIT !=
+         (RETROSOFT_GLYPH_PAGE_FLAG_INIT & gs_retrosoft_glyph_pages[i].flags)
+      ) {
+         page = &(gs_retrosoft_glyph_pages[i]);
+         break;
+      } else if( gs_retrosoft_glyph_pages[i].last_use < page->last_use ) {
+         page = &(gs_retrosoft_glyph_pages[i]);
+      }
+   }
+
+   if(
+      RETROSOFT_GLYPH_PAGE_FLAG_INIT ==
+      (RETROSOFT_GLYPH_PAGE_FLAG_INIT & page->flags)
+   ) {
+      debug_printf( RETROSOFT_TRACE_LVL, "evicting glyph page in %s...",
+         gc_retroflat_color_names[page->color] );
+      retroflat_destroy_bitmap( &(page->bmp) );
+   }
+
+   maug_mzero( page, sizeof( struct RETROSOFT_GLYPH_PAGE ) );
+
+   debug_printf( RETROSOFT_TRACE_LVL, "creating glyph page in %s...",
+      gc_retroflat_color_names[color] );
+
+   /* Create a transparent bitmap to draw on. */
+   retval = retroflat_create_bitmap(
+      RETROSOFT_GLYPH_W_SZ * RETROSOFT_GLYPH_PAGE_COLS,
+      RETROSOFT_GLYPH_H_SZ * RETROSOFT_GLYPH_PAGE_ROWS, &(page->bmp), 0 );
+   if( MERROR_OK != retval ) {
+      error_printf( "could not create glyph page!" );
+      page = NULL;
+      goto cleanup;
+   }
+
+   page->color = color;
+   page->set_idx = set_idx;
+   page->flags |= RETROSOFT_GLYPH_PAGE_FLAG_INIT;
 
 cleanup:
 
-   return retval;
+   if( NULL != page ) {
+      page->last_use = gs_retrosoft_glyph_uses;
+   }
+
+   return page;
+}
+
+/* === */
+
+/**
+ * \brief Colorize any glyphs in str (or all glyphs, if str is NULL) that
+ *        are not on the page yet.
+ */
+static void retrosoft_glyph_page_fill(
+   struct RETROSOFT_GLYPH_PAGE* page, const char* str, size_t str_sz
+) {
+   size_t i = 0,
+      glyph_idx = 0,
+      glyph_x = 0,
+      glyph_y = 0;
+   int x = 0,
+      y = 0;
+   uint8_t locked = 0;
+   const char* glyph_dots = NULL;
+
+   if( NULL == str ) {
+      str_sz = RETROSOFT_GLYPHS_COUNT;
+   }
+
+   for( i = 0 ; str_sz > i ; i++ ) {
+      if( NULL != str ) {
+         if( '\0' == str[i] ) {
+            break;
+         }
+         glyph_idx = (uint8_t)(str[i]) - ' ';
+         if( RETROSOFT_GLYPHS_COUNT <= glyph_idx ) {
+            continue;
+         }
+      } else {
+         glyph_idx = i;
+      }
+
+      if( retrosoft_glyph_ready( page, glyph_idx ) ) {
+         continue;
+      }
+
+      if( !locked ) {
+         /* Normally draw lock is called from the main loop, but we're making
+          * an off-screen bitmap, here!
+          */
+         retroflat_draw_lock( &(page->bmp) );
+         retroflat_px_lock( &(page->bmp) );
+         locked = 1;
+      }
+
+      glyph_x = (glyph_idx % RETROSOFT_GLYPH_PAGE_COLS) * RETROSOFT_GLYPH_W_SZ;
+      glyph_y = (glyph_idx / RETROSOFT_GLYPH_PAGE_COLS) * RETROSOFT_GLYPH_H_SZ;
+      glyph_dots = gc_font8x8[page->set_idx][glyph_idx];
+
+      for( y = 0 ; RETROSOFT_GLYPH_H_SZ > y ; y++ ) {
+         for( x = 0 ; RETROSOFT_GLYPH_W_SZ > x ; x++ ) {
+            if( 1 == ((glyph_dots[y] >> x) & 0x01) ) {
+               retroflat_px(
+                  &(page->bmp), page->color, glyph_x + x, glyph_y + y, 0 );
+            }
+         }
+      }
+
+      page->ready[glyph_idx >> 3] |= (1 << (glyph_idx & 0x07));
+   }
+
+   if( locked ) {
+      retroflat_px_release( &(page->bmp) );
+      retroflat_draw_release( &(page->bmp) );
+   }
 }
 
 #  endif /* !RETROFLAT_NO_STRING */
@@ -105,34 +289,33 @@ cleanup:
 
 MERROR_RETVAL retrosoft_init() {
    MERROR_RETVAL retval = MERROR_OK;
-#  ifndef RETROFLAT_NO_STRING
-   size_t i = 0,
-      j = 0;
+#  if !defined( RETROFLAT_NO_STRING ) && defined( RETROSOFT_PRELOAD_COLORS )
+   size_t i = 0;
    RETROFLAT_COLOR h = RETROFLAT_COLOR_WHITE;
+   struct RETROSOFT_GLYPH_PAGE* page = NULL;
+#  endif /* !RETROFLAT_NO_STRING && RETROSOFT_PRELOAD_COLORS */
+
+#  ifndef RETROFLAT_NO_STRING
+   maug_mzero( gs_retrosoft_glyph_pages, sizeof( gs_retrosoft_glyph_pages ) );
+   gs_retrosoft_glyph_uses = 0;
 
 #     ifdef RETROSOFT_PRELOAD_COLORS
+   /* Glyphs are normally colorized the first time they're drawn, but
+    * colorize them all up front if requested.
+    */
    for( h = 0 ; RETROFLAT_COLORS_SZ > h ; h++ ) {
       debug_printf( RETROSOFT_TRACE_LVL,
          "loading glyphs in %s...", gc_retroflat_color_names[h] );
-#     endif /* RETROSOFT_PRELOAD_COLORS */
-   for( i = 0 ; RETROSOFT_SETS_COUNT > i ; i++ ) {
-         for( j = 0 ; RETROSOFT_GLYPHS_COUNT > j ; j++ ) {
-            debug_printf( RETROSOFT_TRACE_LVL,
-               "loading glyph " SIZE_T_FMT "...", j );
-            retval = retrosoft_load_glyph( h, i, j, &(gc_font_bmps[h][i][j]) );
-            maug_cleanup_if_not_ok();
+      for( i = 0 ; RETROSOFT_SETS_COUNT > i ; i++ ) {
+         page = retrosoft_glyph_page( h, i );
+         if( NULL != page ) {
+            retrosoft_glyph_page_fill( page, NULL, 0 );
          }
       }
-#     ifdef RETROSOFT_PRELOAD_COLORS
    }
 #     endif /* RETROSOFT_PRELOAD_COLORS */
-
-cleanup:
-
 #  endif /* !RETROFLAT_NO_STRING */
 
-   /* TODO: Unload loaded bitmaps if retval not OK. */
-
    return retval;
 }
 
@@ -140,34 +323,92 @@ cleanup:
 
 void retrosoft_shutdown() {
 #  ifndef RETROFLAT_NO_STRING
-   size_t i = 0,
-      j = 0;
-   RETROFLAT_COLOR h = RETROFLAT_COLOR_WHITE;
+   size_t i = 0;
 #  endif /* !RETROFLAT_NO_STRING */
 
    debug_printf( RETROSOFT_TRACE_LVL, "retrosoft shutdown called..." );
 
 #  ifndef RETROFLAT_NO_STRING
 
-#ifdef RETROSOFT_PRELOAD_COLORS
-   for( h = 0 ; RETROFLAT_COLORS_SZ > h ; h++ ) {
-#endif /* RETROSOFT_PRELOAD_COLORS */
-      for( i = 0 ; RETROSOFT_SETS_COUNT > i ; i++ ) {
-         for( j = 0 ; RETROSOFT_GLYPHS_COUNT > j ; j++ ) {
-            debug_printf( RETROSOFT_TRACE_LVL,
-               "destroying glyph " SIZE_T_FMT "...", j );
-            retroflat_destroy_bitmap( &(gc_font_bmps[h][i][j]) );
-         }
+   for( i = 0 ; RETROSOFT_GLYPH_PAGES_MAX > i ; i++ ) {
+      if(
+         RETROSOFT_GLYPH_PAGE_FLAG_INIT !=
+         (RETROSOFT_GLYPH_PAGE_FLAG_INIT & gs_retrosoft_glyph_pages[i].flags)
+      ) {
+         continue;
       }
-#ifdef RETROSOFT_PRELOAD_COLORS
+      debug_printf( RETROSOFT_TRACE_LVL,
+         "destroying glyph page " SIZE_T_FMT "...", i );
+      retroflat_destroy_bitmap( &(gs_retrosoft_glyph_pages[i].bmp) );
+      gs_retrosoft_glyph_pages[i].flags = 0;
    }
-#endif /* RETROSOFT_PRELOAD_COLORS */
 
 #  endif /* !RETROFLAT_NO_STRING */
 }
 
 /* === */
 
+/**
+ * \brief Fill pixels x1 through x2 (inclusive) of row y on a locked bitmap,
+ *        clipping the run to the bitmap first.
+ */
+static void retrosoft_hspan(
+   struct RETROFLAT_BITMAP* target, const RETROFLAT_COLOR color_idx,
+   int x1, int x2, int y
+) {
+   if(
+      RETROFLAT_COLOR_NULL == color_idx ||
+      0 > y || (int)retroflat_bitmap_h( target ) <= y
+   ) {
+      return;
+   }
+
+   if( 0 > x1 ) {
+      x1 = 0;
+   }
+   if( (int)retroflat_bitmap_w( target ) <= x2 ) {
+      x2 = retroflat_bitmap_w( target ) - 1;
+   }
+   if( x2 < x1 ) {
+      return;
+   }
+
+   retroflat_px_row( target, color_idx, x1, y, x2 - x1 + 1 );
+}
+
+/* === */
+
+/**
+ * \brief Fill pixels y1 through y2 (inclusive) of column x on a locked
+ *        bitmap, clipping the run to the bitmap first.
+ */
+static void retrosoft_vspan(
+   struct RETROFLAT_BITMAP* target, const RETROFLAT_COLOR color_idx,
+   int x, int y1, int y2
+) {
+   int y_iter = 0;
+
+   if(
+      RETROFLAT_COLOR_NULL == color_idx ||
+      0 > x || (int)retroflat_bitmap_w( target ) <= x
+   ) {
+      return;
+   }
+
+   if( 0 > y1 ) {
+      y1 = 0;
+   }
+   if( (int)retroflat_bitmap_h( target ) <= y2 ) {
+      y2 = retroflat_bitmap_h( target ) - 1;
+   }
+
+   for( y_iter = y1 ; y2 >= y_iter ; y_iter++ ) {
+      retroflat_px( target, color_idx, x, y_iter, 0 );
+   }
+}
+
+/* === */
+
 void retrosoft_line_strategy(
    int x1, int y1, int x2, int y2,
    uint8_t* p_for_axis, uint8_t* p_off_axis, int16_t dist[2],
@@ -251,6 +492,19 @@ void retrosoft_line(
 
    retroflat_px_lock( target );
 
+   /* Straight lines are just runs, so skip the slope stepping. Like the
+    * stepped case below, the far endpoint is not drawn.
+    */
+   if( y1 == y2 ) {
+      retrosoft_hspan(
+         target, color, x1 < x2 ? x1 : x2, (x1 < x2 ? x2 : x1) - 1, y1 );
+      goto cleanup;
+   } else if( x1 == x2 ) {
+      retrosoft_vspan(
+         target, color, x1, y1 < y2 ? y1 : y2, (y1 < y2 ? y2 : y1) - 1 );
+      goto cleanup;
+   }
+
    retrosoft_line_strategy(
       x1, y1, x2, y2,
       &for_axis, &off_axis, dist, start, end, iter, &inc, &delta );
@@ -281,6 +535,8 @@ void retrosoft_line(
       }
    }
 
+cleanup:
+
    retroflat_px_release( target );
 }
 
@@ -292,8 +548,7 @@ void retrosoft_rect(
    struct RETROFLAT_BITMAP* target, const RETROFLAT_COLOR color_idx,
    int x, int y, int w, int h, uint8_t flags
 ) {
-   int x_iter = 0,
-      y_iter = 0;
+   int y_iter = 0;
 
    if( NULL == target ) {
       target = retroflat_screen_buffer();
@@ -303,20 +558,27 @@ void retrosoft_rect(
 
    if( RETROFLAT_FLAGS_FILL == (RETROFLAT_FLAGS_FILL & flags) ) {
 
+      /* Clip the rows once; retrosoft_hspan() trims each run to the width. */
+      if( 0 > y ) {
+         h += y;
+         y = 0;
+      }
+      if( y + h > (int)retroflat_bitmap_h( target ) ) {
+         h = retroflat_bitmap_h( target ) - y;
+      }
+
       for( y_iter = y ; y_iter < y + h ; y_iter++ ) {
-         for( x_iter = x ; x_iter < x + w ; x_iter++ ) {
-            /* TODO: Optimize filling 4-byte sequences! */
-            retroflat_px( target, color_idx, x_iter, y_iter, 0 );
-         }
+         retrosoft_hspan( target, color_idx, x, x + w - 1, y_iter );
       }
 
    } else {
 
 #ifdef RETROFLAT_SOFT_LINES
-      retrosoft_line( target, color_idx, x, y, x + w, y, 0 );
-      retrosoft_line( target, color_idx, x + w, y, x + w, y + h, 0 );
-      retrosoft_line( target, color_idx, x + w, y + h, x, y + h, 0 );
-      retrosoft_line( target, color_idx, x, y + h, x, y, 0 );
+      /* Same pixels as four retrosoft_line() calls, without the stepping. */
+      retrosoft_hspan( target, color_idx, x, x + w - 1, y );
+      retrosoft_vspan( target, color_idx, x + w, y, y + h - 1 );
+      retrosoft_hspan( target, color_idx, x, x + w - 1, y + h );
+      retrosoft_vspan( target, color_idx, x, y, y + h - 1 );
 #else
       retroflat_line( target, color_idx, x, y, x + w, y, 0 );
       retroflat_line( target, color_idx, x + w, y, x + w, y + h, 0 );
@@ -331,20 +593,51 @@ void retrosoft_rect(
 
 /* === */
 
-void retrosoft_ellipse(
+/**
+ * \brief Draw row dy above and below the center of an ellipse, given the
+ *        half-width of that row and of the next row out.
+ */
+static void retrosoft_ellipse_rows(
    struct RETROFLAT_BITMAP* target, RETROFLAT_COLOR color,
-   int x, int y, int w, int h, uint8_t flags
+   int cx, int cy, int dy, int half_w, int next_half_w, uint8_t flags
 ) {
-   int32_t i = 0,
-      i_prev = 0;
-   uint16_t px_x1 = 0,
-      px_y1 = 0,
-      px_x2 = 0,
-      px_y2 = 0;
+   int inner = 0;
+
+   if( RETROFLAT_FLAGS_FILL == (RETROFLAT_FLAGS_FILL & flags) ) {
+      retrosoft_hspan( target, color, cx - half_w, cx + half_w, cy - dy );
+      if( 0 != dy ) {
+         retrosoft_hspan( target, color, cx - half_w, cx + half_w, cy + dy );
+      }
+      return;
+   }
+
+   /* Only draw out to where the next row picks up, so steep parts of the
+    * outline stay connected without overdrawing the flat parts.
+    */
+   inner = next_half_w < half_w ? next_half_w + 1 : half_w;
 
-   /* TODO: Switch to Bresenham algorithm. */
+   retrosoft_hspan( target, color, cx - half_w, cx - inner, cy - dy );
+   retrosoft_hspan( target, color, cx + inner, cx + half_w, cy - dy );
+   if( 0 != dy ) {
+      retrosoft_hspan( target, color, cx - half_w, cx - inner, cy + dy );
+      retrosoft_hspan( target, color, cx + inner, cx + half_w, cy + dy );
+   }
+}
+
+/* === */
 
-   /* TODO: Filled ellipse. */
+void retrosoft_ellipse(
+   struct RETROFLAT_BITMAP* target, RETROFLAT_COLOR color,
+   int x, int y, int w, int h, uint8_t flags
+) {
+   int32_t rx = w / 2,
+      ry = h / 2,
+      rx2 = 0,
+      ry2 = 0,
+      err = 0,
+      half_w = 0,
+      prev_half_w = 0,
+      dy = 0;
 
    if( NULL == target ) {
       target = retroflat_screen_buffer();
@@ -352,58 +645,35 @@ void retrosoft_ellipse(
 
    retroflat_px_lock( target );
 
-   do {
-      /* For the soft_lut, input numbers are * 1000... so 0.1 becomes 100. */
-      for( i = 100 ; 2 * RETROFP_PI + 100 > i ; i += 100 ) {
-         i_prev = i - 100;
-
-         px_x1 = x + (w / 2) + retrofp_cos( i_prev, w / 2 );
-         px_y1 = y + (h / 2) + retrofp_sin( i_prev, h / 2 );
-         px_x2 = x + (w / 2) + retrofp_cos( i, w / 2 );
-         px_y2 = y + (h / 2) + retrofp_sin( i, h / 2 );
-
-         /*
-         if(
-            retroflat_bitmap_w( target ) <= px_x1 ||
-            retroflat_bitmap_h( target ) <= px_y1 ||
-            retroflat_bitmap_w( target ) <= px_x2 ||
-            retroflat_bitmap_h( target ) <= px_y2
-         ) {
-            continue;
-         }
-         */
+   rx2 = rx * rx;
+   ry2 = ry * ry;
 
-         retroflat_line( target, color, px_x1, px_y1, px_x2, px_y2, 0 );  
+   /* Midpoint scan conversion: walk rows out from the center, testing each
+    * row at its midpoint toward the center (dy - 0.5) so the flat top and
+    * bottom come out as runs rather than single pixels. Keep
+    * err = (ry^2 * x^2) + (rx^2 * (dy^2 - dy + 1/4)) - (rx^2 * ry^2) up to
+    * date incrementally, and pull the half-width in until it's back inside.
+    * err stays within a couple of row/column steps of 0, so it fits int32
+    * for any sane screen size.
+    */
+   half_w = rx;
+   prev_half_w = rx;
+   err = rx2 >> 2;
+   for( dy = 1 ; ry >= dy ; dy++ ) {
+      err += 2 * rx2 * (dy - 1);
+      while( 0 < err && 0 < half_w ) {
+         err -= ry2 * ((2 * half_w) - 1);
+         half_w--;
       }
 
-      /* Keep shrinking and filling if required. */
-      if( w > h ) {
-         x++;
-         w--;
-         if( 0 < h ) {
-            y++;
-            h--;
-         }
-      } else if( h > w ) {
-         y++;
-         h--;
-         if( 0 < w ) {
-            x++;
-            w--;
-         }
-      } else {
-         x++;
-         w--;
-         y++;
-         h--;
-      }
-      assert( 0 <= w );
-      assert( 0 <= h );
-      /* debug_printf( 1, "ELLIPSE %d, %d", w, h ); */
-   } while(
-      (RETROFLAT_FLAGS_FILL == (RETROFLAT_FLAGS_FILL & flags)) &&
-      (0 < w || 0 < h)
-   );
+      retrosoft_ellipse_rows( target, color, x + rx, y + ry,
+         dy - 1, prev_half_w, half_w, flags );
+      prev_half_w = half_w;
+   }
+
+   /* The top and bottom rows are capped off across their full width. */
+   retrosoft_ellipse_rows( target, color, x + rx, y + ry,
+      ry, prev_half_w, -1, flags );
 
    retroflat_px_release( target );
 }
@@ -435,11 +705,24 @@ void retrosoft_string(
    size_t i = 0,
       glyph_idx = 0;
    int x = x_orig;
+   struct RETROSOFT_GLYPH_PAGE* page = NULL;
+
+   if( RETROFLAT_COLOR_NULL == color ) {
+      return;
+   }
 
    if( 0 == str_sz ) {
       str_sz = maug_strlen( str );
    }
 
+   page = retrosoft_glyph_page( color, 0 );
+   if( NULL != page ) {
+      /* Colorize anything this string needs before blitting from the page. */
+      retrosoft_glyph_page_fill( page, str, str_sz );
+   } else {
+      retroflat_px_lock( target );
+   }
+
    for( i = 0 ; str_sz > i ; i++ ) {
       /* Terminate prematurely at null. */
       if( '\0' == str[i] ) {
@@ -447,35 +730,28 @@ void retrosoft_string(
       }
 
       /* Fonts start at character after space. */
-      glyph_idx = str[i] - ' ';
-
-#if defined( RETROFLAT_API_SDL2 ) && !defined( RETROSOFT_PRELOAD_COLORS )
-      /* If we're not caching the colors, use SDL2 features if available to
-       * tint the glyph before blitting it. */
-      SDL_SetSurfaceColorMod(
-         gc_font_bmps[RETROFLAT_COLOR_WHITE][0][glyph_idx].surface,
-         g_retroflat_state->palette[color].r,
-         g_retroflat_state->palette[color].g,
-         g_retroflat_state->palette[color].b );
-      SDL_DestroyTexture(
-         gc_font_bmps[RETROFLAT_COLOR_WHITE][0][glyph_idx].texture );
-      gc_font_bmps[RETROFLAT_COLOR_WHITE][0][glyph_idx].texture =
-         SDL_CreateTextureFromSurface(
-            g_retroflat_state->buffer.renderer,
-            gc_font_bmps[RETROFLAT_COLOR_WHITE][0][glyph_idx].surface );
-#endif /* RETROFLAT_API_SDL2 && !RETROSOFT_PRELOAD_COLORS */
-
-      retroflat_blit_bitmap(
-         target, &(gc_font_bmps[
-#ifdef RETROSOFT_PRELOAD_COLORS
-         color
-#else
-         RETROFLAT_COLOR_WHITE
-#endif /* !RETROSOFT_PRELOAD_COLORS */
-         ][0][glyph_idx]), 0, 0, x, y_orig,
-         RETROSOFT_GLYPH_W_SZ, RETROSOFT_GLYPH_H_SZ, RETROFLAT_INSTANCE_NULL );
+      glyph_idx = (uint8_t)(str[i]) - ' ';
+      if( RETROSOFT_GLYPHS_COUNT <= glyph_idx ) {
+         x += RETROSOFT_GLYPH_W_SZ;
+         continue;
+      }
+
+      if( NULL != page ) {
+         retroflat_blit_bitmap(
+            target, &(page->bmp),
+            (glyph_idx % RETROSOFT_GLYPH_PAGE_COLS) * RETROSOFT_GLYPH_W_SZ,
+            (glyph_idx / RETROSOFT_GLYPH_PAGE_COLS) * RETROSOFT_GLYPH_H_SZ,
+            x, y_orig, RETROSOFT_GLYPH_W_SZ, RETROSOFT_GLYPH_H_SZ,
+            RETROFLAT_INSTANCE_NULL );
+      } else {
+         retrosoft_glyph_px( target, color, 0, glyph_idx, x, y_orig );
+      }
+
+      x += RETROSOFT_GLYPH_W_SZ;
+   }
 
-      x += 8;
+   if( NULL == page ) {
+      retroflat_px_release( target );
    }
 }
 
@@ -42,6 +42,25 @@
 #  define RETROTILE_VORONOI_DEFAULT_DRIFT 4
 #endif /* !RETROTILE_VORONOI_DEFAULT_DRIFT */
 
+#ifndef RETROTILE_GEN_BAND_H
+/**
+ * \brief Rows in each band that generators split a tilemap into.
+ *
+ * Bands are the unit of work for ::RETROTILE_GEN_THREADS and each band has
+ * its own random stream, so changing this changes the generated output for
+ * a given seed. Changing the number of threads does not.
+ */
+#  define RETROTILE_GEN_BAND_H 32
+#endif /* !RETROTILE_GEN_BAND_H */
+
+#ifndef RETROTILE_GEN_THREADS
+/**
+ * \brief Number of threads to generate bands on. Only used on
+ *        RETROFLAT_OS_UNIX, where it requires linking with -lpthread.
+ */
+#  define RETROTILE_GEN_THREADS 1
+#endif /* !RETROTILE_GEN_THREADS */
+
 #ifdef MPARSER_TRACE_NAMES
 #  define retrotile_mstate_name( state ) gc_retrotile_mstate_names[state]
 #else
@@ -123,8 +142,32 @@ struct RETROTILE_DATA_DS {
    int16_t sect_h_half;
    retroflat_tile_t highest_generated;
    retroflat_tile_t lowest_generated;
+   /*! \brief Random stream for this subsector, split off from its parent. */
+   struct MRAND_STATE rand;
 };
 
+/**
+ * \brief A band of rows handed to a generator pass by
+ *        retrotile_gen_bands().
+ */
+struct RETROTILE_GEN_BAND {
+   struct RETROTILE* t;
+   struct RETROTILE_LAYER* layer;
+   /**
+    * \brief Read-only snapshot of the layer from before this pass. Bands
+    *        read their neighbors' edge rows (halo) from here, and write only
+    *        their own rows to the layer.
+    */
+   const retroflat_tile_t* src;
+   size_t y_start;
+   size_t y_end;
+   struct MRAND_STATE rand;
+   /*! \brief Set to 0 by a pass if this band needs another pass. */
+   int16_t finished;
+};
+
+typedef void (*retrotile_gen_band_cb)( struct RETROTILE_GEN_BAND* band );
+
 struct RETROTILE_DATA_BORDER {
    int16_t tiles_changed;
    retroflat_tile_t center;
@@ -286,12 +329,40 @@ MERROR_RETVAL retrotile_alloc_tile_defs(
 MERROR_RETVAL retrotile_alloc(
    MAUG_MHANDLE* p_tilemap_h, size_t w, size_t h, size_t layers_count );
 
+/**
+ * \brief Set the seed used by random generators, so the same seed always
+ *        produces the same tilemap. If this is 0, a new seed is picked for
+ *        each generator call.
+ */
+void retrotile_gen_seed( uint32_t seed );
+
+/**
+ * \brief Run a generator pass over every ::RETROTILE_GEN_BAND of a layer,
+ *        on ::RETROTILE_GEN_THREADS threads if available.
+ * \param src Snapshot of the layer that bands read from.
+ * \param seed Seed that each band's RETROTILE_GEN_BAND::rand stream is
+ *             derived from.
+ * \param p_finished If not NULL, set to 0 if any band was not finished.
+ */
+MERROR_RETVAL retrotile_gen_bands(
+   struct RETROTILE* t, struct RETROTILE_LAYER* layer,
+   const retroflat_tile_t* src, uint32_t seed,
+   retrotile_gen_band_cb band_cb, int16_t* p_finished,
+   retrotile_ani_cb animation_cb, void* animation_cb_data );
+
 /*! \} */ /* retrotile_gen */
 
 #ifdef RETROTIL_C
 
 #  include <mparser.h>
 
+#  if 1 < RETROTILE_GEN_THREADS && defined( RETROFLAT_OS_UNIX )
+#     define RETROTILE_GEN_PTHREADS
+#     include <pthread.h>
+#  endif /* 1 < RETROTILE_GEN_THREADS && RETROFLAT_OS_UNIX */
+
+static uint32_t gs_retrotile_gen_seed = 0;
+
 /* TODO: Function names should be verb_noun! */
 
 #define retrotile_parser_mstate( parser, new_mstate ) \
@@ -862,15 +933,160 @@ cleanup:
 
 /* === */
 
+static uint32_t retrotile_gen_get_seed() {
+   if( 0 != gs_retrotile_gen_seed ) {
+      return gs_retrotile_gen_seed;
+   }
+   return mrand_next( mrand_stream( MRAND_STREAM_RETROTILE ) );
+}
+
+/* === */
+
+void retrotile_gen_seed( uint32_t seed ) {
+   gs_retrotile_gen_seed = seed;
+}
+
+/* === */
+
+#ifdef RETROTILE_GEN_PTHREADS
+
+struct RETROTILE_GEN_THREAD {
+   struct RETROTILE_GEN_BAND* bands;
+   size_t bands_ct;
+   size_t first;
+   retrotile_gen_band_cb band_cb;
+};
+
+static void* retrotile_gen_thread( void* data ) {
+   struct RETROTILE_GEN_THREAD* thread = (struct RETROTILE_GEN_THREAD*)data;
+   size_t i = 0;
+
+   /* Stripe bands across threads. Bands are independent, so the order they
+    * are run in does not affect the output.
+    */
+   for( i = thread->first ; thread->bands_ct > i ; i += RETROTILE_GEN_THREADS ) {
+      thread->band_cb( &(thread->bands[i]) );
+   }
+
+   return NULL;
+}
+
+#endif /* RETROTILE_GEN_PTHREADS */
+
+/* === */
+
+MERROR_RETVAL retrotile_gen_bands(
+   struct RETROTILE* t, struct RETROTILE_LAYER* layer,
+   const retroflat_tile_t* src, uint32_t seed,
+   retrotile_gen_band_cb band_cb, int16_t* p_finished,
+   retrotile_ani_cb animation_cb, void* animation_cb_data
+) {
+   MERROR_RETVAL retval = MERROR_OK;
+   MAUG_MHANDLE bands_h = (MAUG_MHANDLE)NULL;
+   struct RETROTILE_GEN_BAND* bands = NULL;
+   size_t bands_ct = 0,
+      i = 0;
+#ifdef RETROTILE_GEN_PTHREADS
+   pthread_t threads[RETROTILE_GEN_THREADS];
+   struct RETROTILE_GEN_THREAD threads_data[RETROTILE_GEN_THREADS];
+   size_t threads_ct = 0;
+#endif /* RETROTILE_GEN_PTHREADS */
+
+   bands_ct = (t->tiles_h + RETROTILE_GEN_BAND_H - 1) / RETROTILE_GEN_BAND_H;
+   if( 0 == bands_ct ) {
+      goto cleanup;
+   }
+
+   bands_h = maug_malloc( bands_ct, sizeof( struct RETROTILE_GEN_BAND ) );
+   maug_cleanup_if_null_alloc( MAUG_MHANDLE, bands_h );
+   maug_mlock( bands_h, bands );
+   maug_cleanup_if_null_lock( struct RETROTILE_GEN_BAND*, bands );
+
+   for( i = 0 ; bands_ct > i ; i++ ) {
+      bands[i].t = t;
+      bands[i].layer = layer;
+      bands[i].src = src;
+      bands[i].y_start = i * RETROTILE_GEN_BAND_H;
+      bands[i].y_end = bands[i].y_start + RETROTILE_GEN_BAND_H;
+      if( bands[i].y_end > t->tiles_h ) {
+         bands[i].y_end = t->tiles_h;
+      }
+      mrand_seed( &(bands[i].rand), seed, i );
+      bands[i].finished = 1;
+   }
+
+#ifdef RETROTILE_GEN_PTHREADS
+   for( i = 0 ; RETROTILE_GEN_THREADS > i && bands_ct > i ; i++ ) {
+      threads_data[i].bands = bands;
+      threads_data[i].bands_ct = bands_ct;
+      threads_data[i].first = i;
+      threads_data[i].band_cb = band_cb;
+      if( 0 != pthread_create(
+         &(threads[i]), NULL, retrotile_gen_thread, &(threads_data[i]) )
+      ) {
+         error_printf( "unable to start generator thread!" );
+         retval = MERROR_EXEC;
+         break;
+      }
+      threads_ct++;
+   }
+
+   /* Always wait for started threads, even on failure, since they use
+    * the bands.
+    */
+   for( i = 0 ; threads_ct > i ; i++ ) {
+      pthread_join( threads[i], NULL );
+   }
+   maug_cleanup_if_not_ok();
+
+   if( NULL != animation_cb ) {
+      for( i = 0 ; bands_ct > i ; i++ ) {
+         retval = animation_cb( animation_cb_data, bands[i].y_start );
+         maug_cleanup_if_not_ok();
+      }
+   }
+#else
+   for( i = 0 ; bands_ct > i ; i++ ) {
+      band_cb( &(bands[i]) );
+      if( NULL != animation_cb ) {
+         retval = animation_cb( animation_cb_data, bands[i].y_start );
+         maug_cleanup_if_not_ok();
+      }
+   }
+#endif /* RETROTILE_GEN_PTHREADS */
+
+   if( NULL != p_finished ) {
+      for( i = 0 ; bands_ct > i ; i++ ) {
+         if( !bands[i].finished ) {
+            *p_finished = 0;
+         }
+      }
+   }
+
+cleanup:
+
+   if( NULL != bands ) {
+      maug_munlock( bands_h, bands );
+   }
+
+   if( (MAUG_MHANDLE)NULL != bands_h ) {
+      maug_mfree( bands_h );
+   }
+
+   return retval;
+}
+
+/* === */
+
 static retroflat_tile_t retrotile_gen_diamond_square_rand(
    retroflat_tile_t min_z, retroflat_tile_t max_z, uint32_t tuning,
-   retroflat_tile_t top_left_z
+   retroflat_tile_t top_left_z, struct MRAND_STATE* rand
 ) {
    retroflat_tile_t avg = top_left_z;
 
-   if( 8 > rand() % 10 ) {
+   if( 8 > mrand_range( rand, 10 ) ) {
       /* avg = min_z + (rand() % (max_z - min_z)); */
-      avg -= (min_z / tuning) + (rand() % (max_z / tuning));
+      avg -= (min_z / tuning) + mrand_range( rand, max_z / tuning );
    /* } else {
       avg += (min_z / 10) + (rand() % (max_z / 10)); */
    }
@@ -966,7 +1182,7 @@ static void retrotile_gen_diamond_square_corners(
 
          /* Generate a new value for this corner. */
          *tile_iter = retrotile_gen_diamond_square_rand(
-            min_z, max_z, tuning, top_left_z );
+            min_z, max_z, tuning, top_left_z, &(data_ds->rand) );
 
          debug_printf( RETROTILE_TRACE_LVL,
             "missing corner coord %d x %d: %d",
@@ -1078,6 +1294,7 @@ MERROR_RETVAL retrotile_gen_diamond_square_iter(
       data_ds->sect_w_half = data_ds->sect_w >> 1;
       data_ds->sect_h_half = data_ds->sect_h >> 1;
       data_ds->lowest_generated = 32767;
+      mrand_seed( &(data_ds->rand), retrotile_gen_get_seed(), 0 );
 
       /* Disable this flag for subsequent calls. */
       flags &= ~RETROTILE_DS_FLAG_INIT_DATA;
@@ -1160,6 +1377,8 @@ MERROR_RETVAL retrotile_gen_diamond_square_iter(
          data_ds_sub.sect_h_half = data_ds_sub.sect_h >> 1;
          data_ds_sub.lowest_generated = 32767;
          data_ds_sub.highest_generated = 0;
+         /* Give each subsector its own stream so siblings differ. */
+         mrand_seed( &(data_ds_sub.rand), mrand_next( &(data_ds->rand) ), 0 );
 
          debug_printf(
             RETROTILE_TRACE_LVL, "%d: child sector at %d x %d, %d wide",
@@ -1204,13 +1423,59 @@ cleanup:
 
 /* === */
 
+static void retrotile_gen_voronoi_band( struct RETROTILE_GEN_BAND* band ) {
+   size_t x = 0,
+      y = 0,
+      n_x = 0,
+      n_y = 0;
+   int8_t side_iter = 0;
+   retroflat_tile_t* tile_iter = NULL;
+   const retroflat_tile_t* src = band->src;
+   size_t tiles_w = band->t->tiles_w;
+
+   for( y = band->y_start ; band->y_end > y ; y++ ) {
+      for( x = 0 ; tiles_w > x ; x++ ) {
+         if( -1 != src[(y * tiles_w) + x] ) {
+            /* Skip filled tile. */
+            continue;
+         }
+
+         /* Pull from the first filled neighbor that would have expanded
+          * into this tile. Only this tile is written, so bands never write
+          * to each others' rows.
+          */
+         tile_iter = &(retrotile_get_tile( band->t, band->layer, x, y ));
+         for( side_iter = 0 ; 4 > side_iter ; side_iter++ ) {
+            n_x = x - gc_retroflat_offsets4_x[side_iter];
+            n_y = y - gc_retroflat_offsets4_y[side_iter];
+            /* size_t wraps around on the low side. */
+            if(
+               tiles_w > n_x && band->t->tiles_h > n_y &&
+               -1 != src[(n_y * tiles_w) + n_x]
+            ) {
+               *tile_iter = src[(n_y * tiles_w) + n_x];
+               break;
+            }
+         }
+
+         if( -1 == *tile_iter ) {
+            /* If there are still unfilled tiles, we're not finished yet! */
+            band->finished = 0;
+         }
+      }
+   }
+}
+
+/* === */
+
 MERROR_RETVAL retrotile_gen_voronoi_iter(
    struct RETROTILE* t, retroflat_tile_t min_z, retroflat_tile_t max_z,
    uint32_t tuning, size_t layer_idx, uint8_t flags, void* data,
    retrotile_ani_cb animation_cb, void* animation_cb_data
 ) {
    size_t x = 0,
-      y = 0;
+      y = 0,
+      band_idx = 0;
    int16_t offset_x = 0,
       offset_y = 0,
       finished = 0;
@@ -1221,22 +1486,30 @@ MERROR_RETVAL retrotile_gen_voronoi_iter(
    MAUG_MHANDLE temp_grid_h = (MAUG_MHANDLE)NULL;
    retroflat_tile_t* temp_grid = NULL;
    retroflat_tile_t* tiles = NULL;
-   /* Only use 4 cardinal directions. */
-   int8_t side_iter = 0;
+   uint32_t seed = 0;
+   struct MRAND_STATE rand;
 
    layer = retrotile_get_layer_p( t, 0 );
 
    tiles = retrotile_get_tiles_p( layer );
 
+   seed = retrotile_gen_get_seed();
+
    /* Initialize grid to empty. */
    memset( tiles, -1,
       t->tiles_w * t->tiles_h * sizeof( retroflat_tile_t ) );
 
-   /* Generate the initial sector starting points. */
-   for( y = 0 ; t->tiles_w > y ; y += spb ) {
+   /* Generate the initial sector starting points, drawing random numbers
+    * from the stream of the band each point is in.
+    */
+   for( y = 0 ; t->tiles_h > y ; y += spb ) {
+      if( 0 == y || band_idx != y / RETROTILE_GEN_BAND_H ) {
+         band_idx = y / RETROTILE_GEN_BAND_H;
+         mrand_seed( &rand, seed, band_idx );
+      }
       for( x = 0 ; t->tiles_w > x ; x += spb ) {
-         offset_x = x + ((drift * -1) + (rand() % drift));
-         offset_y = y + ((drift * -1) + (rand() % drift));
+         offset_x = x + ((drift * -1) + mrand_range( &rand, drift ));
+         offset_y = y + ((drift * -1) + mrand_range( &rand, drift ));
 
          /* Clamp sector offsets onto map borders. */
          if( 0 > offset_x ) {
@@ -1253,7 +1526,7 @@ MERROR_RETVAL retrotile_gen_voronoi_iter(
          }
 
          retrotile_get_tile( t, layer, offset_x, offset_y ) =
-            min_z + (rand() % max_z);
+            min_z + mrand_range( &rand, max_z );
       }
    }
 
@@ -1280,49 +1553,9 @@ MERROR_RETVAL retrotile_gen_voronoi_iter(
 
       /* Starting another pass, assume finished until proven otherwise. */
       finished = 1;
-      for( y = 0 ; t->tiles_h > y ; y++ ) {
-         for( x = 0 ; t->tiles_w > x ; x++ ) {
-            if( -1 == retrotile_get_tile( t, layer, x, y ) ) {
-               /* If there are still unfilled tiles, we're not finished
-                * yet!
-                */
-               finished = 0;
-
-               /* Skip filled tile. */
-               continue;
-            }
-
-
-            for( side_iter = 0 ; 4 > side_iter ; side_iter++ ) {
-               debug_printf( RETROTILE_TRACE_LVL,
-                  SIZE_T_FMT " (%d), " SIZE_T_FMT " (%d) ("
-                  SIZE_T_FMT ", " SIZE_T_FMT ")", 
-                  x,
-                  gc_retroflat_offsets4_x[side_iter],
-                  y,
-                  gc_retroflat_offsets4_y[side_iter],
-                  t->tiles_w, t->tiles_h );
-            
-               /* Iterate through directions to expand. */
-               /* TODO: Add tuning to select directional probability. */
-               if(
-                  t->tiles_w > x + gc_retroflat_offsets4_x[side_iter] &&
-                  t->tiles_h > y + gc_retroflat_offsets4_y[side_iter] &&
-                  -1 == temp_grid[
-                     ((y + gc_retroflat_offsets4_y[side_iter]) *
-                        t->tiles_w) +
-                           (x + gc_retroflat_offsets4_x[side_iter])]
-               ) {
-                  /* Copy center tile to this direction. */
-                  retrotile_get_tile( t, layer,
-                     x + gc_retroflat_offsets4_x[side_iter],
-                     y + gc_retroflat_offsets4_y[side_iter] ) =
-                        retrotile_get_tile( t, layer, x, y );
-                  break;
-               }
-            }
-         }
-      }
+      retval = retrotile_gen_bands( t, layer, temp_grid, seed,
+         retrotile_gen_voronoi_band, &finished, NULL, NULL );
+      maug_cleanup_if_not_ok();
    }
 
 cleanup:
@@ -1340,67 +1573,84 @@ cleanup:
 
 /* === */
 
-MERROR_RETVAL retrotile_gen_smooth_iter(
-   struct RETROTILE* t, retroflat_tile_t min_z, retroflat_tile_t max_z,
-   uint32_t tuning, size_t layer_idx, uint8_t flags, void* data,
-   retrotile_ani_cb animation_cb, void* animation_cb_data
-) {
-   MERROR_RETVAL retval = MERROR_OK;
+static void retrotile_gen_smooth_band( struct RETROTILE_GEN_BAND* band ) {
    size_t x = 0,
-      y = 0;
+      y = 0,
+      n_x = 0,
+      n_y = 0;
    int16_t side_iter = 0,
       sides_avail = 0,
       sides_sum = 0;
-   /* Sides start from 12 on the clock (up). */
-   struct RETROTILE_LAYER* layer = NULL;
+   const retroflat_tile_t* src = band->src;
+   size_t tiles_w = band->t->tiles_w;
 
-   assert( NULL != t );
-   layer = retrotile_get_layer_p( t, layer_idx );
-   assert( NULL != layer );
-   
-   for( y = 0 ; t->tiles_h > y ; y++ ) {
-      if( NULL != animation_cb ) {
-         retval = animation_cb( animation_cb_data, y );
-         maug_cleanup_if_not_ok();
-      }
-      for( x = 0 ; t->tiles_w > x ; x++ ) {
+   for( y = band->y_start ; band->y_end > y ; y++ ) {
+      for( x = 0 ; tiles_w > x ; x++ ) {
          /* Reset average. */
          sides_avail = 0;
          sides_sum = 0;
 
-         /* Grab values for available sides. */
+         /* Grab values for available sides from the snapshot, so the
+          * tiles already smoothed this pass don't affect their neighbors.
+          */
          for( side_iter = 0 ; 8 > side_iter ; side_iter++ ) {
-            if(
-               t->tiles_w <= x + gc_retroflat_offsets8_x[side_iter] ||
-               t->tiles_h <= y + gc_retroflat_offsets8_y[side_iter]
-            ) {
+            n_x = x + gc_retroflat_offsets8_x[side_iter];
+            n_y = y + gc_retroflat_offsets8_y[side_iter];
+            if( tiles_w <= n_x || band->t->tiles_h <= n_y ) {
                continue;
             }
 
             sides_avail++;
-            debug_printf(
-               RETROTILE_TRACE_LVL,
-               "si %d: x, y: " SIZE_T_FMT " (+%d), " SIZE_T_FMT
-                  " (+%d) idx: " SIZE_T_FMT,
-               side_iter,
-               x + gc_retroflat_offsets8_x[side_iter],
-               gc_retroflat_offsets8_x[side_iter],
-               y + gc_retroflat_offsets8_y[side_iter],
-               gc_retroflat_offsets8_y[side_iter],
-               ((y + gc_retroflat_offsets8_y[side_iter]) * t->tiles_w) +
-                  x + gc_retroflat_offsets8_x[side_iter] );
-            sides_sum += retrotile_get_tile(
-               t, layer,
-               x + gc_retroflat_offsets8_x[side_iter],
-               y + gc_retroflat_offsets8_y[side_iter] );
+            sides_sum += src[(n_y * tiles_w) + n_x];
          }
 
-         retrotile_get_tile( t, layer, x, y ) = sides_sum / sides_avail;
+         retrotile_get_tile( band->t, band->layer, x, y ) =
+            sides_sum / sides_avail;
       }
    }
+}
+
+/* === */
+
+MERROR_RETVAL retrotile_gen_smooth_iter(
+   struct RETROTILE* t, retroflat_tile_t min_z, retroflat_tile_t max_z,
+   uint32_t tuning, size_t layer_idx, uint8_t flags, void* data,
+   retrotile_ani_cb animation_cb, void* animation_cb_data
+) {
+   MERROR_RETVAL retval = MERROR_OK;
+   MAUG_MHANDLE temp_grid_h = (MAUG_MHANDLE)NULL;
+   retroflat_tile_t* temp_grid = NULL;
+   /* Sides start from 12 on the clock (up). */
+   struct RETROTILE_LAYER* layer = NULL;
+
+   assert( NULL != t );
+   layer = retrotile_get_layer_p( t, layer_idx );
+   assert( NULL != layer );
+
+   temp_grid_h = maug_malloc(
+      sizeof( retroflat_tile_t ), t->tiles_w * t->tiles_h );
+   maug_cleanup_if_null_alloc( MAUG_MHANDLE, temp_grid_h );
+
+   maug_mlock( temp_grid_h, temp_grid );
+   maug_cleanup_if_null_lock( retroflat_tile_t*, temp_grid );
+
+   /* Double-buffer the pass, so bands can be smoothed in any order. */
+   memcpy( temp_grid, retrotile_get_tiles_p( layer ),
+      sizeof( retroflat_tile_t ) * t->tiles_w * t->tiles_h );
+
+   retval = retrotile_gen_bands( t, layer, temp_grid, 0,
+      retrotile_gen_smooth_band, NULL, animation_cb, animation_cb_data );
 
 cleanup:
 
+   if( NULL != temp_grid ) {
+      maug_munlock( temp_grid_h, temp_grid );
+   }
+
+   if( NULL != temp_grid_h ) {
+      maug_mfree( temp_grid_h );
+   }
+
    return retval;
 }
 
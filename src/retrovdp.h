@@ -0,0 +1,172 @@
+
+#ifndef RETROVDP_H
+#define RETROVDP_H
+
+/**
+ * \addtogroup maug_retrovdp RetroFlat VDP Kernels
+ * \brief Pixel kernels for \ref maug_retroflt_vdp plugins to post-process
+ *        frames with.
+ *
+ * These work on locked buffers of 32-bit pixels, given as a pointer to the
+ * top row and the signed distance in bytes from each row to the next, so
+ * bottom-up bitmaps can be passed as a pointer to their last row with a
+ * negative pitch. They work a row at a time with simple inner loops, so the
+ * compiler can vectorize them.
+ *
+ * This header does not depend on RetroFlat, so the kernels can be tested
+ * without a display. Define RETROVDP_C in one file to build them, as a VDP
+ * plugin would anyway (see vdp/retrovdp.c).
+ * \{
+ * \file retrovdp.h
+ */
+
+/**
+ * \brief Get a pointer to row y of a 32-bit pixel buffer.
+ */
+#define retrovdp_row( buf, pitch, y ) \
+   ((uint32_t*)&(((uint8_t*)(buf))[(ssize_t)(y) * (pitch)]))
+
+/**
+ * \brief Scale a buffer into another by an integer factor, repeating each
+ *        pixel scale times across and down.
+ * \param dest Buffer at least src_w * scale by src_h * scale pixels.
+ */
+void retrovdp_scale_nearest(
+   const uint8_t* src, ssize_t src_pitch, size_t src_w, size_t src_h,
+   uint8_t* dest, ssize_t dest_pitch, uint8_t scale );
+
+/**
+ * \brief Darken the last row of every period rows to half brightness, like
+ *        the gaps between scanlines on a CRT.
+ *
+ * This halves all four bytes of each pixel, so it is only meant for
+ * true color formats.
+ */
+void retrovdp_scanlines(
+   uint8_t* buf, ssize_t pitch, size_t w, size_t h, uint8_t period );
+
+/**
+ * \brief Replace every pixel matching a color in from with the color at the
+ *        same index in to.
+ *
+ * Each pixel is only replaced once, so a color can be swapped with another.
+ */
+void retrovdp_remap(
+   uint8_t* buf, ssize_t pitch, size_t w, size_t h,
+   const uint32_t* from, const uint32_t* to, size_t map_sz );
+
+#ifdef RETROVDP_C
+
+/* Copy each pixel in src_row into s pixels in dest_row. With a constant s,
+ * the inner loop is unrolled into a single vector store.
+ */
+#define _retrovdp_widen_row( s ) \
+   for( x = 0 ; src_w > x ; x++ ) { \
+      for( k = 0 ; (s) > k ; k++ ) { \
+         dest_row[(x * (s)) + k] = src_row[x]; \
+      } \
+   }
+
+void retrovdp_scale_nearest(
+   const uint8_t* src, ssize_t src_pitch, size_t src_w, size_t src_h,
+   uint8_t* dest, ssize_t dest_pitch, uint8_t scale
+) {
+   size_t x = 0,
+      y = 0,
+      k = 0;
+   const uint32_t* src_row = NULL;
+   uint32_t* dest_row = NULL;
+
+   assert( 0 < scale );
+
+   for( y = 0 ; src_h > y ; y++ ) {
+      src_row = retrovdp_row( src, src_pitch, y );
+      dest_row = retrovdp_row( dest, dest_pitch, y * scale );
+
+      /* Widen the source row into the first of its destination rows. */
+      switch( scale ) {
+      case 1:
+         memcpy( dest_row, src_row, src_w * sizeof( uint32_t ) );
+         break;
+
+      case 2:
+         _retrovdp_widen_row( 2 );
+         break;
+
+      case 3:
+         _retrovdp_widen_row( 3 );
+         break;
+
+      case 4:
+         _retrovdp_widen_row( 4 );
+         break;
+
+      default:
+         _retrovdp_widen_row( scale );
+         break;
+      }
+
+      /* Then copy that into the rest of its destination rows. */
+      for( k = 1 ; scale > k ; k++ ) {
+         memcpy(
+            retrovdp_row( dest, dest_pitch, (y * scale) + k ), dest_row,
+            src_w * scale * sizeof( uint32_t ) );
+      }
+   }
+}
+
+/* === */
+
+void retrovdp_scanlines(
+   uint8_t* buf, ssize_t pitch, size_t w, size_t h, uint8_t period
+) {
+   size_t x = 0,
+      y = 0;
+   uint32_t* row = NULL;
+
+   assert( 0 < period );
+
+   for( y = period - 1 ; h > y ; y += period ) {
+      row = retrovdp_row( buf, pitch, y );
+      for( x = 0 ; w > x ; x++ ) {
+         /* Halve every byte in the pixel at once. */
+         row[x] = (row[x] >> 1) & 0x7f7f7f7f;
+      }
+   }
+}
+
+/* === */
+
+void retrovdp_remap(
+   uint8_t* buf, ssize_t pitch, size_t w, size_t h,
+   const uint32_t* from, const uint32_t* to, size_t map_sz
+) {
+   size_t x = 0,
+      y = 0,
+      i = 0;
+   uint32_t* row = NULL;
+   uint32_t px = 0,
+      px_out = 0;
+
+   for( y = 0 ; h > y ; y++ ) {
+      row = retrovdp_row( buf, pitch, y );
+      for( x = 0 ; w > x ; x++ ) {
+         /* Select instead of branching, and always compare to the original
+          * pixel so it is only replaced once.
+          */
+         px = row[x];
+         px_out = px;
+         for( i = 0 ; map_sz > i ; i++ ) {
+            px_out = from[i] == px ? to[i] : px_out;
+         }
+         row[x] = px_out;
+      }
+   }
+}
+
+#endif /* RETROVDP_C */
+
+/*! \} */ /* maug_retrovdp */
+
+#endif /* !RETROVDP_H */
+
@@ -19,7 +19,21 @@ struct RETROWIN3D {
    size_t x;
    size_t y;
    struct RETROGUI* gui;
+   /**
+    * \brief Bitmap the GUI is drawn on. Its texture is kept between frames
+    *        and only the parts the GUI redraws are uploaded again.
+    */
    struct RETROFLAT_BITMAP gui_bmp;
+   /*! \brief GL list that draws the window quad, or 0 if not built yet. */
+   uint32_t quad_list;
+   /*! \brief Screen size RETROWIN3D::quad_list was built for. */
+   size_t quad_screen_w;
+   size_t quad_screen_h;
+   /*! \brief GUI area RETROWIN3D::quad_list was built for. */
+   size_t quad_x;
+   size_t quad_y;
+   size_t quad_w;
+   size_t quad_h;
 };
 
 MERROR_RETVAL retro3dw_redraw_win( struct RETROWIN3D* win );
@@ -49,6 +63,30 @@ MERROR_RETVAL retro3dw_destroy_win(
 
 #ifdef RETROW3D_C
 
+static void _retro3dw_draw_quad(
+   float screen_x, float screen_y, float gui_w_f, float gui_h_f
+) {
+   /* Break up overlay into multiple triangles with offset textures. */
+
+   glBegin( GL_TRIANGLES );
+
+      glTexCoord2f( 0, 0 );
+      glVertex3f( screen_x,            screen_y,            RETROFLAT_GL_Z );
+      glTexCoord2f( 0, 1 );
+      glVertex3f( screen_x,            screen_y - gui_h_f, RETROFLAT_GL_Z );
+      glTexCoord2f( 1, 1 );
+      glVertex3f( screen_x + gui_w_f, screen_y - gui_h_f, RETROFLAT_GL_Z );
+
+      glTexCoord2f( 1, 1 );
+      glVertex3f( screen_x + gui_w_f, screen_y - gui_h_f, RETROFLAT_GL_Z );
+      glTexCoord2f( 1, 0 );
+      glVertex3f( screen_x + gui_w_f, screen_y,            RETROFLAT_GL_Z );
+      glTexCoord2f( 0, 0 );
+      glVertex3f( screen_x,            screen_y,            RETROFLAT_GL_Z );
+   
+   glEnd();
+}
+
 MERROR_RETVAL retro3dw_redraw_win( struct RETROWIN3D* win ) {
    float aspect_ratio = 0,
       screen_x = 0,
@@ -90,13 +128,19 @@ MERROR_RETVAL retro3dw_redraw_win( struct RETROWIN3D* win ) {
    retval = retroglu_check_errors( "overlay color" );
    maug_cleanup_if_not_ok();
 
-   /* debug_printf( 1, "overlay texture: %d x %d (%p)",
-      win->gui_bmp.tex.w, win->gui_bmp.tex.h,
-      win->gui_bmp.tex.bytes ); */
+#ifndef RETROGLU_NO_TEXTURE_LISTS
+   /* Upload only what retrogui_redraw_ctls() drew, if anything, to the
+    * texture kept from the last frame.
+    */
+   retroflat_draw_release( &(win->gui_bmp) );
+   glBindTexture( GL_TEXTURE_2D, win->gui_bmp.tex.id );
+#else
+   /* Without texture objects, the texture must be specified every time. */
    glTexImage2D( GL_TEXTURE_2D, 0, GL_RGBA,
       win->gui_bmp.tex.w, win->gui_bmp.tex.h, 0,
       GL_RGBA, GL_UNSIGNED_BYTE,
       win->gui_bmp.tex.bytes );
+#endif /* !RETROGLU_NO_TEXTURE_LISTS */
 
    retval = retroglu_check_errors( "overlay texture" );
    maug_cleanup_if_not_ok();
@@ -106,29 +150,48 @@ MERROR_RETVAL retro3dw_redraw_win( struct RETROWIN3D* win ) {
    glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST );
    glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST );
 
-   /* Break up overlay into multiple triangles with offset textures. */
-
-   glBegin( GL_TRIANGLES );
-
-      glTexCoord2f( 0, 0 );
-      glVertex3f( screen_x,            screen_y,            RETROFLAT_GL_Z );
-      glTexCoord2f( 0, 1 );
-      glVertex3f( screen_x,            screen_y - gui_h_f, RETROFLAT_GL_Z );
-      glTexCoord2f( 1, 1 );
-      glVertex3f( screen_x + gui_w_f, screen_y - gui_h_f, RETROFLAT_GL_Z );
+#ifndef RETROGLU_NO_LISTS
+   /* The quad only changes if the screen is resized or the GUI is moved or
+    * resized.
+    */
+   if(
+      0 == win->quad_list ||
+      (size_t)retroflat_screen_w() != win->quad_screen_w ||
+      (size_t)retroflat_screen_h() != win->quad_screen_h ||
+      win->gui->x != win->quad_x ||
+      win->gui->y != win->quad_y ||
+      win->gui->w != win->quad_w ||
+      win->gui->h != win->quad_h
+   ) {
+      if( 0 != win->quad_list ) {
+         glDeleteLists( win->quad_list, 1 );
+      }
+      debug_printf( RETROWIN3D_TRACE_LVL,
+         "building quad list for window: " SIZE_T_FMT, win->idc );
+      win->quad_list = glGenLists( 1 );
+      glNewList( win->quad_list, GL_COMPILE );
+      _retro3dw_draw_quad( screen_x, screen_y, gui_w_f, gui_h_f );
+      glEndList();
+      win->quad_screen_w = retroflat_screen_w();
+      win->quad_screen_h = retroflat_screen_h();
+      win->quad_x = win->gui->x;
+      win->quad_y = win->gui->y;
+      win->quad_w = win->gui->w;
+      win->quad_h = win->gui->h;
+   }
 
-      glTexCoord2f( 1, 1 );
-      glVertex3f( screen_x + gui_w_f, screen_y - gui_h_f, RETROFLAT_GL_Z );
-      glTexCoord2f( 1, 0 );
-      glVertex3f( screen_x + gui_w_f, screen_y,            RETROFLAT_GL_Z );
-      glTexCoord2f( 0, 0 );
-      glVertex3f( screen_x,            screen_y,            RETROFLAT_GL_Z );
-   
-   glEnd();
+   glCallList( win->quad_list );
+#else
+   _retro3dw_draw_quad( screen_x, screen_y, gui_w_f, gui_h_f );
+#endif /* !RETROGLU_NO_LISTS */
 
+#ifndef RETROGLU_NO_TEXTURE_LISTS
+   glBindTexture( GL_TEXTURE_2D, 0 );
+#else
    /* Clear texture after drawing. */
    glTexImage2D( GL_TEXTURE_2D, 0, GL_RGBA, 0, 0, 0,
       GL_RGBA, GL_UNSIGNED_BYTE, NULL ); 
+#endif /* !RETROGLU_NO_TEXTURE_LISTS */
 
 cleanup:
 
@@ -217,6 +280,12 @@ cleanup:
 
 void retro3dw_free_win( struct RETROWIN3D* win ) {
 
+#ifndef RETROGLU_NO_LISTS
+   if( 0 != win->quad_list ) {
+      glDeleteLists( win->quad_list, 1 );
+   }
+#endif /* !RETROGLU_NO_LISTS */
+
    if( RETROWIN3D_FLAG_INIT_BMP == (RETROWIN3D_FLAG_INIT_BMP & win->flags) ) {
       retroflat_destroy_bitmap( &(win->gui_bmp) );
       win->gui->draw_bmp = NULL;
@@ -225,6 +294,7 @@ void retro3dw_free_win( struct RETROWIN3D* win ) {
    if( RETROWIN3D_FLAG_INIT_GUI == (RETROWIN3D_FLAG_INIT_GUI & win->flags) ) {
 #ifndef RETROGXC_PRESENT
       if( (MAUG_MHANDLE)NULL != win->gui->font_h ) {
+         retrofont_cache_free( win->gui->font_h );
          maug_mfree( win->gui->font_h );
       }
 #endif /* RETROGXC_PRESENT */
@@ -2,6 +2,22 @@
 #ifndef RETROXPM_H
 #define RETROXPM_H
 
+/**
+ * \brief Compiled-in image converted from XPM to palette indexes at build
+ *        time by make/Makexpm.inc.
+ */
+struct RETROXPM_ASSET {
+   /*! \brief Basename of the bitmap the asset was made from. */
+   const char* name;
+   uint16_t w;
+   uint16_t h;
+   /**
+    * \brief w * h ::RETROFLAT_COLOR indexes, row by row. Black pixels are
+    *        left transparent.
+    */
+   MAUG_CONST uint8_t* px;
+};
+
 /**
  * \brief Load a compiled-in XPM image into an API-specific bitmap context.
  * \warn The XPM must have been generated from a bitmap using the rather
@@ -19,59 +35,49 @@ MERROR_RETVAL retroflat_load_xpm(
 
 #ifdef RETROFLT_C
 
-extern MAUG_CONST char* SEG_MCONST gc_xpm_filenames[];
-extern MAUG_CONST char** SEG_MCONST gc_xpm_data[];
+/*! \brief Directory of assets, sorted by name. */
+extern MAUG_CONST struct RETROXPM_ASSET SEG_MCONST gc_xpm_assets[];
+extern MAUG_CONST size_t SEG_MCONST gc_xpm_assets_sz;
 
 MERROR_RETVAL retroflat_load_xpm(
    const char* filename, struct RETROFLAT_BITMAP* bmp_out, uint8_t flags
 ) {
    MERROR_RETVAL retval = MERROR_OK;
-   RETROFLAT_COLOR color;
-   int16_t xpm_idx = 0,
-      x = 0,
-      y = 0,
-      bmp_w = 0,
-      bmp_h = 0,
-      bmp_colors,
-      bmp_bypp;
+   MAUG_CONST struct RETROXPM_ASSET* asset = NULL;
+   MAUG_CONST uint8_t* row = NULL;
+   size_t lo = 0,
+      hi = gc_xpm_assets_sz,
+      mid = 0;
+   int cmp = 0;
+   int16_t y = 0;
 
    /* Hunt for the requested XPM in the compiled directory. */
-   while( '\0' != gc_xpm_filenames[xpm_idx][0] ) {
-      if( 0 == strcmp( filename, gc_xpm_filenames[xpm_idx] ) ) {
-         goto xpm_found;
+   while( lo < hi ) {
+      mid = lo + ((hi - lo) / 2);
+      cmp = strcmp( filename, gc_xpm_assets[mid].name );
+      if( 0 == cmp ) {
+         asset = &(gc_xpm_assets[mid]);
+         break;
+      } else if( 0 > cmp ) {
+         hi = mid;
+      } else {
+         lo = mid + 1;
       }
-      xpm_idx++;
    }
 
-   retval = RETROFLAT_ERROR_BITMAP;
-   goto cleanup;
-
-xpm_found:
-
-   debug_printf( 2, "found xpm: %s", gc_xpm_filenames[xpm_idx] );
-
-   /* Load XPM and draw it to a new bitmap. */
-
-   retval = maug_tok_int( 0, gc_xpm_data[xpm_idx][0], 0, &bmp_w );
-   maug_cleanup_if_not_ok();
-   retval = maug_tok_int( 1, gc_xpm_data[xpm_idx][0], 0, &bmp_h );
-   maug_cleanup_if_not_ok();
-   retval = maug_tok_int( 2, gc_xpm_data[xpm_idx][0], 0, &bmp_colors );
-   maug_cleanup_if_not_ok();
-   retval = maug_tok_int( 3, gc_xpm_data[xpm_idx][0], 0, &bmp_bypp );
-   maug_cleanup_if_not_ok();
-
-   debug_printf( 1, "bitmap has: %d colors, %d bypp", bmp_colors, bmp_bypp );
+   if( NULL == asset ) {
+      retval = RETROFLAT_ERROR_BITMAP;
+      goto cleanup;
+   }
 
-   assert( 16 == bmp_colors );
-   assert( 1 == bmp_bypp );
+   debug_printf( 2, "found xpm: %s", asset->name );
 
-   retval = retroflat_create_bitmap( bmp_w, bmp_h, bmp_out, flags );
+   retval = retroflat_create_bitmap( asset->w, asset->h, bmp_out, flags );
    if( MERROR_OK != retval ) {
       goto cleanup;
    }
 
-   debug_printf( 1, "created empty canvas: %dx%d", bmp_w, bmp_h );
+   debug_printf( 1, "created empty canvas: %dx%d", asset->w, asset->h );
 
    /* Draw XPM pixels to canvas. */
 
@@ -81,63 +87,11 @@ xpm_found:
    retroflat_draw_lock( bmp_out );
    retroflat_px_lock( bmp_out );
 
-   for( y = 0 ; bmp_h > y ; y++ ) {
-      for( x = 0 ; bmp_w > x ; x++ ) {
-         switch( gc_xpm_data[xpm_idx][17 + y][x] ) {
-         case ' ':
-            /* Transparent. */
-            /* TODO: Global transparency palette ifdef? */
-            color = RETROFLAT_COLOR_BLACK;
-            continue;
-         case '.':
-            color = RETROFLAT_COLOR_DARKBLUE;
-            break;
-         case 'X':
-            color = RETROFLAT_COLOR_DARKGREEN;
-            break;
-         case 'o':
-            color = RETROFLAT_COLOR_TEAL;
-            break;
-         case 'O':
-            color = RETROFLAT_COLOR_DARKRED;
-            break;
-         case '+':
-            color = RETROFLAT_COLOR_VIOLET;
-            break;
-         case '@':
-            color = RETROFLAT_COLOR_BROWN;
-            break;
-         case '#':
-            color = RETROFLAT_COLOR_GRAY;
-            break;
-         case '$':
-            color = RETROFLAT_COLOR_DARKGRAY;
-            break;
-         case '%':
-            color = RETROFLAT_COLOR_BLUE;
-            break;
-         case '&':
-            color = RETROFLAT_COLOR_GREEN;
-            break;
-         case '*':
-            color = RETROFLAT_COLOR_CYAN;
-            break;
-         case '=':
-            color = RETROFLAT_COLOR_RED;
-            break;
-         case '-':
-            color = RETROFLAT_COLOR_MAGENTA;
-            break;
-         case ';':
-            color = RETROFLAT_COLOR_YELLOW;
-            break;
-         case ':':
-            color = RETROFLAT_COLOR_WHITE;
-            break;
-         }
-
-         retroflat_px( bmp_out, color, x, y, 0 );
-      }
+   for( y = 0 ; asset->h > y ; y++ ) {
+      row = &(asset->px[(size_t)y * asset->w]);
+      /* Write the whole row at once, treating black as transparent. */
+      /* TODO: Global transparency palette ifdef? */
+      retroflat_idx_row( bmp_out, row, 0, y, asset->w, RETROFLAT_COLOR_BLACK );
    }
 
    retroflat_px_release( bmp_out );
@@ -315,7 +315,7 @@ int maug_zdigits( size_t num, int base );
  * \brief Convert a single char hex digit to the int it represents.
  */
 #define maug_hctoi( c ) \
-   ('9' > (c) ? (c) - '0' : 'a' > (c) ? 10 + (c) - 'A' : 10 + (c) - 'a')
+   ('9' >= (c) ? (c) - '0' : 'a' > (c) ? 10 + (c) - 'A' : 10 + (c) - 'a')
 
 int maug_is_num( const char* str, size_t str_sz, uint8_t base, uint8_t sign );
 
@@ -0,0 +1,183 @@
+
+/* Pack files into a VFS header for MVFS_ENABLED builds, compressing each
+ * with the maug LZ codec if it would make it smaller.
+ *
+ * Usage: mvfspack <mvfs.h> <file> [file ...]
+ */
+
+#define MAUG_C
+#define MLZ_ENCODER
+#include <maug.h>
+
+#define MVFSPACK_COLS 12
+
+static int mvfspack_cmp( const void* a, const void* b ) {
+   return strcmp( *(const char**)a, *(const char**)b );
+}
+
+static MERROR_RETVAL mvfspack_read(
+   const char* filename, uint8_t** p_buf, size_t* p_buf_sz
+) {
+   MERROR_RETVAL retval = MERROR_OK;
+   FILE* in_f = NULL;
+   long in_sz = 0;
+
+   in_f = fopen( filename, "rb" );
+   if( NULL == in_f ) {
+      error_printf( "could not open file: %s", filename );
+      retval = MERROR_FILE;
+      goto cleanup;
+   }
+
+   fseek( in_f, 0, SEEK_END );
+   in_sz = ftell( in_f );
+   fseek( in_f, 0, SEEK_SET );
+   if( 0 > in_sz ) {
+      error_printf( "could not get size of file: %s", filename );
+      retval = MERROR_FILE;
+      goto cleanup;
+   }
+
+   /* Allocate at least one byte so empty files still get a buffer. */
+   *p_buf = malloc( in_sz + 1 );
+   maug_cleanup_if_null_alloc( uint8_t*, *p_buf );
+   *p_buf_sz = in_sz;
+
+   if( (size_t)in_sz != fread( *p_buf, 1, in_sz, in_f ) ) {
+      error_printf( "could not read file: %s", filename );
+      retval = MERROR_FILE;
+   }
+
+cleanup:
+
+   if( NULL != in_f ) {
+      fclose( in_f );
+   }
+
+   return retval;
+}
+
+static void mvfspack_write_bytes(
+   FILE* out_f, size_t idx, const uint8_t* buf, size_t buf_sz
+) {
+   size_t i = 0;
+
+   fprintf( out_f, "static unsigned char gc_mvfs_pack_" SIZE_T_FMT "[] = {",
+      idx );
+   for( i = 0 ; buf_sz > i ; i++ ) {
+      if( 0 == i % MVFSPACK_COLS ) {
+         fprintf( out_f, "\n  " );
+      }
+      fprintf( out_f, " 0x%02x,", buf[i] );
+   }
+   if( 0 == buf_sz ) {
+      /* Empty arrays aren't valid C. */
+      fprintf( out_f, "\n   0x00," );
+   }
+   fprintf( out_f, "\n};\n" );
+   fprintf( out_f, "static off_t gc_mvfs_pack_" SIZE_T_FMT "_len = "
+      SIZE_T_FMT ";\n\n", idx, buf_sz );
+}
+
+int main( int argc, char* argv[] ) {
+   MERROR_RETVAL retval = MERROR_OK;
+   FILE* out_f = NULL;
+   char** filenames = NULL;
+   size_t* unpacked_szs = NULL;
+   uint8_t* in_buf = NULL;
+   uint8_t* out_buf = NULL;
+   size_t filenames_sz = 0,
+      in_buf_sz = 0,
+      out_buf_sz = 0,
+      total_in = 0,
+      total_out = 0,
+      i = 0;
+
+   if( 3 > argc ) {
+      fprintf( stderr, "usage: %s <mvfs.h> <file> [file ...]\n", argv[0] );
+      retval = MERROR_USR;
+      goto cleanup;
+   }
+
+   /* Sort the files by path so mfile_open_read() can binary search them. */
+   filenames_sz = argc - 2;
+   filenames = &(argv[2]);
+   qsort( filenames, filenames_sz, sizeof( char* ), mvfspack_cmp );
+
+   unpacked_szs = calloc( filenames_sz, sizeof( size_t ) );
+   maug_cleanup_if_null_alloc( size_t*, unpacked_szs );
+
+   out_f = fopen( argv[1], "w" );
+   if( NULL == out_f ) {
+      error_printf( "could not open output: %s", argv[1] );
+      retval = MERROR_FILE;
+      goto cleanup;
+   }
+
+   fprintf( out_f, "#ifndef MVFS_H\n#define MVFS_H\n\n" );
+
+   for( i = 0 ; filenames_sz > i ; i++ ) {
+      retval = mvfspack_read( filenames[i], &in_buf, &in_buf_sz );
+      maug_cleanup_if_not_ok();
+
+      out_buf_sz = mlz_compress_bound( in_buf_sz );
+      out_buf = malloc( out_buf_sz );
+      maug_cleanup_if_null_alloc( uint8_t*, out_buf );
+
+      retval = mlz_compress( in_buf, in_buf_sz, out_buf, &out_buf_sz );
+      maug_cleanup_if_not_ok();
+
+      if( out_buf_sz < in_buf_sz ) {
+         mvfspack_write_bytes( out_f, i, out_buf, out_buf_sz );
+         unpacked_szs[i] = in_buf_sz;
+         total_out += out_buf_sz;
+      } else {
+         /* Didn't help, so store it as-is. */
+         mvfspack_write_bytes( out_f, i, in_buf, in_buf_sz );
+         total_out += in_buf_sz;
+      }
+      total_in += in_buf_sz;
+
+      free( in_buf );
+      in_buf = NULL;
+      free( out_buf );
+      out_buf = NULL;
+   }
+
+   /* Add a directory of files. */
+   fprintf( out_f, "static struct MFILE_VFS_ENTRY gc_mvfs_dir[] = {\n" );
+   for( i = 0 ; filenames_sz > i ; i++ ) {
+      fprintf( out_f, "   { \"%s\", gc_mvfs_pack_" SIZE_T_FMT ", "
+         "&gc_mvfs_pack_" SIZE_T_FMT "_len, " SIZE_T_FMT " },\n",
+         filenames[i], i, i, unpacked_szs[i] );
+   }
+   fprintf( out_f, "};\n\n" );
+   fprintf( out_f, "static size_t gc_mvfs_dir_sz =\n"
+      "   sizeof( gc_mvfs_dir ) / sizeof( struct MFILE_VFS_ENTRY );\n\n" );
+
+   fprintf( out_f, "#endif\n" );
+
+   printf( "packed " SIZE_T_FMT " files: " SIZE_T_FMT " bytes to "
+      SIZE_T_FMT " bytes\n", filenames_sz, total_in, total_out );
+
+cleanup:
+
+   if( NULL != out_f ) {
+      fclose( out_f );
+   }
+
+   if( NULL != in_buf ) {
+      free( in_buf );
+   }
+
+   if( NULL != out_buf ) {
+      free( out_buf );
+   }
+
+   if( NULL != unpacked_szs ) {
+      free( unpacked_szs );
+   }
+
+   return retval;
+}
+
@@ -0,0 +1,174 @@
+
+/* Reference VDP plugin with integer nearest scaling, scanlines and palette
+ * remapping, for programs built with RETROFLAT_VDP.
+ *
+ * Build as RETROFLAT_VDP_LIB_NAME for the program's platform, e.g.:
+ *
+ *    PLUGIN_DEFINES := -DRETROFLAT_API_SDL1
+ *    $(eval $(call TGT_GCC_UNIX_PLUG,rvdpsdl1,maug/vdp/retrovdp.c))
+ *
+ * Options are passed to the program after -vdp, separated by spaces:
+ *
+ *    scale=<n>           Give the program a screen 1/n the size of the
+ *                        window and draw it n times as big.
+ *    scanlines=<n>       Darken every nth row.
+ *    remap=<from>:<to>   Replace a color, given as a hex pixel value in the
+ *                        screen's format. May be given more than once.
+ *
+ * Only 32-bit screens are supported.
+ */
+
+#define RETROVDP_C
+#include <maug.h>
+#include <retrovdp.h>
+
+#ifndef RETROVDP_REMAP_SZ_MAX
+#  define RETROVDP_REMAP_SZ_MAX 16
+#endif /* !RETROVDP_REMAP_SZ_MAX */
+
+#if defined( RETROFLAT_API_SDL1 )
+#  define retrovdp_bmp_w( bmp ) ((size_t)((bmp)->surface->w))
+#  define retrovdp_bmp_h( bmp ) ((size_t)((bmp)->surface->h))
+#  define retrovdp_bmp_bpp( bmp ) ((bmp)->surface->format->BitsPerPixel)
+#  define retrovdp_bmp_top( bmp ) ((uint8_t*)((bmp)->surface->pixels))
+#  define retrovdp_bmp_pitch( bmp ) ((ssize_t)((bmp)->surface->pitch))
+#elif defined( RETROFLAT_API_WIN32 )
+/* DIBs are stored bottom-up, so start at the last row and go backwards. */
+#  define retrovdp_bmp_w( bmp ) ((size_t)((bmp)->bmi.header.biWidth))
+#  define retrovdp_bmp_h( bmp ) ((size_t)((bmp)->bmi.header.biHeight))
+#  define retrovdp_bmp_bpp( bmp ) ((bmp)->bmi.header.biBitCount)
+#  define retrovdp_bmp_top( bmp ) \
+      (&((bmp)->bits[(retrovdp_bmp_h( bmp ) - 1) * retrovdp_bmp_w( bmp ) * 4]))
+#  define retrovdp_bmp_pitch( bmp ) ((ssize_t)retrovdp_bmp_w( bmp ) * -4)
+#else
+#  error "retrovdp does not support this platform!"
+#endif /* RETROFLAT_API_SDL1 || RETROFLAT_API_WIN32 */
+
+struct RETROVDP_DATA {
+   uint8_t scale;
+   uint8_t scanlines;
+   uint32_t remap_from[RETROVDP_REMAP_SZ_MAX];
+   uint32_t remap_to[RETROVDP_REMAP_SZ_MAX];
+   size_t remap_sz;
+};
+
+static void retrovdp_parse_args( struct RETROVDP_DATA* data, char* args ) {
+   char* tok = NULL;
+   char* val = NULL;
+
+   for( tok = strtok( args, " " ) ; NULL != tok ; tok = strtok( NULL, " " ) ) {
+      val = strchr( tok, '=' );
+      if( NULL == val ) {
+         error_printf( "invalid VDP option: %s", tok );
+         continue;
+      }
+      *val = '\0';
+      val++;
+
+      if( 0 == strcmp( "scale", tok ) ) {
+         data->scale = atoi( val );
+      } else if( 0 == strcmp( "scanlines", tok ) ) {
+         data->scanlines = atoi( val );
+      } else if(
+         0 == strcmp( "remap", tok ) && NULL != strchr( val, ':' ) &&
+         RETROVDP_REMAP_SZ_MAX > data->remap_sz
+      ) {
+         data->remap_from[data->remap_sz] = strtoul( val, NULL, 16 );
+         data->remap_to[data->remap_sz] =
+            strtoul( strchr( val, ':' ) + 1, NULL, 16 );
+         data->remap_sz++;
+      } else {
+         error_printf( "invalid VDP option: %s", tok );
+      }
+   }
+
+   if( 0 == data->scale ) {
+      data->scale = 1;
+   }
+}
+
+MPLUG_EXPORT MERROR_RETVAL retroflat_vdp_init( struct RETROFLAT_STATE* state ) {
+   MERROR_RETVAL retval = MERROR_OK;
+   struct RETROVDP_DATA* data = NULL;
+   char args[RETROFLAT_VDP_ARGS_SZ_MAX + 1];
+
+   if( 32 != retrovdp_bmp_bpp( &(state->buffer) ) ) {
+      error_printf( "retrovdp only supports 32-bit screens!" );
+      retval = MERROR_GUI;
+      goto cleanup;
+   }
+
+   data = calloc( 1, sizeof( struct RETROVDP_DATA ) );
+   maug_cleanup_if_null_alloc( struct RETROVDP_DATA*, data );
+
+   /* strtok() modifies the string, so work on a copy. */
+   maug_mzero( args, RETROFLAT_VDP_ARGS_SZ_MAX + 1 );
+   maug_strncpy( args, state->vdp_args, RETROFLAT_VDP_ARGS_SZ_MAX );
+   retrovdp_parse_args( data, args );
+
+   state->vdp_data = data;
+   state->vdp_flags |= RETROFLAT_VDP_FLAG_PXLOCK;
+   /* RetroFlat creates RETROFLAT_STATE::vdp_buffer at 1/scale after this. */
+   state->vdp_scale = data->scale;
+
+cleanup:
+
+   return retval;
+}
+
+MPLUG_EXPORT MERROR_RETVAL retroflat_vdp_flip( struct RETROFLAT_STATE* state ) {
+   MERROR_RETVAL retval = MERROR_OK;
+   struct RETROVDP_DATA* data = (struct RETROVDP_DATA*)state->vdp_data;
+   struct RETROFLAT_BITMAP* src = state->vdp_buffer;
+   struct RETROFLAT_BITMAP* dest = &(state->buffer);
+   size_t src_w = 0,
+      src_h = 0;
+
+   if( NULL == data ) {
+      goto cleanup;
+   }
+
+   /* Only copy as much of the frame as will fit on the screen. */
+   src_w = retrovdp_bmp_w( dest ) / data->scale;
+   if( retrovdp_bmp_w( src ) < src_w ) {
+      src_w = retrovdp_bmp_w( src );
+   }
+   src_h = retrovdp_bmp_h( dest ) / data->scale;
+   if( retrovdp_bmp_h( src ) < src_h ) {
+      src_h = retrovdp_bmp_h( src );
+   }
+
+   retrovdp_scale_nearest(
+      retrovdp_bmp_top( src ), retrovdp_bmp_pitch( src ), src_w, src_h,
+      retrovdp_bmp_top( dest ), retrovdp_bmp_pitch( dest ), data->scale );
+
+   /* Remap before darkening scanlines, so the original colors match. */
+   if( 0 < data->remap_sz ) {
+      retrovdp_remap(
+         retrovdp_bmp_top( dest ), retrovdp_bmp_pitch( dest ),
+         src_w * data->scale, src_h * data->scale,
+         data->remap_from, data->remap_to, data->remap_sz );
+   }
+
+   if( 0 < data->scanlines ) {
+      retrovdp_scanlines(
+         retrovdp_bmp_top( dest ), retrovdp_bmp_pitch( dest ),
+         src_w * data->scale, src_h * data->scale, data->scanlines );
+   }
+
+cleanup:
+
+   return retval;
+}
+
+MPLUG_EXPORT MERROR_RETVAL retroflat_vdp_shutdown(
+   struct RETROFLAT_STATE* state
+) {
+   if( NULL != state->vdp_data ) {
+      free( state->vdp_data );
+      state->vdp_data = NULL;
+   }
+
+   return MERROR_OK;
+}
+